@@ -79,6 +79,12 @@ else()
   message(STATUS "Build git_id          : No  (default)")
 endif()
 
+if(BUILD_LOADTEST)
+  message(STATUS "Build load test tools : Yes")
+else()
+  message(STATUS "Build load test tools : No  (default)")
+endif()
+
 if(BUILD_DOCS)
   message(STATUS "Build documentation   : Yes")
 else()
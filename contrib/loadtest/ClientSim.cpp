@@ -0,0 +1,970 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Headless client simulator for mangosd.
+ *
+ * Every simulated client logs in at realmd (SRP6), connects to the world server over a real socket, authenticates
+ * with the session key and switches to the encrypted packet headers like the game client. It then creates a character
+ * when the account has none, enters the world and keeps sending a scripted stream of movement, chat and spell cast
+ * opcodes until the test ends.
+ *
+ * Measured and reported every interval:
+ *  - world round trip: CMSG_QUERY_TIME is handled by the world thread, so its latency includes waiting for the next world update
+ *  - ping: CMSG_PING is answered by the network thread, so it is the plain network latency
+ *  - world update time as reported by ".server info", queried by the first client
+ *  - packets and bytes in both directions
+ *
+ * Accounts <username>1..<username>N must exist in the realmd database, e.g. created with ".account create".
+ */
+
+#include "Common.h"
+#include "LoadTest.h"
+#include "RealmClient.h"
+#include "Auth/AuthCrypt.h"
+#include "Auth/Sha1.h"
+#include "ByteBuffer.h"
+
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace LoadTest;
+
+    // opcodes and result codes of the supported client build, see Opcodes.h and SharedDefines.h
+    uint16 const CMSG_CHAR_CREATE           = 0x036;
+    uint16 const CMSG_CHAR_ENUM             = 0x037;
+    uint16 const SMSG_CHAR_CREATE           = 0x03A;
+    uint16 const SMSG_CHAR_ENUM             = 0x03B;
+    uint16 const CMSG_PLAYER_LOGIN          = 0x03D;
+    uint16 const CMSG_MESSAGECHAT           = 0x095;
+    uint16 const SMSG_MESSAGECHAT           = 0x096;
+    uint16 const MSG_MOVE_START_FORWARD     = 0x0B5;
+    uint16 const MSG_MOVE_STOP              = 0x0B7;
+    uint16 const MSG_MOVE_HEARTBEAT         = 0x0EE;
+    uint16 const CMSG_CAST_SPELL            = 0x12E;
+    uint16 const CMSG_QUERY_TIME            = 0x1CE;
+    uint16 const SMSG_QUERY_TIME_RESPONSE   = 0x1CF;
+    uint16 const CMSG_PING                  = 0x1DC;
+    uint16 const SMSG_PONG                  = 0x1DD;
+    uint16 const SMSG_AUTH_CHALLENGE        = 0x1EC;
+    uint16 const CMSG_AUTH_SESSION          = 0x1ED;
+    uint16 const SMSG_AUTH_RESPONSE         = 0x1EE;
+    uint16 const SMSG_LOGIN_VERIFY_WORLD    = 0x236;
+    uint16 const SMSG_TIME_SYNC_REQ         = 0x390;
+    uint16 const CMSG_TIME_SYNC_RESP        = 0x391;
+
+    uint8 const AUTH_OK                     = 0x0C;
+    uint8 const AUTH_WAIT_QUEUE             = 0x1B;
+    uint8 const CHAR_CREATE_SUCCESS         = 0x2F;
+
+    uint8 const CHAT_MSG_SYSTEM             = 0x00;
+    uint8 const CHAT_MSG_SAY                = 0x01;
+    uint32 const LANG_UNIVERSAL             = 0;
+
+    uint32 const MOVEFLAG_FORWARD           = 0x00000001;
+
+    // the server counts pings sent faster than this as over-speed
+    uint32 const PING_INTERVAL_MS           = 30000;
+    uint32 const MOVE_STEP_MS               = 500;
+    float const RUN_SPEED                   = 7.0f;
+    float const MAX_HOME_DISTANCE           = 20.0f;
+
+    struct SimConfig
+    {
+        std::string host;
+        std::string realmPort;
+        std::string worldPort;
+        std::string username;
+        std::string password;
+        uint32 clients;
+        uint32 loginThreads;
+        uint32 loginRate;
+        uint32 threads;
+        uint32 duration;
+        uint32 actionInterval;
+        uint32 reportInterval;
+        uint32 spell;
+        uint8 race;
+        uint8 class_;
+        uint16 build;
+    };
+
+    enum ClientStage
+    {
+        STAGE_REALM,
+        STAGE_CONNECT,
+        STAGE_AUTH,
+        STAGE_CHARACTER,
+        STAGE_ENTER_WORLD,
+        STAGE_IN_WORLD,
+        MAX_STAGES
+    };
+
+    char const* StageNames[MAX_STAGES] = { "realm", "connect", "auth", "character", "enter world", "in world" };
+
+    /// Counters of all clients, sampled and reset by the reporter
+    struct SimStats
+    {
+        SimStats() : packetsSent(0), packetsReceived(0), bytesSent(0), bytesReceived(0), online(0), updateTime(0), averageUpdateTime(0)
+        {
+            for (std::atomic<uint32>& failure : failures)
+                failure = 0;
+        }
+
+        void AddSample(std::vector<double>& samples, double value)
+        {
+            std::lock_guard<std::mutex> lock(samplesLock);
+            samples.push_back(value);
+        }
+
+        std::atomic<uint64> packetsSent;
+        std::atomic<uint64> packetsReceived;
+        std::atomic<uint64> bytesSent;
+        std::atomic<uint64> bytesReceived;
+        std::atomic<uint32> online;
+        std::atomic<uint32> failures[MAX_STAGES];
+        std::atomic<uint32> updateTime;
+        std::atomic<uint32> averageUpdateTime;
+
+        std::mutex samplesLock;
+        std::vector<double> loginMs;
+        std::vector<double> worldRttMs;
+        std::vector<double> pingMs;
+    };
+
+    /// Session key and account of a client that passed the realmd logon
+    struct RealmSession
+    {
+        uint32 index;
+        std::string username;
+        BigNumber sessionKey;
+        SteadyClock::time_point loginStart;
+    };
+
+    /**
+     * World connection of one simulated client. All handlers of a client run on its strand,
+     * the io_service itself is shared by all clients and run by the --threads network threads.
+     */
+    class WorldClient : public std::enable_shared_from_this<WorldClient>
+    {
+        public:
+            WorldClient(boost::asio::io_service& service, SimConfig const& config, SimStats& stats, RealmSession const& session) :
+                m_config(config), m_stats(stats), m_session(session), m_service(service), m_strand(service), m_socket(service),
+                m_actionTimer(service), m_moveTimer(service), m_pingTimer(service), m_stage(STAGE_CONNECT), m_closed(false),
+                m_headerSize(0), m_serverSeed(0), m_characterGuid(0), m_mapId(0), m_x(0.0f), m_y(0.0f), m_z(0.0f), m_o(0.0f),
+                m_homeX(0.0f), m_homeY(0.0f), m_moveStep(0), m_castCount(0), m_chatCount(0), m_pingSequence(0), m_lastPingMs(0),
+                m_queryTimePending(false), m_random(session.index + 1)
+            {
+            }
+
+            void Start()
+            {
+                boost::asio::ip::tcp::resolver resolver(m_service);
+                boost::system::error_code ec;
+                boost::asio::ip::tcp::resolver::iterator endpoint = resolver.resolve(boost::asio::ip::tcp::resolver::query(m_config.host, m_config.worldPort), ec);
+                if (ec)
+                {
+                    Fail();
+                    return;
+                }
+
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                boost::asio::async_connect(m_socket, endpoint, m_strand.wrap([self](boost::system::error_code const& error, boost::asio::ip::tcp::resolver::iterator)
+                {
+                    if (error)
+                    {
+                        self->Fail();
+                        return;
+                    }
+
+                    boost::system::error_code ignored;
+                    self->m_socket.set_option(boost::asio::ip::tcp::no_delay(true), ignored);
+                    self->m_stage = STAGE_AUTH;
+                    self->ReadHeader();
+                }));
+            }
+
+            void Stop()
+            {
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                m_strand.post([self]() { self->Close(); });
+            }
+
+        private:
+            void Fail()
+            {
+                if (m_closed)
+                    return;
+
+                ++m_stats.failures[m_stage];
+                Close();
+            }
+
+            void Close()
+            {
+                if (m_closed)
+                    return;
+
+                m_closed = true;
+                if (m_stage == STAGE_IN_WORLD)
+                    --m_stats.online;
+
+                boost::system::error_code ec;
+                m_actionTimer.cancel(ec);
+                m_moveTimer.cancel(ec);
+                m_pingTimer.cancel(ec);
+                m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+                m_socket.close(ec);
+            }
+
+            ///- Incoming packets: 2 or 3 byte big endian size (the high bit of the first byte marks the long form), 2 byte opcode
+            void ReadHeader()
+            {
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                boost::asio::async_read(m_socket, boost::asio::buffer(m_header, 1), m_strand.wrap([self](boost::system::error_code const& error, size_t)
+                {
+                    if (error)
+                    {
+                        self->Fail();
+                        return;
+                    }
+
+                    // headers from the server are encrypted with its send stream, see SendPacket
+                    self->m_crypt.EncryptSend(self->m_header, 1);
+                    self->m_headerSize = (self->m_header[0] & 0x80) ? 5 : 4;
+                    self->ReadHeaderRest();
+                }));
+            }
+
+            void ReadHeaderRest()
+            {
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                boost::asio::async_read(m_socket, boost::asio::buffer(m_header + 1, m_headerSize - 1), m_strand.wrap([self](boost::system::error_code const& error, size_t)
+                {
+                    if (error)
+                    {
+                        self->Fail();
+                        return;
+                    }
+
+                    self->m_crypt.EncryptSend(self->m_header + 1, self->m_headerSize - 1);
+
+                    uint32 size;
+                    uint8 const* opcode;
+                    if (self->m_headerSize == 5)
+                    {
+                        size = ((self->m_header[0] & 0x7F) << 16) | (self->m_header[1] << 8) | self->m_header[2];
+                        opcode = self->m_header + 3;
+                    }
+                    else
+                    {
+                        size = (self->m_header[0] << 8) | self->m_header[1];
+                        opcode = self->m_header + 2;
+                    }
+
+                    if (size < 2)
+                    {
+                        self->Fail();
+                        return;
+                    }
+
+                    self->m_opcode = opcode[0] | (opcode[1] << 8);
+                    self->m_body.resize(size - 2);
+                    self->ReadBody();
+                }));
+            }
+
+            void ReadBody()
+            {
+                if (m_body.empty())
+                {
+                    OnPacket();
+                    return;
+                }
+
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                boost::asio::async_read(m_socket, boost::asio::buffer(m_body), m_strand.wrap([self](boost::system::error_code const& error, size_t)
+                {
+                    if (error)
+                    {
+                        self->Fail();
+                        return;
+                    }
+
+                    self->OnPacket();
+                }));
+            }
+
+            void OnPacket()
+            {
+                ++m_stats.packetsReceived;
+                m_stats.bytesReceived += m_headerSize + m_body.size();
+
+                ByteBuffer data(m_body.size());
+                if (!m_body.empty())
+                    data.append(&m_body[0], m_body.size());
+
+                bool handled;
+                try
+                {
+                    handled = HandlePacket(m_opcode, data);
+                }
+                catch (ByteBufferException const&)
+                {
+                    handled = false;
+                }
+
+                if (!handled)
+                {
+                    Fail();
+                    return;
+                }
+
+                if (!m_closed)
+                    ReadHeader();
+            }
+
+            ///- Outgoing packets: 2 byte big endian size, 4 byte opcode
+            void SendPacket(uint16 opcode, ByteBuffer const& data)
+            {
+                if (m_closed)
+                    return;
+
+                uint32 size = data.size() + 4;
+                std::vector<uint8> packet(6 + data.size());
+                packet[0] = uint8(size >> 8);
+                packet[1] = uint8(size);
+                packet[2] = uint8(opcode);
+                packet[3] = uint8(opcode >> 8);
+                packet[4] = 0;
+                packet[5] = 0;
+
+                // RC4 is symmetric: the client encrypts with the stream the server decrypts with and the other way round
+                m_crypt.DecryptRecv(&packet[0], 6);
+                if (!data.empty())
+                    memcpy(&packet[6], data.contents(), data.size());
+
+                ++m_stats.packetsSent;
+                m_stats.bytesSent += packet.size();
+
+                m_writeQueue.push_back(std::move(packet));
+                if (m_writeQueue.size() == 1)
+                    WriteNext();
+            }
+
+            void WriteNext()
+            {
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                boost::asio::async_write(m_socket, boost::asio::buffer(m_writeQueue.front()), m_strand.wrap([self](boost::system::error_code const& error, size_t)
+                {
+                    if (error)
+                    {
+                        self->Fail();
+                        return;
+                    }
+
+                    self->m_writeQueue.pop_front();
+                    if (!self->m_writeQueue.empty() && !self->m_closed)
+                        self->WriteNext();
+                }));
+            }
+
+            bool HandlePacket(uint16 opcode, ByteBuffer& data)
+            {
+                switch (opcode)
+                {
+                    case SMSG_AUTH_CHALLENGE:       return HandleAuthChallenge(data);
+                    case SMSG_AUTH_RESPONSE:        return HandleAuthResponse(data);
+                    case SMSG_CHAR_ENUM:            return HandleCharEnum(data);
+                    case SMSG_CHAR_CREATE:          return HandleCharCreate(data);
+                    case SMSG_LOGIN_VERIFY_WORLD:   return HandleLoginVerifyWorld(data);
+                    case SMSG_QUERY_TIME_RESPONSE:  return HandleQueryTimeResponse();
+                    case SMSG_PONG:                 return HandlePong(data);
+                    case SMSG_TIME_SYNC_REQ:        return HandleTimeSyncRequest(data);
+                    case SMSG_MESSAGECHAT:          return HandleMessageChat(data);
+                    default:                        return true;
+                }
+            }
+
+            bool HandleAuthChallenge(ByteBuffer& data)
+            {
+                if (m_stage != STAGE_AUTH)
+                    return false;
+
+                data.read_skip<uint32>();
+                data >> m_serverSeed;
+
+                uint32 clientSeed = m_random();
+                uint32 t = 0;
+
+                Sha1Hash sha;
+                sha.UpdateData(m_session.username);
+                sha.UpdateData((uint8*)&t, 4);
+                sha.UpdateData((uint8*)&clientSeed, 4);
+                sha.UpdateData((uint8*)&m_serverSeed, 4);
+                sha.UpdateBigNumbers(&m_session.sessionKey, nullptr);
+                sha.Finalize();
+
+                ByteBuffer pkt;
+                pkt << uint32(m_config.build);
+                pkt << uint32(0);                                   // login server id
+                pkt << m_session.username;
+                pkt << uint32(0);                                   // login server type
+                pkt << uint32(clientSeed);
+                pkt << uint32(0);                                   // region id
+                pkt << uint32(0);                                   // battlegroup id
+                pkt << uint32(1);                                   // realm id
+                pkt << uint64(0);                                   // dos response
+                pkt.append(sha.GetDigest(), SHA_DIGEST_LENGTH);
+                pkt << uint32(0);                                   // no addon info
+                SendPacket(CMSG_AUTH_SESSION, pkt);
+
+                // everything after the auth session has encrypted headers
+                m_crypt.Init(&m_session.sessionKey);
+                return true;
+            }
+
+            bool HandleAuthResponse(ByteBuffer& data)
+            {
+                uint8 result;
+                data >> result;
+
+                if (result == AUTH_WAIT_QUEUE)
+                    return true;
+
+                if (result != AUTH_OK || m_stage != STAGE_AUTH)
+                    return false;
+
+                m_stage = STAGE_CHARACTER;
+                SendPacket(CMSG_CHAR_ENUM, ByteBuffer());
+                return true;
+            }
+
+            bool HandleCharEnum(ByteBuffer& data)
+            {
+                if (m_stage != STAGE_CHARACTER)
+                    return false;
+
+                uint8 count;
+                data >> count;
+
+                if (count)
+                {
+                    data >> m_characterGuid;
+                    m_stage = STAGE_ENTER_WORLD;
+
+                    ByteBuffer pkt;
+                    pkt << uint64(m_characterGuid);
+                    SendPacket(CMSG_PLAYER_LOGIN, pkt);
+                    return true;
+                }
+
+                // names can only hold letters, so the client index is written in base 26
+                std::string name = "Sim";
+                for (uint32 index = m_session.index, i = 0; i < 6; ++i, index /= 26)
+                    name += char('a' + index % 26);
+
+                ByteBuffer pkt;
+                pkt << name;
+                pkt << uint8(m_config.race);
+                pkt << uint8(m_config.class_);
+                pkt << uint8(m_random() % 2);                       // gender
+                pkt << uint8(0) << uint8(0) << uint8(0) << uint8(0) << uint8(0); // skin, face, hair style, hair color, facial hair
+                pkt << uint8(0);                                    // outfit
+                SendPacket(CMSG_CHAR_CREATE, pkt);
+                return true;
+            }
+
+            bool HandleCharCreate(ByteBuffer& data)
+            {
+                uint8 result;
+                data >> result;
+                if (result != CHAR_CREATE_SUCCESS)
+                    return false;
+
+                SendPacket(CMSG_CHAR_ENUM, ByteBuffer());
+                return true;
+            }
+
+            bool HandleLoginVerifyWorld(ByteBuffer& data)
+            {
+                if (m_stage != STAGE_ENTER_WORLD)
+                    return false;
+
+                data >> m_mapId >> m_x >> m_y >> m_z >> m_o;
+                m_homeX = m_x;
+                m_homeY = m_y;
+
+                m_stage = STAGE_IN_WORLD;
+                ++m_stats.online;
+                m_stats.AddSample(m_stats.loginMs, ElapsedMs(m_session.loginStart));
+
+                // spread the actions of clients entering the world at the same time
+                ScheduleAction(m_random() % m_config.actionInterval + 1);
+                SchedulePing(m_random() % PING_INTERVAL_MS + 1);
+                return true;
+            }
+
+            bool HandleQueryTimeResponse()
+            {
+                if (m_queryTimePending)
+                {
+                    m_queryTimePending = false;
+                    m_stats.AddSample(m_stats.worldRttMs, ElapsedMs(m_queryTimeSent));
+                }
+                return true;
+            }
+
+            bool HandlePong(ByteBuffer& data)
+            {
+                uint32 sequence;
+                data >> sequence;
+                if (sequence == m_pingSequence)
+                {
+                    double rtt = ElapsedMs(m_pingSent);
+                    m_lastPingMs = uint32(rtt);
+                    m_stats.AddSample(m_stats.pingMs, rtt);
+                }
+                return true;
+            }
+
+            bool HandleTimeSyncRequest(ByteBuffer& data)
+            {
+                uint32 counter;
+                data >> counter;
+
+                ByteBuffer pkt;
+                pkt << uint32(counter);
+                pkt << uint32(GetClientTime());
+                SendPacket(CMSG_TIME_SYNC_RESP, pkt);
+                return true;
+            }
+
+            bool HandleMessageChat(ByteBuffer& data)
+            {
+                uint8 type;
+                data >> type;
+                if (type != CHAT_MSG_SYSTEM)
+                    return true;
+
+                data.read_skip<uint32>();                           // language
+                data.read_skip<uint64>();                           // sender
+                data.read_skip<uint32>();
+                data.read_skip<uint64>();                           // target
+                data.read_skip<uint32>();                           // text length
+                std::string text;
+                data >> text;
+
+                uint32 updateTime, averageUpdateTime;
+                if (sscanf(text.c_str(), "World update time: %u ms (average %u ms)", &updateTime, &averageUpdateTime) == 2)
+                {
+                    m_stats.updateTime = updateTime;
+                    m_stats.averageUpdateTime = averageUpdateTime;
+                }
+                return true;
+            }
+
+            ///- Scripted behaviour: every action interval one of move, chat or cast, each followed by a world round trip probe
+            void ScheduleAction(uint32 delay)
+            {
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                m_actionTimer.expires_from_now(std::chrono::milliseconds(delay));
+                m_actionTimer.async_wait(m_strand.wrap([self](boost::system::error_code const& error)
+                {
+                    if (error || self->m_closed)
+                        return;
+
+                    self->DoAction();
+                    self->ScheduleAction(self->m_config.actionInterval);
+                }));
+            }
+
+            void DoAction()
+            {
+                switch (m_random() % 4)
+                {
+                    case 0:
+                    case 1:
+                        StartMove();
+                        break;
+                    case 2:
+                        Say("load test message " + std::to_string(++m_chatCount));
+                        break;
+                    case 3:
+                        CastSpell();
+                        break;
+                }
+
+                // the first client also samples the server update time, once per report
+                if (m_session.index == 0 && (m_lastServerInfo == SteadyClock::time_point() || ElapsedMs(m_lastServerInfo) >= m_config.reportInterval * 1000.0))
+                {
+                    m_lastServerInfo = SteadyClock::now();
+                    Say(".server info");
+                }
+
+                if (!m_queryTimePending)
+                {
+                    m_queryTimePending = true;
+                    m_queryTimeSent = SteadyClock::now();
+                    SendPacket(CMSG_QUERY_TIME, ByteBuffer());
+                }
+            }
+
+            void Say(std::string const& text)
+            {
+                ByteBuffer pkt;
+                pkt << uint32(CHAT_MSG_SAY);
+                pkt << uint32(LANG_UNIVERSAL);
+                pkt << text;
+                SendPacket(CMSG_MESSAGECHAT, pkt);
+            }
+
+            void CastSpell()
+            {
+                ByteBuffer pkt;
+                pkt << uint8(++m_castCount);
+                pkt << uint32(m_config.spell);
+                pkt << uint8(0);                                    // cast flags
+                pkt << uint32(0);                                   // target mask: self
+                SendPacket(CMSG_CAST_SPELL, pkt);
+            }
+
+            /// Runs for two steps in a random direction, turning back home when too far away to stay in the login grid
+            void StartMove()
+            {
+                if (m_moveStep)
+                    return;
+
+                float dx = m_homeX - m_x;
+                float dy = m_homeY - m_y;
+                if (dx * dx + dy * dy > MAX_HOME_DISTANCE * MAX_HOME_DISTANCE)
+                    m_o = std::atan2(dy, dx);
+                else
+                    m_o = float(m_random() % 628) / 100.0f;
+
+                SendMovement(MSG_MOVE_START_FORWARD, MOVEFLAG_FORWARD);
+                m_moveStep = 1;
+                ScheduleMoveStep();
+            }
+
+            void ScheduleMoveStep()
+            {
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                m_moveTimer.expires_from_now(std::chrono::milliseconds(MOVE_STEP_MS));
+                m_moveTimer.async_wait(m_strand.wrap([self](boost::system::error_code const& error)
+                {
+                    if (error || self->m_closed)
+                        return;
+
+                    float distance = RUN_SPEED * MOVE_STEP_MS / 1000.0f;
+                    self->m_x += distance * std::cos(self->m_o);
+                    self->m_y += distance * std::sin(self->m_o);
+
+                    if (self->m_moveStep++ < 2)
+                    {
+                        self->SendMovement(MSG_MOVE_HEARTBEAT, MOVEFLAG_FORWARD);
+                        self->ScheduleMoveStep();
+                    }
+                    else
+                    {
+                        self->SendMovement(MSG_MOVE_STOP, 0);
+                        self->m_moveStep = 0;
+                    }
+                }));
+            }
+
+            void SendMovement(uint16 opcode, uint32 moveFlags)
+            {
+                ByteBuffer pkt;
+                pkt.appendPackGUID(m_characterGuid);
+                pkt << uint32(moveFlags);
+                pkt << uint16(0);                                   // move flags 2
+                pkt << uint32(GetClientTime());
+                pkt << m_x << m_y << m_z << m_o;
+                pkt << uint32(0);                                   // fall time
+                SendPacket(opcode, pkt);
+            }
+
+            void SchedulePing(uint32 delay)
+            {
+                std::shared_ptr<WorldClient> self = shared_from_this();
+                m_pingTimer.expires_from_now(std::chrono::milliseconds(delay));
+                m_pingTimer.async_wait(m_strand.wrap([self](boost::system::error_code const& error)
+                {
+                    if (error || self->m_closed)
+                        return;
+
+                    self->m_pingSent = SteadyClock::now();
+
+                    ByteBuffer pkt;
+                    pkt << uint32(++self->m_pingSequence);
+                    pkt << uint32(self->m_lastPingMs);
+                    self->SendPacket(CMSG_PING, pkt);
+
+                    self->SchedulePing(PING_INTERVAL_MS);
+                }));
+            }
+
+            uint32 GetClientTime() const
+            {
+                return uint32(ElapsedMs(m_session.loginStart));
+            }
+
+            SimConfig const& m_config;
+            SimStats& m_stats;
+            RealmSession m_session;
+
+            boost::asio::io_service& m_service;
+            boost::asio::io_service::strand m_strand;
+            boost::asio::ip::tcp::socket m_socket;
+            boost::asio::steady_timer m_actionTimer;
+            boost::asio::steady_timer m_moveTimer;
+            boost::asio::steady_timer m_pingTimer;
+            AuthCrypt m_crypt;
+
+            ClientStage m_stage;
+            bool m_closed;
+
+            uint8 m_header[5];
+            uint32 m_headerSize;
+            uint16 m_opcode;
+            std::vector<uint8> m_body;
+            std::deque<std::vector<uint8>> m_writeQueue;
+
+            uint32 m_serverSeed;
+            uint64 m_characterGuid;
+            uint32 m_mapId;
+            float m_x, m_y, m_z, m_o;
+            float m_homeX, m_homeY;
+            uint32 m_moveStep;
+            uint8 m_castCount;
+            uint32 m_chatCount;
+
+            uint32 m_pingSequence;
+            uint32 m_lastPingMs;
+            SteadyClock::time_point m_pingSent;
+            bool m_queryTimePending;
+            SteadyClock::time_point m_queryTimeSent;
+            SteadyClock::time_point m_lastServerInfo;
+
+            std::minstd_rand m_random;
+    };
+
+    void PrintReport(SimStats& stats, double intervalMs, uint64& lastPacketsSent, uint64& lastPacketsReceived, uint64& lastBytesSent, uint64& lastBytesReceived)
+    {
+        uint64 packetsSent = stats.packetsSent, packetsReceived = stats.packetsReceived;
+        uint64 bytesSent = stats.bytesSent, bytesReceived = stats.bytesReceived;
+        double seconds = intervalMs / 1000.0;
+
+        std::vector<double> worldRtt, ping;
+        {
+            std::lock_guard<std::mutex> lock(stats.samplesLock);
+            worldRtt.swap(stats.worldRttMs);
+            ping.swap(stats.pingMs);
+        }
+
+        printf("online %5u | out %8.0f pkt/s %8.1f KB/s | in %8.0f pkt/s %8.1f KB/s | world rtt p50 %7.1f p99 %7.1f ms | ping p50 %6.1f ms | update %4u ms (avg %u)\n",
+               uint32(stats.online),
+               (packetsSent - lastPacketsSent) / seconds, (bytesSent - lastBytesSent) / 1024.0 / seconds,
+               (packetsReceived - lastPacketsReceived) / seconds, (bytesReceived - lastBytesReceived) / 1024.0 / seconds,
+               Percentile(worldRtt, 0.50), Percentile(worldRtt, 0.99), Percentile(ping, 0.50),
+               uint32(stats.updateTime), uint32(stats.averageUpdateTime));
+        fflush(stdout);
+
+        lastPacketsSent = packetsSent;
+        lastPacketsReceived = packetsReceived;
+        lastBytesSent = bytesSent;
+        lastBytesReceived = bytesReceived;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    SimConfig config;
+    uint32 race, class_;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage and exit")
+    ("host", boost::program_options::value<std::string>(&config.host)->default_value("127.0.0.1"), "realmd and mangosd address")
+    ("realm-port", boost::program_options::value<std::string>(&config.realmPort)->default_value("3724"), "realmd port")
+    ("world-port", boost::program_options::value<std::string>(&config.worldPort)->default_value("8085"), "mangosd port")
+    ("username,u", boost::program_options::value<std::string>(&config.username)->default_value("LOADTEST"), "account name prefix, client N uses account <username>N")
+    ("password,p", boost::program_options::value<std::string>(&config.password)->default_value("LOADTEST"), "password of all accounts")
+    ("clients,n", boost::program_options::value<uint32>(&config.clients)->default_value(100), "simulated clients, one per account")
+    ("login-threads", boost::program_options::value<uint32>(&config.loginThreads)->default_value(8), "threads running the realmd logons")
+    ("login-rate", boost::program_options::value<uint32>(&config.loginRate)->default_value(50), "logons started per second, 0 for no limit")
+    ("threads,t", boost::program_options::value<uint32>(&config.threads)->default_value(std::max(1u, std::thread::hardware_concurrency())), "network threads of the world connections")
+    ("duration,d", boost::program_options::value<uint32>(&config.duration)->default_value(300), "test length in seconds, logons included")
+    ("action-interval", boost::program_options::value<uint32>(&config.actionInterval)->default_value(2000), "ms between two actions (move, chat or cast) of a client")
+    ("report-interval", boost::program_options::value<uint32>(&config.reportInterval)->default_value(10), "seconds between two reports")
+    ("race", boost::program_options::value<uint32>(&race)->default_value(1), "race of created characters")
+    ("class", boost::program_options::value<uint32>(&class_)->default_value(8), "class of created characters")
+    ("spell", boost::program_options::value<uint32>(&config.spell)->default_value(168), "self cast spell of the cast action, known by new characters of the class")
+    ("build,b", boost::program_options::value<uint16>(&config.build)->default_value(12340), "client build to announce");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (!config.clients)
+        return 0;
+
+    config.race = uint8(race);
+    config.class_ = uint8(class_);
+    config.loginThreads = std::max(1u, std::min(config.loginThreads, config.clients));
+    config.threads = std::max(1u, config.threads);
+    config.actionInterval = std::max(1u, config.actionInterval);
+    config.reportInterval = std::max(1u, config.reportInterval);
+
+    printf("Simulating %u clients against %s (realmd %s, mangosd %s) for %u s\n", config.clients, config.host.c_str(), config.realmPort.c_str(), config.worldPort.c_str(), config.duration);
+
+    SimStats stats;
+    boost::asio::io_service service;
+    std::unique_ptr<boost::asio::io_service::work> work(new boost::asio::io_service::work(service));
+
+    std::vector<std::thread> networkThreads;
+    for (uint32 i = 0; i < config.threads; ++i)
+        networkThreads.emplace_back([&service]() { service.run(); });
+
+    SteadyClock::time_point start = SteadyClock::now();
+    std::atomic<bool> stopping(false);
+    std::atomic<uint32> nextClient(0);
+    std::mutex clientsLock;
+    std::vector<std::shared_ptr<WorldClient>> clients;
+
+    // realmd logons are blocking, the world connections they lead to are handed over to the network threads
+    std::vector<std::thread> loginThreads;
+    for (uint32 i = 0; i < config.loginThreads; ++i)
+    {
+        loginThreads.emplace_back([&]()
+        {
+            boost::asio::io_service realmService;
+            for (uint32 index = nextClient++; index < config.clients && !stopping; index = nextClient++)
+            {
+                if (config.loginRate)
+                    std::this_thread::sleep_until(start + std::chrono::microseconds(uint64(index) * 1000000 / config.loginRate));
+
+                RealmSession session;
+                session.index = index;
+                session.loginStart = SteadyClock::now();
+
+                RealmClient realm(realmService, config.username + std::to_string(index + 1), config.password, config.build);
+                bool success = false;
+                try
+                {
+                    success = realm.Connect(config.host, config.realmPort) && realm.LogonChallenge() && realm.LogonProof() && realm.RealmList();
+                }
+                catch (boost::system::system_error const&)
+                {
+                }
+                realm.Close();
+
+                if (!success)
+                {
+                    ++stats.failures[STAGE_REALM];
+                    continue;
+                }
+
+                session.username = realm.GetUsername();
+                session.sessionKey = realm.GetSessionKey();
+
+                std::shared_ptr<WorldClient> client = std::make_shared<WorldClient>(service, config, stats, session);
+                {
+                    std::lock_guard<std::mutex> lock(clientsLock);
+                    if (stopping)
+                        break;
+                    clients.push_back(client);
+                }
+                client->Start();
+            }
+        });
+    }
+
+    uint64 lastPacketsSent = 0, lastPacketsReceived = 0, lastBytesSent = 0, lastBytesReceived = 0;
+    SteadyClock::time_point end = start + std::chrono::seconds(config.duration);
+    SteadyClock::time_point lastReport = start;
+    while (SteadyClock::now() < end)
+    {
+        std::this_thread::sleep_until(std::min(end, lastReport + std::chrono::seconds(config.reportInterval)));
+
+        double intervalMs = ElapsedMs(lastReport);
+        lastReport = SteadyClock::now();
+        PrintReport(stats, intervalMs, lastPacketsSent, lastPacketsReceived, lastBytesSent, lastBytesReceived);
+    }
+
+    uint32 onlineAtEnd = stats.online;
+    {
+        std::lock_guard<std::mutex> lock(clientsLock);
+        stopping = true;
+        for (std::shared_ptr<WorldClient> const& client : clients)
+            client->Stop();
+    }
+
+    for (std::thread& thread : loginThreads)
+        thread.join();
+
+    work.reset();
+    for (std::thread& thread : networkThreads)
+        thread.join();
+
+    double elapsedMs = ElapsedMs(start);
+
+    printf("\n%u/%u clients in world at the end of the test, %.2f s\n", onlineAtEnd, config.clients, elapsedMs / 1000.0);
+    for (int stage = 0; stage < MAX_STAGES; ++stage)
+        if (stats.failures[stage])
+            printf("  %u failed at %s\n", uint32(stats.failures[stage]), StageNames[stage]);
+
+    printf("\nTraffic: out %llu packets %.1f MB, in %llu packets %.1f MB\n",
+           (unsigned long long)stats.packetsSent, stats.bytesSent / 1024.0 / 1024.0,
+           (unsigned long long)stats.packetsReceived, stats.bytesReceived / 1024.0 / 1024.0);
+
+    printf("\nLatency:\n");
+    PrintLatency("login", stats.loginMs);
+
+    return onlineAtEnd == config.clients ? 0 : 2;
+}
@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LOADTEST_H
+#define MANGOS_LOADTEST_H
+
+#include "Common.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// Helpers shared by the load test tools
+namespace LoadTest
+{
+    typedef std::chrono::steady_clock SteadyClock;
+
+    inline double ElapsedMs(SteadyClock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+    }
+
+    inline std::string ToUpper(std::string str)
+    {
+        std::transform(str.begin(), str.end(), str.begin(), ::toupper);
+        return str;
+    }
+
+    inline double Percentile(std::vector<double>& values, double fraction)
+    {
+        if (values.empty())
+            return 0.0;
+
+        size_t index = std::min(values.size() - 1, size_t(fraction * (values.size() - 1) + 0.5));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    inline void PrintLatency(char const* name, std::vector<double>& values)
+    {
+        if (values.empty())
+            return;
+
+        double sum = 0.0;
+        for (double value : values)
+            sum += value;
+
+        double p50 = Percentile(values, 0.50);
+        double p95 = Percentile(values, 0.95);
+        double p99 = Percentile(values, 0.99);
+        double max = *std::max_element(values.begin(), values.end());
+
+        printf("  %-10s avg %8.2f ms  p50 %8.2f ms  p95 %8.2f ms  p99 %8.2f ms  max %8.2f ms\n",
+               name, sum / values.size(), p50, p95, p99, max);
+    }
+}
+
+#endif
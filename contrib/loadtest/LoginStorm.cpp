@@ -0,0 +1,253 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Login storm benchmark for realmd.
+ *
+ * Every simulated client connects, runs the SRP6 logon challenge/proof exchange and requests the realm list,
+ * like a real client reconnecting after a world server restart. All clients start at the same moment.
+ * The accounts must exist in the realmd database, e.g. created with ".account create" on the world server.
+ */
+
+#include "Common.h"
+#include "LoadTest.h"
+#include "RealmClient.h"
+
+#include <boost/asio.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace LoadTest;
+
+    struct StormConfig
+    {
+        std::string host;
+        std::string port;
+        std::string username;
+        std::string password;
+        uint32 accounts;
+        uint32 clients;
+        uint32 concurrency;
+        uint16 build;
+    };
+
+    enum LoginStage
+    {
+        STAGE_CONNECT,
+        STAGE_CHALLENGE,
+        STAGE_PROOF,
+        STAGE_REALMLIST,
+        MAX_STAGES
+    };
+
+    char const* StageNames[MAX_STAGES] = { "connect", "challenge", "proof", "realmlist" };
+
+    struct LoginResult
+    {
+        bool success;
+        LoginStage failedStage;
+        double stageMs[MAX_STAGES];
+        double totalMs;
+    };
+
+    /// One login as done by the game client
+    class SimulatedClient
+    {
+        public:
+            SimulatedClient(boost::asio::io_service& service, StormConfig const& config, std::string const& username) :
+                m_config(config), m_realm(service, username, config.password, config.build) {}
+
+            LoginResult Run()
+            {
+                LoginResult result;
+                result.success = false;
+                result.failedStage = STAGE_CONNECT;
+                std::fill(std::begin(result.stageMs), std::end(result.stageMs), 0.0);
+
+                SteadyClock::time_point start = SteadyClock::now();
+                try
+                {
+                    for (int stage = STAGE_CONNECT; stage < MAX_STAGES; ++stage)
+                    {
+                        result.failedStage = LoginStage(stage);
+                        SteadyClock::time_point stageStart = SteadyClock::now();
+                        if (!RunStage(LoginStage(stage)))
+                            break;
+
+                        result.stageMs[stage] = ElapsedMs(stageStart);
+                        if (stage == STAGE_REALMLIST)
+                            result.success = true;
+                    }
+                }
+                catch (boost::system::system_error const&)
+                {
+                }
+
+                m_realm.Close();
+
+                result.totalMs = ElapsedMs(start);
+                return result;
+            }
+
+        private:
+            bool RunStage(LoginStage stage)
+            {
+                switch (stage)
+                {
+                    case STAGE_CONNECT:     return m_realm.Connect(m_config.host, m_config.port);
+                    case STAGE_CHALLENGE:   return m_realm.LogonChallenge();
+                    case STAGE_PROOF:       return m_realm.LogonProof();
+                    case STAGE_REALMLIST:   return m_realm.RealmList();
+                    default:                return false;
+                }
+            }
+
+            StormConfig const& m_config;
+            RealmClient m_realm;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    StormConfig config;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage and exit")
+    ("host", boost::program_options::value<std::string>(&config.host)->default_value("127.0.0.1"), "realmd address")
+    ("port", boost::program_options::value<std::string>(&config.port)->default_value("3724"), "realmd port")
+    ("username,u", boost::program_options::value<std::string>(&config.username)->default_value("LOADTEST"), "account name, or name prefix when --accounts is above 1")
+    ("password,p", boost::program_options::value<std::string>(&config.password)->default_value("LOADTEST"), "account password")
+    ("accounts,a", boost::program_options::value<uint32>(&config.accounts)->default_value(1), "use accounts <username>1..<username>N round robin")
+    ("clients,n", boost::program_options::value<uint32>(&config.clients)->default_value(200), "total logins to run")
+    ("concurrency,c", boost::program_options::value<uint32>(&config.concurrency)->default_value(0), "simultaneous clients, 0 for all at once")
+    ("build,b", boost::program_options::value<uint16>(&config.build)->default_value(12340), "client build to announce");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (!config.clients)
+        return 0;
+
+    if (!config.concurrency || config.concurrency > config.clients)
+        config.concurrency = config.clients;
+    if (!config.accounts)
+        config.accounts = 1;
+
+    printf("Running %u logins against %s:%s with %u simultaneous clients\n", config.clients, config.host.c_str(), config.port.c_str(), config.concurrency);
+
+    std::vector<LoginResult> results(config.clients);
+    std::atomic<uint32> nextClient(0);
+
+    // release all client threads together so the connections arrive as a storm
+    std::mutex startMutex;
+    std::condition_variable startCondition;
+    bool started = false;
+
+    std::vector<std::thread> threads;
+    threads.reserve(config.concurrency);
+    for (uint32 i = 0; i < config.concurrency; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            boost::asio::io_service service;
+            {
+                std::unique_lock<std::mutex> lock(startMutex);
+                startCondition.wait(lock, [&started]() { return started; });
+            }
+
+            for (uint32 index = nextClient++; index < config.clients; index = nextClient++)
+            {
+                std::string username = config.username;
+                if (config.accounts > 1)
+                    username += std::to_string(index % config.accounts + 1);
+
+                SimulatedClient client(service, config, username);
+                results[index] = client.Run();
+            }
+        });
+    }
+
+    SteadyClock::time_point start = SteadyClock::now();
+    {
+        std::lock_guard<std::mutex> lock(startMutex);
+        started = true;
+    }
+    startCondition.notify_all();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double elapsedMs = ElapsedMs(start);
+
+    uint32 succeeded = 0;
+    uint32 failures[MAX_STAGES] = {};
+    std::vector<double> totals;
+    std::vector<double> stages[MAX_STAGES];
+    for (LoginResult const& result : results)
+    {
+        if (!result.success)
+        {
+            ++failures[result.failedStage];
+            continue;
+        }
+
+        ++succeeded;
+        totals.push_back(result.totalMs);
+        for (int stage = 0; stage < MAX_STAGES; ++stage)
+            stages[stage].push_back(result.stageMs[stage]);
+    }
+
+    printf("\n%u/%u logins succeeded in %.2f s (%.1f logins/s)\n", succeeded, config.clients, elapsedMs / 1000.0, succeeded * 1000.0 / elapsedMs);
+    for (int stage = 0; stage < MAX_STAGES; ++stage)
+        if (failures[stage])
+            printf("  %u failed at %s\n", failures[stage], StageNames[stage]);
+
+    printf("\nLatency of successful logins:\n");
+    PrintLatency("total", totals);
+    for (int stage = 0; stage < MAX_STAGES; ++stage)
+        PrintLatency(StageNames[stage], stages[stage]);
+
+    return succeeded == config.clients ? 0 : 2;
+}
@@ -0,0 +1,229 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "RealmClient.h"
+#include "LoadTest.h"
+#include "Auth/Sha1.h"
+#include "ByteBuffer.h"
+
+#include <cstring>
+
+namespace
+{
+    uint8 const CMD_AUTH_LOGON_CHALLENGE = 0x00;
+    uint8 const CMD_AUTH_LOGON_PROOF     = 0x01;
+    uint8 const CMD_REALM_LIST           = 0x10;
+}
+
+RealmClient::RealmClient(boost::asio::io_service& service, std::string const& username, std::string const& password, uint16 build) :
+    m_service(service), m_socket(service), m_username(LoadTest::ToUpper(username)), m_password(LoadTest::ToUpper(password)), m_build(build)
+{
+}
+
+bool RealmClient::Connect(std::string const& host, std::string const& port)
+{
+    boost::asio::ip::tcp::resolver resolver(m_service);
+    boost::asio::connect(m_socket, resolver.resolve(host, port));
+    m_socket.set_option(boost::asio::ip::tcp::no_delay(true));
+    return true;
+}
+
+bool RealmClient::LogonChallenge()
+{
+    ByteBuffer pkt;
+    pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
+    pkt << uint8(0x08);                                 // protocol version
+    pkt << uint16(30 + m_username.size());              // size of the rest
+    pkt.append("WoW", 4);                               // game name
+    pkt << uint8(3) << uint8(3) << uint8(5);
+    pkt << uint16(m_build);
+    pkt.append("68x", 4);                               // platform, reversed
+    pkt.append("niW", 4);                               // os, reversed
+    pkt.append("SUne", 4);                              // country, reversed
+    pkt << uint32(0);                                   // timezone bias
+    pkt << uint32(0x0100007F);                          // ip
+    pkt << uint8(m_username.size());
+    pkt.append(m_username.c_str(), m_username.size());
+    Send(pkt);
+
+    uint8 header[3];
+    Receive(header, sizeof(header));
+    if (header[0] != CMD_AUTH_LOGON_CHALLENGE || header[2] != 0)
+        return false;
+
+    uint8 reply[32 + 1 + 1 + 1 + 32 + 32 + 16 + 1];
+    Receive(reply, sizeof(reply));
+
+    uint8 const* pos = reply;
+    m_B.SetBinary(pos, 32);                 pos += 32;
+    uint8 gLen = *pos++;
+    if (gLen != 1)
+        return false;
+    m_g.SetBinary(pos, 1);                  pos += 1;
+    uint8 nLen = *pos++;
+    if (nLen != 32)
+        return false;
+    m_N.SetBinary(pos, 32);                 pos += 32;
+    m_s.SetBinary(pos, 32);                 pos += 32;
+    pos += 16;                                          // version challenge
+    uint8 securityFlags = *pos;
+
+    // only plain password accounts can be simulated
+    return securityFlags == 0;
+}
+
+bool RealmClient::LogonProof()
+{
+    Sha1Hash sha;
+
+    ///- x = H(s, H(I:P))
+    std::string credentials = m_username + ":" + m_password;
+    sha.Initialize();
+    sha.UpdateData(credentials);
+    sha.Finalize();
+    uint8 credentialsHash[SHA_DIGEST_LENGTH];
+    memcpy(credentialsHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_s, nullptr);
+    sha.UpdateData(credentialsHash, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    ///- A = g^a
+    BigNumber a;
+    a.SetRand(19 * 8);
+    BigNumber A = m_g.ModExp(a, m_N);
+
+    ///- u = H(A, B)
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &m_B, nullptr);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    ///- S = (B - k * g^x) ^ (a + u * x), k = 3
+    BigNumber kgx = (m_g.ModExp(x, m_N) * BigNumber(3)) % m_N;
+    BigNumber base = ((m_B + m_N) - kgx) % m_N;
+    BigNumber S = base.ModExp(a + (u * x), m_N);
+
+    ///- K = interleaved hash of S, as done by SRP6::HashSessionKey
+    uint8 t[32];
+    memcpy(t, S.AsByteArray(32), 32);
+    uint8 half[16];
+    uint8 vK[40];
+    for (int part = 0; part < 2; ++part)
+    {
+        for (int i = 0; i < 16; ++i)
+            half[i] = t[i * 2 + part];
+        sha.Initialize();
+        sha.UpdateData(half, 16);
+        sha.Finalize();
+        for (int i = 0; i < 20; ++i)
+            vK[i * 2 + part] = sha.GetDigest()[i];
+    }
+    m_K.SetBinary(vK, 40);
+
+    ///- M1 = H(H(N) xor H(g), H(I), s, A, B, K)
+    uint8 ngHash[SHA_DIGEST_LENGTH];
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_N, nullptr);
+    sha.Finalize();
+    memcpy(ngHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_g, nullptr);
+    sha.Finalize();
+    for (int i = 0; i < SHA_DIGEST_LENGTH; ++i)
+        ngHash[i] ^= sha.GetDigest()[i];
+
+    uint8 userHash[SHA_DIGEST_LENGTH];
+    sha.Initialize();
+    sha.UpdateData(m_username);
+    sha.Finalize();
+    memcpy(userHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(ngHash, SHA_DIGEST_LENGTH);
+    sha.UpdateData(userHash, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&m_s, &A, &m_B, &m_K, nullptr);
+    sha.Finalize();
+    uint8 M1[SHA_DIGEST_LENGTH];
+    memcpy(M1, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    ByteBuffer pkt;
+    pkt << uint8(CMD_AUTH_LOGON_PROOF);
+    pkt.append(A.AsByteArray(32), 32);
+    pkt.append(M1, SHA_DIGEST_LENGTH);
+    uint8 crc[SHA_DIGEST_LENGTH] = {};
+    pkt.append(crc, SHA_DIGEST_LENGTH);
+    pkt << uint8(0);                                    // number of keys
+    pkt << uint8(0);                                    // security flags
+    Send(pkt);
+
+    uint8 header[2];
+    Receive(header, sizeof(header));
+    if (header[0] != CMD_AUTH_LOGON_PROOF || header[1] != 0)
+        return false;
+
+    // M2, account flags, survey id, unk flags
+    uint8 reply[20 + 4 + 4 + 2];
+    Receive(reply, sizeof(reply));
+
+    ///- M2 = H(A, M1, K)
+    BigNumber M;
+    M.SetBinary(M1, SHA_DIGEST_LENGTH);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&A, &M, &m_K, nullptr);
+    sha.Finalize();
+    return memcmp(reply, sha.GetDigest(), SHA_DIGEST_LENGTH) == 0;
+}
+
+bool RealmClient::RealmList()
+{
+    ByteBuffer pkt;
+    pkt << uint8(CMD_REALM_LIST);
+    pkt << uint32(0);
+    Send(pkt);
+
+    uint8 header[3];
+    Receive(header, sizeof(header));
+    if (header[0] != CMD_REALM_LIST)
+        return false;
+
+    std::vector<uint8> body(header[1] | (header[2] << 8));
+    if (!body.empty())
+        Receive(&body[0], body.size());
+    return true;
+}
+
+void RealmClient::Close()
+{
+    boost::system::error_code ec;
+    m_socket.close(ec);
+}
+
+void RealmClient::Send(ByteBuffer const& pkt)
+{
+    boost::asio::write(m_socket, boost::asio::buffer(pkt.contents(), pkt.size()));
+}
+
+void RealmClient::Receive(uint8* data, size_t size)
+{
+    boost::asio::read(m_socket, boost::asio::buffer(data, size));
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_REALMCLIENT_H
+#define MANGOS_REALMCLIENT_H
+
+#include "Common.h"
+#include "Auth/BigNumber.h"
+
+#include <boost/asio.hpp>
+
+class ByteBuffer;
+
+/**
+ * Client side of the realmd SRP6 exchange as done by the game client.
+ * All calls are blocking, network errors are thrown as boost::system::system_error.
+ * After a successful LogonProof the session key is the one the world server expects in CMSG_AUTH_SESSION.
+ */
+class RealmClient
+{
+    public:
+        RealmClient(boost::asio::io_service& service, std::string const& username, std::string const& password, uint16 build);
+
+        bool Connect(std::string const& host, std::string const& port);
+        bool LogonChallenge();
+        bool LogonProof();
+        bool RealmList();
+        void Close();
+
+        std::string const& GetUsername() const { return m_username; }
+        BigNumber& GetSessionKey() { return m_K; }
+
+    private:
+        void Send(ByteBuffer const& pkt);
+        void Receive(uint8* data, size_t size);
+
+        boost::asio::io_service& m_service;
+        boost::asio::ip::tcp::socket m_socket;
+        std::string m_username;
+        std::string m_password;
+        uint16 m_build;
+
+        BigNumber m_B, m_g, m_N, m_s, m_K;
+};
+
+#endif
@@ -0,0 +1,294 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/*
+ * Replays a DB script schedule against the map's TimerWheel and the std::multimap it replaced.
+ *
+ * The trace is a mangosd log written with LogFilter_DbScriptDev = 0 and LogLevel 3,
+ * every "DB-SCRIPTS: schedule on map <id> at <ms> delay <ms>" line is one scheduled step. Without a trace a
+ * synthetic schedule with waypoint/gossip like delays is generated. Both queues get the same inserts and are
+ * drained at the same map update ticks, the order of the due steps is compared.
+ */
+
+#include "Common.h"
+#include "LoadTest.h"
+#include "Utilities/TimerWheel.h"
+
+#include <boost/program_options.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace LoadTest;
+
+    struct ScheduledStep
+    {
+        uint64 time;
+        uint32 delay;
+    };
+
+    // same size as a ScriptAction
+    struct StepPayload
+    {
+        char const* table;
+        void* map;
+        uint64 sourceGuid;
+        uint64 targetGuid;
+        uint64 ownerGuid;
+        void const* script;
+        uint32 sequence;
+    };
+
+    struct RunResult
+    {
+        double insertMs;
+        double popMs;
+        size_t peakSize;
+        std::vector<uint32> order;
+    };
+
+    bool LoadTrace(std::string const& fileName, int64 mapFilter, std::vector<ScheduledStep>& steps)
+    {
+        std::ifstream file(fileName);
+        if (!file)
+            return false;
+
+        char const* marker = "DB-SCRIPTS: schedule on map ";
+        std::map<uint32, std::vector<ScheduledStep>> byMap;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            size_t pos = line.find(marker);
+            if (pos == std::string::npos)
+                continue;
+
+            uint32 mapId;
+            unsigned long long time;
+            uint32 delay;
+            if (sscanf(line.c_str() + pos + strlen(marker), "%u at %llu delay %u", &mapId, &time, &delay) != 3)
+                continue;
+
+            byMap[mapId].push_back({ uint64(time), delay });
+        }
+
+        if (byMap.empty())
+            return true;
+
+        // the busiest map unless one was asked for
+        uint32 mapId = byMap.begin()->first;
+        if (mapFilter >= 0)
+            mapId = uint32(mapFilter);
+        else
+            for (auto const& itr : byMap)
+                if (itr.second.size() > byMap[mapId].size())
+                    mapId = itr.first;
+
+        steps = byMap[mapId];
+        printf("Trace %s: %u steps on map %u\n", fileName.c_str(), uint32(steps.size()), mapId);
+        return true;
+    }
+
+    void GenerateSchedule(uint32 count, uint32 perSecond, uint32 seed, std::vector<ScheduledStep>& steps)
+    {
+        std::mt19937 rng(seed);
+        // waypoint scripts wait some seconds, gossip and event scripts follow quickly, a few long timers
+        std::discrete_distribution<int> kind({ 60, 35, 5 });
+        std::uniform_int_distribution<uint32> shortDelay(100, 3000);
+        std::uniform_int_distribution<uint32> mediumDelay(3000, 30000);
+        std::uniform_int_distribution<uint32> longDelay(30000, 600000);
+
+        uint64 time = 0;
+        double interval = 1000.0 / std::max(perSecond, 1u);
+        double clock = 0.0;
+        steps.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            clock += interval;
+            time = uint64(clock);
+
+            uint32 delay;
+            switch (kind(rng))
+            {
+                case 0: delay = mediumDelay(rng); break;
+                case 1: delay = shortDelay(rng); break;
+                default: delay = longDelay(rng); break;
+            }
+            steps.push_back({ time, delay });
+        }
+
+        printf("Synthetic schedule: %u steps, %u per second\n", count, perSecond);
+    }
+
+    template<typename Queue>
+    RunResult Replay(std::vector<ScheduledStep> const& steps, uint32 tick, Queue& queue)
+    {
+        RunResult result = { 0.0, 0.0, 0, {} };
+        result.order.reserve(steps.size());
+
+        uint64 now = steps.front().time;
+        size_t next = 0;
+        while (next < steps.size() || !queue.Empty())
+        {
+            now += tick;
+
+            SteadyClock::time_point start = SteadyClock::now();
+            for (; next < steps.size() && steps[next].time <= now; ++next)
+            {
+                StepPayload payload = { "dbscripts_on_creature_movement", nullptr, 0, 0, 0, nullptr, uint32(next) };
+                queue.Insert(steps[next].time + steps[next].delay, payload);
+            }
+            result.insertMs += ElapsedMs(start);
+            result.peakSize = std::max(result.peakSize, queue.Size());
+
+            start = SteadyClock::now();
+            queue.PopDue(now, result.order);
+            result.popMs += ElapsedMs(start);
+        }
+
+        return result;
+    }
+
+    struct MultimapQueue
+    {
+        std::multimap<uint64, StepPayload> schedule;
+
+        void Insert(uint64 due, StepPayload const& payload) { schedule.emplace(due, payload); }
+        bool Empty() const { return schedule.empty(); }
+        size_t Size() const { return schedule.size(); }
+
+        void PopDue(uint64 now, std::vector<uint32>& order)
+        {
+            auto iter = schedule.begin();
+            while (iter != schedule.end() && iter->first <= now)
+            {
+                order.push_back(iter->second.sequence);
+                schedule.erase(iter);
+                iter = schedule.begin();
+            }
+        }
+    };
+
+    struct TimerWheelQueue
+    {
+        TimerWheel<StepPayload> schedule;
+
+        void Insert(uint64 due, StepPayload const& payload) { schedule.Insert(due, payload); }
+        bool Empty() const { return schedule.empty(); }
+        size_t Size() const { return schedule.size(); }
+
+        void PopDue(uint64 now, std::vector<uint32>& order)
+        {
+            schedule.CollectDue(now);
+            while (schedule.HasReady())
+            {
+                order.push_back(schedule.FrontReady().sequence);
+                schedule.PopReady();
+            }
+        }
+    };
+
+    void PrintResult(char const* name, RunResult const& result, size_t steps)
+    {
+        printf("  %-12s insert %8.2f ms (%6.1f ns/step)  pop %8.2f ms (%6.1f ns/step)  peak %u queued\n",
+               name, result.insertMs, result.insertMs * 1e6 / steps, result.popMs, result.popMs * 1e6 / steps, uint32(result.peakSize));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string traceFile;
+    int64 mapFilter;
+    uint32 tick;
+    uint32 count;
+    uint32 perSecond;
+    uint32 seed;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("help,h", "print usage and exit")
+    ("trace,t", boost::program_options::value<std::string>(&traceFile), "mangosd log with DB-SCRIPTS schedule lines, synthetic schedule if not given")
+    ("map,m", boost::program_options::value<int64>(&mapFilter)->default_value(-1), "map of the trace to replay, -1 for the busiest")
+    ("tick", boost::program_options::value<uint32>(&tick)->default_value(100), "map update interval in ms")
+    ("steps,n", boost::program_options::value<uint32>(&count)->default_value(1000000), "synthetic schedule: steps to schedule")
+    ("rate,r", boost::program_options::value<uint32>(&perSecond)->default_value(2000), "synthetic schedule: steps scheduled per second")
+    ("seed", boost::program_options::value<uint32>(&seed)->default_value(1), "synthetic schedule: random seed");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error const& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
+    }
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    std::vector<ScheduledStep> steps;
+    if (!traceFile.empty())
+    {
+        if (!LoadTrace(traceFile, mapFilter, steps))
+        {
+            std::cerr << "ERROR: can't open " << traceFile << std::endl;
+            return 1;
+        }
+    }
+    else
+        GenerateSchedule(count, perSecond, seed, steps);
+
+    if (steps.empty())
+    {
+        std::cerr << "ERROR: no scheduled steps to replay" << std::endl;
+        return 1;
+    }
+
+    MultimapQueue multimap;
+    RunResult multimapResult = Replay(steps, std::max(tick, 1u), multimap);
+
+    TimerWheelQueue wheel;
+    RunResult wheelResult = Replay(steps, std::max(tick, 1u), wheel);
+
+    printf("Replayed %u steps at %u ms ticks\n", uint32(steps.size()), tick);
+    PrintResult("multimap", multimapResult, steps.size());
+    PrintResult("timer wheel", wheelResult, steps.size());
+
+    if (multimapResult.order != wheelResult.order)
+    {
+        printf("ERROR: the timer wheel returned the steps in a different order\n");
+        return 1;
+    }
+
+    printf("Both queues returned the steps in the same order\n");
+    return 0;
+}
@@ -46,7 +46,7 @@ class workerThread(threading.Thread):
             stInfo = None
             cFlags = 0
             binName = "./MoveMapGen"
-        retcode = subprocess.call([binName, "%u" % (self.mapID),"--silent"], startupinfo=stInfo, creationflags=cFlags)
+        retcode = subprocess.call([binName, "%u" % (self.mapID), "--silent", "--threads", "1"], startupinfo=stInfo, creationflags=cFlags)
         print "-- %s" % (name)
 
 if __name__ == "__main__":
@@ -20,34 +20,72 @@
 #include "MapBuilder.h"
 
 #include "MapTree.h"
+#include "VMapManager2.h"
 #include "ModelInstance.h"
 
 #include "DetourNavMeshBuilder.h"
 #include "DetourCommon.h"
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
+#include <thread>
 
 using namespace VMAP;
 
 namespace MMAP
 {
+    // FNV-1a, only used to detect changed tile inputs
+    static const uint64 HASH_OFFSET_BASIS = 14695981039346656037ULL;
+    static const uint64 HASH_PRIME = 1099511628211ULL;
+
+    static void hashBytes(uint64& hash, void const* data, size_t size)
+    {
+        unsigned char const* bytes = static_cast<unsigned char const*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= HASH_PRIME;
+        }
+    }
+
+    static void hashFile(uint64& hash, char const* fileName)
+    {
+        hashBytes(hash, fileName, strlen(fileName));
+
+        FILE* file = fopen(fileName, "rb");
+        if (!file)
+        {
+            // a missing file is an input too, creating it must trigger a rebuild
+            hashBytes(hash, "-", 1);
+            return;
+        }
+
+        unsigned char buf[64 * 1024];
+        size_t count;
+        while ((count = fread(buf, 1, sizeof(buf), file)) > 0)
+            hashBytes(hash, buf, count);
+
+        fclose(file);
+    }
+
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
                            bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath) :
+                           bool debugOutput, bool bigBaseUnit, const char* offMeshFilePath,
+                           uint32 threads, bool incremental) :
         m_terrainBuilder(NULL),
         m_debugOutput(debugOutput),
+        m_offMeshFilePath(offMeshFilePath),
         m_skipContinents(skipContinents),
         m_skipJunkMaps(skipJunkMaps),
         m_skipBattlegrounds(skipBattlegrounds),
         m_maxWalkableAngle(maxWalkableAngle),
         m_bigBaseUnit(bigBaseUnit),
-        m_rcContext(NULL),
-        m_offMeshFilePath(offMeshFilePath)
+        m_threads(threads ? threads : 1),
+        m_incremental(incremental)
     {
         m_terrainBuilder = new TerrainBuilder(skipLiquid);
 
-        m_rcContext = new rcContext(false);
-
         discoverTiles();
     }
 
@@ -61,7 +99,6 @@ namespace MMAP
         }
 
         delete m_terrainBuilder;
-        delete m_rcContext;
     }
 
     /**************************************************************************/
@@ -206,7 +243,14 @@ namespace MMAP
             return;
         }
 
-        buildTile(mapID, tileX, tileY, navMesh, 1, 1);
+        loadTileHashes(mapID);
+
+        uint64 inputHash = getTileInputHash(mapID, tileX, tileY, navMesh);
+        rcContext context(false);
+        bool built = buildTile(mapID, tileX, tileY, navMesh, &context, 1, 1);
+        storeTileHash(tileX, tileY, inputHash, built);
+
+        saveTileHashes(mapID);
         dtFreeNavMesh(navMesh);
     }
 
@@ -242,31 +286,77 @@ namespace MMAP
             return;
         }
 
+        loadTileHashes(mapID);
+
+        std::vector<uint32> tileIDs(tiles->begin(), tiles->end());
+        uint32 tileCount = uint32(tileIDs.size());
+        uint32 threadCount = std::min(m_threads, tileCount);
+
         // now start building mmtiles for each tile
-        printf("[Map %03i] We have %u tiles.                          \n", mapID, uint32(tiles->size()));
+        printf("[Map %03i] We have %u tiles, building with %u thread(s).   \n", mapID, tileCount, threadCount);
 
-        uint32 currentTile = 0;
-        for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
+        // tiles are independent of each other, workers pick the next unbuilt one until the list is exhausted
+        std::atomic<uint32> nextTile(0);
+        auto worker = [&]()
         {
-            currentTile++;
-            uint32 tileX, tileY;
+            // rcContext is not shared between threads
+            rcContext context(false);
 
-            // unpack tile coords
-            StaticMapTree::unpackTileID((*it), tileX, tileY);
+            uint32 index;
+            while ((index = nextTile++) < tileCount)
+            {
+                uint32 tileX, tileY;
 
-            if (shouldSkipTile(mapID, tileX, tileY))
-                continue;
+                // unpack tile coords
+                StaticMapTree::unpackTileID(tileIDs[index], tileX, tileY);
 
-            buildTile(mapID, tileX, tileY, navMesh, currentTile, uint32(tiles->size()));
-        }
+                uint64 inputHash = 0;
+                if (shouldSkipTile(mapID, tileX, tileY, navMesh, inputHash))
+                    continue;
 
+                // tiles are only added to the navmesh for validation, but link data written with them
+                // depends on the navmesh state: use an empty one per tile so output does not depend
+                // on build order or on neighbours built concurrently
+                dtNavMesh* tileNavMesh = dtAllocNavMesh();
+                if (!tileNavMesh || dtStatusFailed(tileNavMesh->init(navMesh->getParams())))
+                {
+                    printf("[Map %03i] Failed creating navmesh!                   \n", mapID);
+                    dtFreeNavMesh(tileNavMesh);
+                    continue;
+                }
+
+                bool built = buildTile(mapID, tileX, tileY, tileNavMesh, &context, index + 1, tileCount);
+                dtFreeNavMesh(tileNavMesh);
+
+                if (!built)
+                {
+                    // inputs no longer produce a tile, don't leave an outdated one behind
+                    char fileName[255];
+                    sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
+                    remove(fileName);
+                }
+
+                storeTileHash(tileX, tileY, inputHash, built);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32 i = 1; i < threadCount; ++i)
+            threads.push_back(std::thread(worker));
+
+        worker();
+
+        for (uint32 i = 0; i < threads.size(); ++i)
+            threads[i].join();
+
+        saveTileHashes(mapID);
         dtFreeNavMesh(navMesh);
 
         printf("[Map %03i] Complete!                             \n\n", mapID);
     }
 
     /**************************************************************************/
-    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount)
+    bool MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, rcContext* context, uint32 curTile, uint32 tileCount)
     {
         printf("[Map %03i] Building tile [%02u,%02u] (%02u / %02u)    \n", mapID, tileX, tileY, curTile, tileCount);
 
@@ -280,7 +370,7 @@ namespace MMAP
 
         // if there is no data, give up now
         if (!meshData.solidVerts.size() && !meshData.liquidVerts.size())
-            return;
+            return false;
 
         // remove unused vertices
         TerrainBuilder::cleanVertices(meshData.solidVerts, meshData.solidTris);
@@ -292,7 +382,7 @@ namespace MMAP
         allVerts.append(meshData.solidVerts);
 
         if (!allVerts.size())
-            return;
+            return false;
 
         // get bounds of current tile
         float bmin[3], bmax[3];
@@ -301,7 +391,7 @@ namespace MMAP
         m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
 
         // build navmesh tile
-        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        return buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh, context);
     }
 
     /**************************************************************************/
@@ -380,9 +470,9 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
+    bool MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
                                       MeshData& meshData, float bmin[3], float bmax[3],
-                                      dtNavMesh* navMesh)
+                                      dtNavMesh* navMesh, rcContext* context)
     {
         // console output
         char tileString[20];
@@ -468,7 +558,7 @@ namespace MMAP
 
                 // build heightfield
                 tile.solid = rcAllocHeightfield();
-                if (!tile.solid || !rcCreateHeightfield(m_rcContext, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
+                if (!tile.solid || !rcCreateHeightfield(context, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
                 {
                     printf("%s Failed building heightfield!                       \n", tileString);
                     continue;
@@ -477,45 +567,45 @@ namespace MMAP
                 // mark all walkable tiles, both liquids and solids
                 unsigned char* triFlags = new unsigned char[tTriCount];
                 memset(triFlags, NAV_GROUND, tTriCount * sizeof(unsigned char));
-                rcClearUnwalkableTriangles(m_rcContext, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
-                rcRasterizeTriangles(m_rcContext, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
+                rcClearUnwalkableTriangles(context, tileCfg.walkableSlopeAngle, tVerts, tVertCount, tTris, tTriCount, triFlags);
+                rcRasterizeTriangles(context, tVerts, tVertCount, tTris, triFlags, tTriCount, *tile.solid, config.walkableClimb);
                 delete [] triFlags;
 
-                rcFilterLowHangingWalkableObstacles(m_rcContext, config.walkableClimb, *tile.solid);
-                rcFilterLedgeSpans(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
-                rcFilterWalkableLowHeightSpans(m_rcContext, tileCfg.walkableHeight, *tile.solid);
+                rcFilterLowHangingWalkableObstacles(context, config.walkableClimb, *tile.solid);
+                rcFilterLedgeSpans(context, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid);
+                rcFilterWalkableLowHeightSpans(context, tileCfg.walkableHeight, *tile.solid);
 
-                rcRasterizeTriangles(m_rcContext, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
+                rcRasterizeTriangles(context, lVerts, lVertCount, lTris, lTriFlags, lTriCount, *tile.solid, config.walkableClimb);
 
                 // compact heightfield spans
                 tile.chf = rcAllocCompactHeightfield();
-                if (!tile.chf || !rcBuildCompactHeightfield(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
+                if (!tile.chf || !rcBuildCompactHeightfield(context, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
                 {
                     printf("%s Failed compacting heightfield!                     \n", tileString);
                     continue;
                 }
 
                 // build polymesh intermediates
-                if (!rcErodeWalkableArea(m_rcContext, config.walkableRadius, *tile.chf))
+                if (!rcErodeWalkableArea(context, config.walkableRadius, *tile.chf))
                 {
                     printf("%s Failed eroding area!                               \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildDistanceField(m_rcContext, *tile.chf))
+                if (!rcBuildDistanceField(context, *tile.chf))
                 {
                     printf("%s Failed building distance field!                    \n", tileString);
                     continue;
                 }
 
-                if (!rcBuildRegions(m_rcContext, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
+                if (!rcBuildRegions(context, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
                 {
                     printf("%s Failed building regions!                           \n", tileString);
                     continue;
                 }
 
                 tile.cset = rcAllocContourSet();
-                if (!tile.cset || !rcBuildContours(m_rcContext, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
+                if (!tile.cset || !rcBuildContours(context, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
                 {
                     printf("%s Failed building contours!                          \n", tileString);
                     continue;
@@ -523,14 +613,14 @@ namespace MMAP
 
                 // build polymesh
                 tile.pmesh = rcAllocPolyMesh();
-                if (!tile.pmesh || !rcBuildPolyMesh(m_rcContext, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
+                if (!tile.pmesh || !rcBuildPolyMesh(context, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
                 {
                     printf("%s Failed building polymesh!                          \n", tileString);
                     continue;
                 }
 
                 tile.dmesh = rcAllocPolyMeshDetail();
-                if (!tile.dmesh || !rcBuildPolyMeshDetail(m_rcContext, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
+                if (!tile.dmesh || !rcBuildPolyMeshDetail(context, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg    .detailSampleMaxError, *tile.dmesh))
                 {
                     printf("%s Failed building polymesh detail!                   \n", tileString);
                     continue;
@@ -574,9 +664,9 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return false;
         }
-        rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
+        rcMergePolyMeshes(context, pmmerge, nmerge, *iv.polyMesh);
 
         iv.polyMeshDetail = rcAllocPolyMeshDetail();
         if (!iv.polyMeshDetail)
@@ -585,9 +675,9 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return false;
         }
-        rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
+        rcMergePolyMeshDetails(context, dmmerge, nmerge, *iv.polyMeshDetail);
 
         // free things up
         delete [] pmmerge;
@@ -639,6 +729,7 @@ namespace MMAP
         // will hold final navmesh
         unsigned char* navData = NULL;
         int navDataSize = 0;
+        bool written = false;
 
         do
         {
@@ -693,6 +784,7 @@ namespace MMAP
             if (!tileRef || dtStatusFailed(dtResult))
             {
                 printf("%s Failed adding tile to navmesh!                     \n", tileString);
+                dtFree(navData);
                 continue;
             }
 
@@ -720,6 +812,7 @@ namespace MMAP
             // write data
             fwrite(navData, sizeof(unsigned char), navDataSize, file);
             fclose(file);
+            written = true;
 
             // now that tile is written to disk, we can unload it
             navMesh->removeTile(tileRef, NULL, NULL);
@@ -739,6 +832,8 @@ namespace MMAP
             iv.generateObjFile(mapID, tileX, tileY, meshData);
             iv.writeIV(mapID, tileX, tileY);
         }
+
+        return written;
     }
 
     /**************************************************************************/
@@ -854,7 +949,34 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY)
+    bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh const* navMesh, uint64& inputHash)
+    {
+        // the hash is only computed when needed, reading all inputs of every tile is not free
+        if (m_incremental)
+        {
+            inputHash = getTileInputHash(mapID, tileX, tileY, navMesh);
+
+            std::lock_guard<std::mutex> guard(m_tileHashesLock);
+            std::map<uint32, TileHash>::const_iterator itr = m_tileHashes.find(StaticMapTree::packTileID(tileX, tileY));
+            if (itr == m_tileHashes.end() || itr->second.hash != inputHash)
+                return false;
+
+            // same inputs produced no tile last time, they won't now
+            if (!itr->second.built)
+                return true;
+        }
+
+        if (isTileFileValid(mapID, tileX, tileY))
+            return true;
+
+        if (!m_incremental)
+            inputHash = getTileInputHash(mapID, tileX, tileY, navMesh);
+
+        return false;
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::isTileFileValid(uint32 mapID, uint32 tileX, uint32 tileY)
     {
         char fileName[255];
         sprintf(fileName, "mmaps/%03u%02i%02i.mmtile", mapID, tileY, tileX);
@@ -876,4 +998,117 @@ namespace MMAP
 
         return true;
     }
+
+    /**************************************************************************/
+    uint64 MapBuilder::getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh const* navMesh)
+    {
+        uint64 hash = HASH_OFFSET_BASIS;
+
+        // build settings and formats
+        uint32 versions[3] = { MMAP_VERSION, uint32(DT_NAVMESH_VERSION), m_terrainBuilder->usesLiquids() ? 1u : 0u };
+        hashBytes(hash, versions, sizeof(versions));
+        hashBytes(hash, &m_maxWalkableAngle, sizeof(m_maxWalkableAngle));
+        hashBytes(hash, &m_bigBaseUnit, sizeof(m_bigBaseUnit));
+
+        // tile position inside the navmesh depends on the map bounds
+        hashBytes(hash, navMesh->getParams()->orig, sizeof(float) * 3);
+
+        // heightmap of the tile and its borders taken from the neighbours, see TerrainBuilder::loadMap
+        char fileName[255];
+        int const neighbours[5][2] = { { 0, 0 }, { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+        for (int i = 0; i < 5; ++i)
+        {
+            sprintf(fileName, "maps/%03u%02u%02u.map", mapID, tileY + neighbours[i][1], tileX + neighbours[i][0]);
+            hashFile(hash, fileName);
+        }
+
+        // model data, TerrainBuilder::loadVMap gets the tile coordinates swapped
+        // model files (.vmo) are shared between tiles and not part of the hash
+        sprintf(fileName, "vmaps/%s", VMapManager2::getMapFileName(mapID).c_str());
+        hashFile(hash, fileName);
+        sprintf(fileName, "vmaps/%s", StaticMapTree::getTileFileName(mapID, tileY, tileX).c_str());
+        hashFile(hash, fileName);
+
+        // off mesh connections of this tile
+        if (m_offMeshFilePath)
+        {
+            if (FILE* fp = fopen(m_offMeshFilePath, "rb"))
+            {
+                char buf[512];
+                while (fgets(buf, sizeof(buf), fp))
+                {
+                    int mid, tx, ty;
+                    if (sscanf(buf, "%d %d,%d", &mid, &tx, &ty) != 3)
+                        continue;
+
+                    if (mapID != uint32(mid) || tileX != uint32(tx) || tileY != uint32(ty))
+                        continue;
+
+                    hashBytes(hash, buf, strlen(buf));
+                }
+                fclose(fp);
+            }
+        }
+
+        return hash;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::loadTileHashes(uint32 mapID)
+    {
+        std::lock_guard<std::mutex> guard(m_tileHashesLock);
+        m_tileHashes.clear();
+
+        char fileName[25];
+        sprintf(fileName, "mmaps/%03u.mmhash", mapID);
+        FILE* file = fopen(fileName, "rb");
+        if (!file)
+            return;
+
+        uint32 tileX, tileY, built;
+        unsigned long long hash;
+        while (fscanf(file, "%u %u %llx %u", &tileX, &tileY, &hash, &built) == 4)
+        {
+            TileHash& entry = m_tileHashes[StaticMapTree::packTileID(tileX, tileY)];
+            entry.hash = uint64(hash);
+            entry.built = built != 0;
+        }
+
+        fclose(file);
+    }
+
+    /**************************************************************************/
+    void MapBuilder::storeTileHash(uint32 tileX, uint32 tileY, uint64 inputHash, bool built)
+    {
+        std::lock_guard<std::mutex> guard(m_tileHashesLock);
+        TileHash& entry = m_tileHashes[StaticMapTree::packTileID(tileX, tileY)];
+        entry.hash = inputHash;
+        entry.built = built;
+    }
+
+    /**************************************************************************/
+    void MapBuilder::saveTileHashes(uint32 mapID)
+    {
+        std::lock_guard<std::mutex> guard(m_tileHashesLock);
+
+        char fileName[25];
+        sprintf(fileName, "mmaps/%03u.mmhash", mapID);
+        FILE* file = fopen(fileName, "wb");
+        if (!file)
+        {
+            char message[1024];
+            sprintf(message, "[Map %03i] Failed to open %s for writing!             \n", mapID, fileName);
+            perror(message);
+            return;
+        }
+
+        for (std::map<uint32, TileHash>::const_iterator itr = m_tileHashes.begin(); itr != m_tileHashes.end(); ++itr)
+        {
+            uint32 tileX, tileY;
+            StaticMapTree::unpackTileID(itr->first, tileX, tileY);
+            fprintf(file, "%02u %02u %016llx %u\n", tileX, tileY, (unsigned long long)itr->second.hash, itr->second.built ? 1 : 0);
+        }
+
+        fclose(file);
+    }
 }
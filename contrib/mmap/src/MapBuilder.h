@@ -22,6 +22,7 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <mutex>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
@@ -67,7 +68,9 @@ namespace MMAP
                        bool skipBattlegrounds   = false,
                        bool debugOutput         = false,
                        bool bigBaseUnit         = false,
-                       const char* offMeshFilePath = NULL);
+                       const char* offMeshFilePath = NULL,
+                       uint32 threads           = 1,
+                       bool incremental         = false);
 
             ~MapBuilder();
 
@@ -87,16 +90,18 @@ namespace MMAP
 
             void buildNavMesh(uint32 mapID, dtNavMesh*& navMesh);
 
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, uint32 curTile, uint32 tileCount);
+            // returns true when a tile file was written
+            bool buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh, rcContext* context, uint32 curTile, uint32 tileCount);
 
             // move map building
-            void buildMoveMapTile(uint32 mapID,
+            bool buildMoveMapTile(uint32 mapID,
                                   uint32 tileX,
                                   uint32 tileY,
                                   MeshData& meshData,
                                   float bmin[3],
                                   float bmax[3],
-                                  dtNavMesh* navMesh);
+                                  dtNavMesh* navMesh,
+                                  rcContext* context);
 
             void getTileBounds(uint32 tileX, uint32 tileY,
                                float* verts, int vertCount,
@@ -105,7 +110,15 @@ namespace MMAP
 
             bool shouldSkipMap(uint32 mapID);
             bool isTransportMap(uint32 mapID);
-            bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
+            // inputHash is set when the tile has to be built
+            bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh const* navMesh, uint64& inputHash);
+            bool isTileFileValid(uint32 mapID, uint32 tileX, uint32 tileY);
+
+            // incremental builds: hash of everything a tile is generated from
+            uint64 getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh const* navMesh);
+            void loadTileHashes(uint32 mapID);
+            void storeTileHash(uint32 tileX, uint32 tileY, uint64 inputHash, bool built);
+            void saveTileHashes(uint32 mapID);
 
             TerrainBuilder* m_terrainBuilder;
             TileList m_tiles;
@@ -120,8 +133,20 @@ namespace MMAP
             float m_maxWalkableAngle;
             bool m_bigBaseUnit;
 
-            // build performance - not really used for now
-            rcContext* m_rcContext;
+            // worker threads building tiles of one map in parallel
+            uint32 m_threads;
+
+            // only rebuild tiles whose input files or settings changed since the last run
+            bool m_incremental;
+
+            // tileID -> input hash and whether the tile produced a file, of the map being built
+            struct TileHash
+            {
+                uint64 hash;
+                bool built;
+            };
+            std::map<uint32, TileHash> m_tileHashes;
+            std::mutex m_tileHashesLock;
     };
 }
 
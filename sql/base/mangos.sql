@@ -24,7 +24,7 @@ CREATE TABLE `db_version` (
   `version` varchar(120) DEFAULT NULL,
   `creature_ai_version` varchar(120) DEFAULT NULL,
   `cache_id` int(10) DEFAULT '0',
-  `required_14023_01_mangos_dbscripts` bit(1) DEFAULT NULL
+  `required_14026_01_mangos_command` bit(1) DEFAULT NULL
 ) ENGINE=MyISAM DEFAULT CHARSET=utf8 ROW_FORMAT=DYNAMIC COMMENT='Used DB version notes';
 
 --
@@ -730,8 +730,12 @@ INSERT INTO `command` VALUES
 ('server info',0,'Syntax: .server info\r\n\r\nDisplay server version and the number of connected players.'),
 ('server log filter',4,'Syntax: .server log filter [($filtername|all) (on|off)]\r\n\r\nShow or set server log filters. If used \"all\" then all filters will be set to on/off state.'),
 ('server log level',4,'Syntax: .server log level [#level]\r\n\r\nShow or set server log level (0 - errors only, 1 - basic, 2 - detail, 3 - debug).'),
+('server memory',3,'Syntax: .server memory\r\n\r\nShow the slab pools used for creatures, gameobjects, items, spells, auras, maps and other often allocated objects: block size, blocks in use and peak, memory reserved and the allocations since startup.'),
 ('server motd',0,'Syntax: .server motd\r\n\r\nShow server Message of the day.'),
 ('server plimit',3,'Syntax: .server plimit [#num|-1|-2|-3|reset|player|moderator|gamemaster|administrator]\r\n\r\nWithout arg show current player amount and security level limitations for login to server, with arg set player linit ($num > 0) or securiti limitation ($num < 0 or security leme name. With `reset` sets player limit to the one in the config file'),
+('server profile dump',3,'Syntax: .server profile dump [$filename]\r\n\r\nWrite the world ticks recorded by the tick profiler as folded stacks (input of flame graph tools) to $filename or tickprofile_<time>.folded in the logs directory and show the frames with the highest self time.'),
+('server profile start',3,'Syntax: .server profile start [#ticks]\r\n\r\nStart the tick profiler, keeping the last #ticks world ticks or Metric.ProfilerRingTicks from the config file. Previously recorded ticks are dropped.'),
+('server profile stop',3,'Syntax: .server profile stop\r\n\r\nStop the tick profiler. The recorded ticks are kept for .server profile dump.'),
 ('server restart',3,'Syntax: .server restart #delay\r\n\r\nRestart the server after #delay seconds. Use #exist_code or 2 as program exist code.'),
 ('server restart cancel',3,'Syntax: .server restart cancel\r\n\r\nCancel the restart/shutdown timer if any.'),
 ('server set motd',3,'Syntax: .server set motd $MOTD\r\n\r\nSet server Message of the day.'),
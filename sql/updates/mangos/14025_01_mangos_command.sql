@@ -0,0 +1,7 @@
+ALTER TABLE db_version CHANGE COLUMN required_14023_01_mangos_dbscripts required_14025_01_mangos_command bit;
+
+DELETE FROM command WHERE name IN ('server profile dump', 'server profile start', 'server profile stop');
+INSERT INTO command (name, security, help) VALUES
+('server profile dump',3,'Syntax: .server profile dump [$filename]\r\n\r\nWrite the world ticks recorded by the tick profiler as folded stacks (input of flame graph tools) to $filename or tickprofile_<time>.folded in the logs directory and show the frames with the highest self time.'),
+('server profile start',3,'Syntax: .server profile start [#ticks]\r\n\r\nStart the tick profiler, keeping the last #ticks world ticks or Metric.ProfilerRingTicks from the config file. Previously recorded ticks are dropped.'),
+('server profile stop',3,'Syntax: .server profile stop\r\n\r\nStop the tick profiler. The recorded ticks are kept for .server profile dump.');
@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_14025_01_mangos_command required_14026_01_mangos_command bit;
+
+DELETE FROM command WHERE name IN ('server memory');
+INSERT INTO command (name, security, help) VALUES
+('server memory',3,'Syntax: .server memory\r\n\r\nShow the slab pools used for creatures, gameobjects, items, spells, auras, maps and other often allocated objects: block size, blocks in use and peak, memory reserved and the allocations since startup.');
@@ -0,0 +1,340 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#ifndef MANGOS_TIMERWHEEL_H
+#define MANGOS_TIMERWHEEL_H
+
+#include "Platform/Define.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Time ordered queue of values, as a hierarchical timing wheel.
+ * The inner wheel has a slot per granularity milliseconds, the outer wheel a slot per turn of the inner one,
+ * the outer slot of the next turn is spread over the inner wheel when the inner wheel gets there. Entries too far
+ * ahead even for the outer wheel wait in an overflow list, which is looked at once per turn of the outer wheel.
+ * Every slot is a list of entries in insertion order. Entries live in a node pool that is reused, so inserting
+ * and collecting don't allocate once the pool has grown to the peak size of the queue.
+ *
+ * CollectDue moves everything due into the ready list, ordered by due time and insertion order like a multimap.
+ * Entries of the ready list are consumed one by one, so a caller may stop in the middle and continue later.
+ * All times are in milliseconds.
+ */
+template<typename T>
+class TimerWheel
+{
+    public:
+        explicit TimerWheel(uint32 granularity = 16, uint32 innerSlotBits = 8, uint32 outerSlotBits = 6) :
+            m_granularity(std::max(granularity, 1u)), m_innerBits(innerSlotBits), m_outerBits(outerSlotBits),
+            m_slots((size_t(1) << innerSlotBits) + (size_t(1) << outerSlotBits) + 1), m_freeNode(INVALID_NODE),
+            m_size(0), m_innerCount(0), m_nextSequence(0), m_currentTick(0), m_readyPos(0)
+        {
+        }
+
+        void Insert(uint64 dueTime, T const& value)
+        {
+            uint32 index;
+            if (m_freeNode != INVALID_NODE)
+            {
+                index = m_freeNode;
+                m_freeNode = m_nodes[index].next;
+                m_nodes[index].value = value;
+            }
+            else
+            {
+                index = uint32(m_nodes.size());
+                m_nodes.push_back(Node(value));
+            }
+
+            m_nodes[index].dueTime = dueTime;
+            m_nodes[index].sequence = m_nextSequence++;
+            Place(index);
+            ++m_size;
+        }
+
+        // moves all entries due at now to the ready list
+        void CollectDue(uint64 now)
+        {
+            uint64 nowTick = now / m_granularity;
+            if (nowTick < m_currentTick)
+                return;
+
+            size_t readyBefore = m_ready.size();
+            if (m_size == m_ready.size() - m_readyPos)
+                m_currentTick = nowTick;                    // nothing in the wheels, just move on
+            else
+            {
+                // the wheels only cover so much time, after a longer gap all entries are placed again
+                if (nowTick - m_currentTick >= (uint64(1) << (m_innerBits + m_outerBits)))
+                    Rebuild(nowTick);
+
+                uint64 innerMask = (uint64(1) << m_innerBits) - 1;
+                for (uint64 tick = m_currentTick; ; )
+                {
+                    CollectSlot(uint32(tick & innerMask), now);
+                    if (tick == nowTick)
+                        break;
+
+                    // an empty inner wheel is skipped up to the next turn
+                    tick = m_innerCount ? tick + 1 : std::min((tick | innerMask) + 1, nowTick);
+                    m_currentTick = tick;
+                    if (!(tick & innerMask))
+                        Cascade(tick);
+                }
+                m_currentTick = nowTick;
+            }
+
+            if (m_ready.size() != readyBefore)
+                std::sort(m_ready.begin() + m_readyPos, m_ready.end(), [this](uint32 a, uint32 b)
+                {
+                    Node const& left = m_nodes[a];
+                    Node const& right = m_nodes[b];
+                    return left.dueTime != right.dueTime ? left.dueTime < right.dueTime : left.sequence < right.sequence;
+                });
+        }
+
+        bool HasReady() const { return m_readyPos < m_ready.size(); }
+
+        // the reference is invalidated by Insert, copy the value if entries may be added while it is used
+        T& FrontReady() { return m_nodes[m_ready[m_readyPos]].value; }
+
+        void PopReady()
+        {
+            FreeNode(m_ready[m_readyPos]);
+            if (++m_readyPos == m_ready.size())
+            {
+                m_ready.clear();
+                m_readyPos = 0;
+            }
+        }
+
+        bool empty() const { return !m_size; }
+        size_t size() const { return m_size; }
+
+        // true if any queued entry, ready or not, matches
+        template<typename Predicate>
+        bool AnyOf(Predicate pred) const
+        {
+            for (size_t i = m_readyPos; i < m_ready.size(); ++i)
+                if (pred(m_nodes[m_ready[i]].value))
+                    return true;
+
+            for (Slot const& slot : m_slots)
+                for (uint32 index = slot.head; index != INVALID_NODE; index = m_nodes[index].next)
+                    if (pred(m_nodes[index].value))
+                        return true;
+
+            return false;
+        }
+
+        // removes all queued entries, ready or not, that match and returns their count
+        template<typename Predicate>
+        size_t RemoveIf(Predicate pred)
+        {
+            size_t removed = 0;
+
+            auto readyEnd = std::remove_if(m_ready.begin() + m_readyPos, m_ready.end(), [&](uint32 index)
+            {
+                if (!pred(m_nodes[index].value))
+                    return false;
+
+                FreeNode(index);
+                ++removed;
+                return true;
+            });
+            m_ready.erase(readyEnd, m_ready.end());
+            if (m_readyPos == m_ready.size())
+            {
+                m_ready.clear();
+                m_readyPos = 0;
+            }
+
+            for (uint32 slotIndex = 0; slotIndex < m_slots.size(); ++slotIndex)
+            {
+                Slot& slot = m_slots[slotIndex];
+                uint32 prev = INVALID_NODE;
+                for (uint32 index = slot.head; index != INVALID_NODE;)
+                {
+                    uint32 next = m_nodes[index].next;
+                    if (pred(m_nodes[index].value))
+                    {
+                        Unlink(slotIndex, prev, index);
+                        FreeNode(index);
+                        ++removed;
+                    }
+                    else
+                        prev = index;
+                    index = next;
+                }
+            }
+
+            return removed;
+        }
+
+    private:
+        static uint32 const INVALID_NODE = uint32(-1);
+
+        struct Node
+        {
+            explicit Node(T const& v) : value(v), dueTime(0), sequence(0), next(INVALID_NODE) {}
+
+            T value;
+            uint64 dueTime;
+            uint64 sequence;                                // keeps insertion order of entries due at the same time
+            uint32 next;                                    // next entry of the slot or of the free list
+        };
+
+        struct Slot
+        {
+            Slot() : head(INVALID_NODE), tail(INVALID_NODE) {}
+
+            uint32 head;
+            uint32 tail;
+        };
+
+        // inner wheel slots first, then the outer wheel slots and the overflow list
+        uint32 OuterSlot(uint64 turn) const { return (1u << m_innerBits) + uint32(turn & ((uint64(1) << m_outerBits) - 1)); }
+        uint32 OverflowSlot() const { return uint32(m_slots.size() - 1); }
+
+        void Place(uint32 index)
+        {
+            // slots before the current tick were already collected, anything late goes to the current one
+            uint64 tick = std::max(m_nodes[index].dueTime / m_granularity, m_currentTick);
+            uint64 turn = tick >> m_innerBits;
+            uint64 currentTurn = m_currentTick >> m_innerBits;
+
+            uint32 slotIndex;
+            if (turn == currentTurn)
+            {
+                slotIndex = uint32(tick & ((uint64(1) << m_innerBits) - 1));
+                ++m_innerCount;
+            }
+            else if (turn - currentTurn < (uint64(1) << m_outerBits))
+                slotIndex = OuterSlot(turn);
+            else
+                slotIndex = OverflowSlot();
+
+            Slot& slot = m_slots[slotIndex];
+            m_nodes[index].next = INVALID_NODE;
+            if (slot.tail != INVALID_NODE)
+                m_nodes[slot.tail].next = index;
+            else
+                slot.head = index;
+            slot.tail = index;
+        }
+
+        void Unlink(uint32 slotIndex, uint32 prev, uint32 index)
+        {
+            Slot& slot = m_slots[slotIndex];
+            uint32 next = m_nodes[index].next;
+            if (prev != INVALID_NODE)
+                m_nodes[prev].next = next;
+            else
+                slot.head = next;
+
+            if (slot.tail == index)
+                slot.tail = prev;
+
+            if (slotIndex < (1u << m_innerBits))
+                --m_innerCount;
+        }
+
+        // detaches the list of a slot, its entries are placed again by the caller
+        uint32 TakeSlot(uint32 slotIndex)
+        {
+            Slot& slot = m_slots[slotIndex];
+            uint32 head = slot.head;
+            slot.head = slot.tail = INVALID_NODE;
+            return head;
+        }
+
+        void PlaceList(uint32 head)
+        {
+            while (head != INVALID_NODE)
+            {
+                uint32 next = m_nodes[head].next;
+                Place(head);
+                head = next;
+            }
+        }
+
+        void CollectSlot(uint32 slotIndex, uint64 now)
+        {
+            uint32 prev = INVALID_NODE;
+            for (uint32 index = m_slots[slotIndex].head; index != INVALID_NODE;)
+            {
+                uint32 next = m_nodes[index].next;
+                if (m_nodes[index].dueTime <= now)
+                {
+                    Unlink(slotIndex, prev, index);
+                    m_ready.push_back(index);
+                }
+                else
+                    prev = index;
+                index = next;
+            }
+        }
+
+        // the inner wheel starts a new turn at tick, it gets the entries of that turn from the outer wheel
+        void Cascade(uint64 tick)
+        {
+            uint64 turn = tick >> m_innerBits;
+            if (!(turn & ((uint64(1) << m_outerBits) - 1)))
+                PlaceList(TakeSlot(OverflowSlot()));
+
+            PlaceList(TakeSlot(OuterSlot(turn)));
+        }
+
+        void Rebuild(uint64 tick)
+        {
+            std::vector<uint32> heads;
+            for (uint32 slotIndex = 0; slotIndex < m_slots.size(); ++slotIndex)
+                if (m_slots[slotIndex].head != INVALID_NODE)
+                    heads.push_back(TakeSlot(slotIndex));
+
+            m_innerCount = 0;
+            m_currentTick = tick;
+            for (uint32 head : heads)
+                PlaceList(head);
+        }
+
+        void FreeNode(uint32 index)
+        {
+            m_nodes[index].next = m_freeNode;
+            m_freeNode = index;
+            --m_size;
+        }
+
+        uint32 m_granularity;
+        uint32 m_innerBits;
+        uint32 m_outerBits;
+        std::vector<Slot> m_slots;
+        std::vector<Node> m_nodes;
+        uint32 m_freeNode;
+        size_t m_size;                                      // all entries, ready or not
+        size_t m_innerCount;                                // entries in the inner wheel
+        uint64 m_nextSequence;
+        uint64 m_currentTick;                               // tick of the last CollectDue, earlier inner slots are empty
+
+        std::vector<uint32> m_ready;                        // due entries in order, consumed from m_readyPos
+        size_t m_readyPos;
+};
+
+#endif
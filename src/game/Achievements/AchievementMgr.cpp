@@ -435,6 +435,7 @@ void AchievementMgr::Reset()
 
     m_completedAchievements.clear();
     m_criteriaProgress.clear();
+    m_completedCriteria.clear();
     DeleteFromDB(m_player->GetObjectGuid());
 
     // re-fill data
@@ -646,6 +647,8 @@ void AchievementMgr::LoadFromDB(QueryResult* achievementResult, QueryResult* cri
             AchievementEntry const* achievement = sAchievementStore.LookupEntry(criteria->referredAchievement);
             // Checked in LoadAchievementCriteriaList
 
+            UpdateCompletedCriteria(criteria, achievement);
+
             // A failed achievement will be removed on next tick - TODO: Possible that timer 2 is reseted
             if (criteria->timeLimit)
             {
@@ -860,6 +863,7 @@ void AchievementMgr::DoFailedTimedAchievementCriterias()
 
             // Remove failed progress
             m_criteriaProgress.erase(pro_iter);
+            m_completedCriteria.erase(criteria->ID);
         }
 
         m_criteriaFailTimes.erase(iter++);
@@ -876,9 +880,16 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, ui
     if (!sWorld.getConfig(CONFIG_BOOL_GM_ALLOW_ACHIEVEMENT_GAINS) && m_player->GetSession()->GetSecurity() > SEC_PLAYER)
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByType(type);
+    // with a creature/item/spell/... id only criteria using that id are checked
+    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByType(type, miscvalue1);
+    sAchievementMgr.CountCriteriaUpdate(achievementCriteriaList.size(), sAchievementMgr.GetAchievementCriteriaByType(type).size());
+
     for (auto achievementCriteria : achievementCriteriaList)
     {
+        // don't update already completed criteria
+        if (m_completedCriteria.find(achievementCriteria->ID) != m_completedCriteria.end())
+            continue;
+
         AchievementEntry const* achievement = sAchievementStore.LookupEntry(achievementCriteria->referredAchievement);
         // Checked in LoadAchievementCriteriaList
 
@@ -886,7 +897,7 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, ui
                 (achievement->factionFlag == ACHIEVEMENT_FACTION_FLAG_ALLIANCE && GetPlayer()->GetTeam() != ALLIANCE))
             continue;
 
-        // don't update already completed criteria
+        // counter and realm first criteria are not in m_completedCriteria
         if (IsCompletedCriteria(achievementCriteria, achievement))
             continue;
 
@@ -2036,6 +2047,18 @@ bool AchievementMgr::IsCompletedCriteria(AchievementCriteriaEntry const* achieve
     return progress->counter >= maxcounter || (achievement->flags & ACHIEVEMENT_FLAG_REQ_COUNT && progress->counter);
 }
 
+void AchievementMgr::UpdateCompletedCriteria(AchievementCriteriaEntry const* criteria, AchievementEntry const* achievement)
+{
+    // completion of these does not depend on the progress counter only
+    if (achievement->flags & (ACHIEVEMENT_FLAG_COUNTER | ACHIEVEMENT_FLAG_REALM_FIRST_REACH | ACHIEVEMENT_FLAG_REALM_FIRST_KILL))
+        return;
+
+    if (IsCompletedCriteria(criteria, achievement))
+        m_completedCriteria.insert(criteria->ID);
+    else
+        m_completedCriteria.erase(criteria->ID);
+}
+
 void AchievementMgr::CompletedCriteriaFor(AchievementEntry const* achievement)
 {
     // counter can never complete
@@ -2175,6 +2198,8 @@ void AchievementMgr::SetCriteriaProgress(AchievementCriteriaEntry const* criteri
     progress->counter = newValue;
     progress->changed = true;
 
+    UpdateCompletedCriteria(criteria, achievement);
+
     // update client side value
     SendCriteriaUpdate(criteria->ID, progress);
 
@@ -2371,11 +2396,69 @@ void AchievementMgr::BuildAllDataPacket(WorldPacket& data)
 }
 
 //==========================================================
+/**
+ * Id that AchievementMgr::UpdateAchievementCriteria requires a non zero miscvalue1 to be equal to,
+ * returns false for types that don't reject criteria by miscvalue1 alone
+ */
+static bool GetCriteriaMiscValueKey(AchievementCriteriaEntry const* criteria, uint32& key)
+{
+    switch (criteria->requiredType)
+    {
+        case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:           key = criteria->kill_creature.creatureID;           return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL:       key = criteria->reach_skill_level.skillID;          return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LEVEL:       key = criteria->learn_skill_level.skillID;          return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUESTS_IN_ZONE: key = criteria->complete_quests_in_zone.zoneID;     return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_KILLED_BY_CREATURE:      key = criteria->killed_by_creature.creatureEntry;   return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:          key = criteria->complete_quest.questID;             return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET2:        key = criteria->be_spell_target.spellID;            return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL2:             key = criteria->cast_spell.spellID;                 return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SPELL:             key = criteria->learn_spell.spellID;                return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_TYPE:               key = criteria->loot_type.lootType;                 return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_ITEM:               key = criteria->own_item.itemID;                    return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_ITEM:                key = criteria->use_item.itemID;                    return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_GAIN_REPUTATION:         key = criteria->gain_reputation.factionID;          return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_DO_EMOTE:                key = criteria->do_emote.emoteID;                   return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:              key = criteria->equip_item.itemID;                  return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_GAMEOBJECT:          key = criteria->use_gameobject.goEntry;             return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_FISH_IN_GAMEOBJECT:      key = criteria->fish_in_gameobject.goEntry;         return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILLLINE_SPELLS:  key = criteria->learn_skillline_spell.skillLine;    return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LINE:        key = criteria->learn_skill_line.skillLine;         return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_CLASS:                key = criteria->hk_class.classID;                   return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_RACE:                 key = criteria->hk_race.raceID;                     return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_TEAM_RATING:     key = criteria->highest_team_rating.teamtype;       return true;
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_PERSONAL_RATING: key = criteria->highest_personal_rating.teamtype;   return true;
+        default:
+            return false;
+    }
+}
+
+AchievementGlobalMgr::AchievementGlobalMgr() : m_criteriaUpdateCalls(0), m_criteriaUpdateScanned(0), m_criteriaUpdateTypeTotal(0)
+{
+}
+
 AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByType(AchievementCriteriaTypes type) const
 {
     return m_AchievementCriteriasByType[type];
 }
 
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByType(AchievementCriteriaTypes type, uint32 miscvalue1) const
+{
+    // 0 is used at login/reset to recheck all criteria of the type
+    if (!miscvalue1)
+        return m_AchievementCriteriasByType[type];
+
+    AchievementCriteriaListByMiscValue const& byMisc = m_AchievementCriteriasByTypeAndMisc[type];
+    if (byMisc.empty())
+        return m_AchievementCriteriasByType[type];
+
+    static AchievementCriteriaEntryList const emptyList;
+    AchievementCriteriaListByMiscValue::const_iterator itr = byMisc.find(miscvalue1);
+    return itr != byMisc.end() ? itr->second : emptyList;
+}
+
 AchievementCriteriaEntryList const* AchievementGlobalMgr::GetAchievementCriteriaByAchievement(uint32 id)
 {
     AchievementCriteriaListByAchievement::const_iterator itr = m_AchievementCriteriaListByAchievement.find(id);
@@ -2459,6 +2542,11 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
 
         m_AchievementCriteriasByType[criteria->requiredType].push_back(criteria);
         m_AchievementCriteriaListByAchievement[criteria->referredAchievement].push_back(criteria);
+
+        uint32 miscValueKey;
+        if (GetCriteriaMiscValueKey(criteria, miscValueKey))
+            m_AchievementCriteriasByTypeAndMisc[criteria->requiredType][miscValueKey].push_back(criteria);
+
         ++count;
     }
 
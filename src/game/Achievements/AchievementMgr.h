@@ -24,17 +24,21 @@
 #include "Globals/SharedDefines.h"
 #include "Entities/ObjectGuid.h"
 
+#include <atomic>
 #include <map>
+#include <unordered_set>
+#include <vector>
 
 struct AchievementEntry;
 struct AchievementCriteriaEntry;
 
-typedef std::list<AchievementCriteriaEntry const*> AchievementCriteriaEntryList;
+typedef std::vector<AchievementCriteriaEntry const*> AchievementCriteriaEntryList;
 typedef std::list<AchievementEntry const*>         AchievementEntryList;
 
 typedef std::map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByAchievement;
 typedef std::map<uint32, AchievementEntryList>         AchievementListByReferencedId;
 typedef std::map<uint32, time_t>                       AchievementCriteriaFailTimeMap;
+typedef std::unordered_map<uint32, AchievementCriteriaEntryList> AchievementCriteriaListByMiscValue;
 
 struct CriteriaProgress
 {
@@ -299,17 +303,25 @@ class AchievementMgr
         void IncompletedAchievement(AchievementEntry const* achievement);
         bool IsCompletedAchievement(AchievementEntry const* entry);
         void BuildAllDataPacket(WorldPacket& data);
+        void UpdateCompletedCriteria(AchievementCriteriaEntry const* criteria, AchievementEntry const* achievement);
 
         Player* m_player;
         CriteriaProgressMap m_criteriaProgress;
         CompletedAchievementMap m_completedAchievements;
         AchievementCriteriaFailTimeMap m_criteriaFailTimes;
+
+        // criteria that can't be updated anymore, counter and realm first achievements are never stored
+        std::unordered_set<uint32> m_completedCriteria;
 };
 
 class AchievementGlobalMgr
 {
     public:
+        AchievementGlobalMgr();
+
         AchievementCriteriaEntryList const& GetAchievementCriteriaByType(AchievementCriteriaTypes type) const;
+        // criteria of the type that can be matched by a non zero miscvalue1 in AchievementMgr::UpdateAchievementCriteria
+        AchievementCriteriaEntryList const& GetAchievementCriteriaByType(AchievementCriteriaTypes type, uint32 miscvalue1) const;
         AchievementCriteriaEntryList const* GetAchievementCriteriaByAchievement(uint32 id);
         AchievementEntryList const* GetAchievementByReferencedId(uint32 id) const;
         AchievementReward const* GetAchievementReward(AchievementEntry const* achievement, uint8 gender) const;
@@ -326,11 +338,27 @@ class AchievementGlobalMgr
         void LoadRewards();
         void LoadRewardLocales();
 
+        // UpdateAchievementCriteria calls, criteria checked and criteria a scan of the whole type would have checked
+        void CountCriteriaUpdate(uint32 scanned, uint32 typeTotal)
+        {
+            ++m_criteriaUpdateCalls;
+            m_criteriaUpdateScanned += scanned;
+            m_criteriaUpdateTypeTotal += typeTotal;
+        }
+        void TakeCriteriaUpdateStats(uint64& calls, uint64& scanned, uint64& typeTotal)
+        {
+            calls = m_criteriaUpdateCalls.exchange(0);
+            scanned = m_criteriaUpdateScanned.exchange(0);
+            typeTotal = m_criteriaUpdateTypeTotal.exchange(0);
+        }
+
     private:
         AchievementCriteriaRequirementMap m_criteriaRequirementMap;
 
         // store achievement criterias by type to speed up lookup
         AchievementCriteriaEntryList m_AchievementCriteriasByType[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
+        // same, split by the creature/item/spell/... id miscvalue1 is compared against, for types having one
+        AchievementCriteriaListByMiscValue m_AchievementCriteriasByTypeAndMisc[ACHIEVEMENT_CRITERIA_TYPE_TOTAL];
         // store achievement criterias by achievement to speed up lookup
         AchievementCriteriaListByAchievement m_AchievementCriteriaListByAchievement;
         // store achievements by referenced achievement id to speed up lookup
@@ -341,6 +369,10 @@ class AchievementGlobalMgr
 
         AchievementRewardsMap       m_achievementRewards;
         AchievementRewardLocalesMap m_achievementRewardLocales;
+
+        std::atomic<uint64> m_criteriaUpdateCalls;
+        std::atomic<uint64> m_criteriaUpdateScanned;
+        std::atomic<uint64> m_criteriaUpdateTypeTotal;
 };
 
 #define sAchievementMgr MaNGOS::Singleton<AchievementGlobalMgr>::Instance()
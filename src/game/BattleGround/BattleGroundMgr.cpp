@@ -64,6 +64,16 @@ BattleGroundQueue::BattleGroundQueue()
                 m_waitTimes[i][j][k] = 0;
         }
     }
+
+    for (uint8 i = 0; i < MAX_BATTLEGROUND_BRACKETS; ++i)
+    {
+        for (uint8 j = 0; j < BG_QUEUE_GROUP_TYPES_COUNT; ++j)
+        {
+            m_waitingPlayers[i][j] = 0;
+            m_queueFrontOrder[i][j] = 0;
+            m_queueBackOrder[i][j] = 0;
+        }
+    }
 }
 
 BattleGroundQueue::~BattleGroundQueue()
@@ -159,6 +169,95 @@ bool BattleGroundQueue::SelectionPool::AddGroup(GroupQueueInfo* queueInfo, uint3
 /***               BATTLEGROUND QUEUES                 ***/
 /*********************************************************/
 
+/**
+  Method that stores group in the given queue and remembers its position there
+
+  @param    group queue info
+  @param    bracket id
+  @param    queue index
+  @param    insert at front
+*/
+void BattleGroundQueue::LinkGroup(GroupQueueInfo* group, BattleGroundBracketId bracketId, uint8 index, bool atFront)
+{
+    GroupsQueueType& queue = m_queuedGroups[bracketId][index];
+    group->bracketId = bracketId;
+    group->queueIndex = index;
+
+    if (atFront)
+    {
+        group->queueOrder = --m_queueFrontOrder[bracketId][index];
+        group->queuePosition = queue.insert(queue.begin(), group);
+    }
+    else
+    {
+        group->queueOrder = m_queueBackOrder[bracketId][index]++;
+        group->queuePosition = queue.insert(queue.end(), group);
+    }
+
+    AddWaitingGroup(group);
+}
+
+/**
+  Method that removes group from its queue, the group queue info itself is not deleted
+
+  @param    group queue info
+*/
+void BattleGroundQueue::UnlinkGroup(GroupQueueInfo* group)
+{
+    RemoveWaitingGroup(group);
+    m_queuedGroups[group->bracketId][group->queueIndex].erase(group->queuePosition);
+}
+
+/**
+  Method that moves group to the front of another queue of the same bracket
+
+  @param    group queue info
+  @param    queue index
+*/
+void BattleGroundQueue::MoveGroup(GroupQueueInfo* group, uint8 index)
+{
+    UnlinkGroup(group);
+    LinkGroup(group, group->bracketId, index, true);
+}
+
+/**
+  Methods that account not yet invited group in waiting player counters and rated arena rating index
+
+  @param    group queue info
+*/
+void BattleGroundQueue::AddWaitingGroup(GroupQueueInfo* group)
+{
+    if (group->isInvitedToBgInstanceGuid)
+        return;
+
+    m_waitingPlayers[group->bracketId][group->queueIndex] += group->players.size();
+
+    if (group->isRated && group->queueIndex < BG_QUEUE_NORMAL_ALLIANCE)
+        m_waitingRatedGroups[group->bracketId][group->queueIndex].insert(RatedGroupsIndex::value_type(group->arenaTeamRating, group));
+}
+
+void BattleGroundQueue::RemoveWaitingGroup(GroupQueueInfo* group)
+{
+    if (group->isInvitedToBgInstanceGuid)
+        return;
+
+    m_waitingPlayers[group->bracketId][group->queueIndex] -= group->players.size();
+
+    if (group->isRated && group->queueIndex < BG_QUEUE_NORMAL_ALLIANCE)
+    {
+        RatedGroupsIndex& index = m_waitingRatedGroups[group->bracketId][group->queueIndex];
+        auto bounds = index.equal_range(group->arenaTeamRating);
+        for (auto itr = bounds.first; itr != bounds.second; ++itr)
+        {
+            if (itr->second == group)
+            {
+                index.erase(itr);
+                break;
+            }
+        }
+    }
+}
+
 /**
   Function that adds group or player (grp == nullptr) to battleground queue with the given leader and specifications
 
@@ -235,7 +334,7 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* group, Battle
         }
 
         // add GroupInfo to m_QueuedGroups
-        m_queuedGroups[bracketId][index].push_back(queueInfo);
+        LinkGroup(queueInfo, bracketId, index, false);
 
         // announce to world, this code needs mutex
         if (arenaType == ARENA_TYPE_NONE && !isRated && !isPremade && sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN))
@@ -244,20 +343,11 @@ GroupQueueInfo* BattleGroundQueue::AddGroup(Player* leader, Group* group, Battle
             {
                 char const* bgName = bg->GetName();
                 uint32 minPlayers = bg->GetMinPlayersPerTeam();
-                uint32 qHorde = 0;
-                uint32 qAlliance = 0;
+                uint32 qHorde = m_waitingPlayers[bracketId][BG_QUEUE_NORMAL_HORDE];
+                uint32 qAlliance = m_waitingPlayers[bracketId][BG_QUEUE_NORMAL_ALLIANCE];
                 uint32 qMinLevel = bracketEntry->minLevel;
                 uint32 qMaxLevel = bracketEntry->maxLevel;
 
-                GroupsQueueType::const_iterator itr;
-                for (itr = m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].begin(); itr != m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].end(); ++itr)
-                    if (!(*itr)->isInvitedToBgInstanceGuid)
-                        qAlliance += (*itr)->players.size();
-
-                for (itr = m_queuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].begin(); itr != m_queuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].end(); ++itr)
-                    if (!(*itr)->isInvitedToBgInstanceGuid)
-                        qHorde += (*itr)->players.size();
-
                 // Show queue status to player only (when joining queue)
                 if (sWorld.getConfig(CONFIG_UINT32_BATTLEGROUND_QUEUE_ANNOUNCER_JOIN) == 1)
                     ChatHandler(leader).PSendSysMessage(LANG_BG_QUEUE_ANNOUNCE_SELF, bgName, qMinLevel, qMaxLevel, qAlliance, (minPlayers > qAlliance) ? minPlayers - qAlliance : (uint32)0, qHorde, (minPlayers > qHorde) ? minPlayers - qHorde : (uint32)0);
@@ -350,8 +440,6 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // Player *plr = sObjectMgr.GetPlayer(guid);
     // std::lock_guard<std::recursive_mutex> guard(m_Lock);
 
-    int32 bracketId = -1;                                   // signed for proper for-loop finish
-
     // remove player from map, if he's there
     QueuedPlayersMap::iterator itr = m_queuedPlayers.find(guid);
     if (itr == m_queuedPlayers.end())
@@ -360,40 +448,9 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
         return;
     }
 
+    // the group knows its queue, even after premade groups were moved to normal queue
     GroupQueueInfo* group = itr->second.groupInfo;
-    GroupsQueueType::iterator group_itr;
-    // mostly people with the highest levels are in battlegrounds, thats why
-    // we count from MAX_BATTLEGROUND_QUEUES - 1 to 0
-    // variable index removes useless searching in other team's queue
-    uint32 index = GetTeamIndexByTeamId(group->groupTeam);
-
-    for (int8 bracketIdTmp = MAX_BATTLEGROUND_BRACKETS - 1; bracketIdTmp >= 0 && bracketId == -1; --bracketIdTmp)
-    {
-        // we must check premade and normal team's queue - because when players from premade are joining bg,
-        // they leave groupinfo so we can't use its players size to find out index
-        for (uint8 j = index; j < BG_QUEUE_GROUP_TYPES_COUNT; j += BG_QUEUE_NORMAL_ALLIANCE)
-        {
-            for (GroupsQueueType::iterator group_itr_tmp = m_queuedGroups[bracketIdTmp][j].begin(); group_itr_tmp != m_queuedGroups[bracketIdTmp][j].end(); ++group_itr_tmp)
-            {
-                if ((*group_itr_tmp) == group)
-                {
-                    bracketId = bracketIdTmp;
-                    group_itr = group_itr_tmp;
-                    // we must store index to be able to erase iterator
-                    index = j;
-                    break;
-                }
-            }
-        }
-    }
-
-    // player can't be in queue without group, but just in case
-    if (bracketId == -1)
-    {
-        sLog.outError("BattleGroundQueue: ERROR Cannot find groupinfo for %s", guid.GetString().c_str());
-        return;
-    }
-    DEBUG_LOG("BattleGroundQueue: Removing %s, from bracket_id %u", guid.GetString().c_str(), (uint32)bracketId);
+    DEBUG_LOG("BattleGroundQueue: Removing %s, from bracket_id %u", guid.GetString().c_str(), (uint32)group->bracketId);
 
     // ALL variables are correctly set
     // We can ignore leveling up in queue - it should not cause crash
@@ -403,7 +460,12 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove player queue info from group queue info
     GroupQueueInfoPlayers::iterator pitr = group->players.find(guid);
     if (pitr != group->players.end())
+    {
+        if (!group->isInvitedToBgInstanceGuid)
+            --m_waitingPlayers[group->bracketId][group->queueIndex];
+
         group->players.erase(pitr);
+    }
 
     // if invited to bg, and should decrease invited count, then do it
     if (decreaseInvitedCount && group->isInvitedToBgInstanceGuid)
@@ -440,7 +502,7 @@ void BattleGroundQueue::RemovePlayer(ObjectGuid guid, bool decreaseInvitedCount)
     // remove group queue info if needed
     if (group->players.empty())
     {
-        m_queuedGroups[bracketId][index].erase(group_itr);
+        UnlinkGroup(group);
         delete group;
     }
     // if group wasn't empty, so it wasn't deleted, and player have left a rated
@@ -520,6 +582,7 @@ bool BattleGroundQueue::InviteGroupToBg(GroupQueueInfo* queueInfo, BattleGround*
     {
         // not yet invited
         // set invitation
+        RemoveWaitingGroup(queueInfo);
         queueInfo->isInvitedToBgInstanceGuid = bg->GetInstanceId();
         BattleGroundTypeId bgTypeId = bg->GetTypeId();
         BattleGroundQueueTypeId bgQueueTypeId = BattleGroundMgr::BgQueueTypeId(bgTypeId, bg->GetArenaType());
@@ -714,12 +777,11 @@ bool BattleGroundQueue::CheckPremadeMatch(BattleGroundBracketId bracketId, uint3
     {
         if (!m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE + i].empty())
         {
-            GroupsQueueType::iterator itr = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE + i].begin();
-            if (!(*itr)->isInvitedToBgInstanceGuid && ((*itr)->joinTime < time_before || (*itr)->players.size() < minPlayersPerTeam))
+            GroupQueueInfo* group = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE + i].front();
+            if (!group->isInvitedToBgInstanceGuid && (group->joinTime < time_before || group->players.size() < minPlayersPerTeam))
             {
                 // we must insert group to normal queue and erase pointer from premade queue
-                m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + i].push_front((*itr));
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE + i].erase(itr);
+                MoveGroup(group, BG_QUEUE_NORMAL_ALLIANCE + i);
             }
         }
     }
@@ -808,16 +870,11 @@ bool BattleGroundQueue::CheckSkirmishForSameFaction(BattleGroundBracketId bracke
     m_selectionPools[otherTeamIdx].Init();
     // store last ginfo pointer
     GroupQueueInfo* ginfo = m_selectionPools[teamIdx].selectedGroups.back();
-    // set itr_team to group that was added to selection pool latest
-    GroupsQueueType::iterator itr_team = m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].begin();
-    for (; itr_team != m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].end(); ++itr_team)
-        if (ginfo == *itr_team)
-            break;
-
-    if (itr_team == m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].end())
+    // continue behind the group that was added to selection pool latest
+    if (ginfo->bracketId != bracketId || ginfo->queueIndex != BG_QUEUE_NORMAL_ALLIANCE + teamIdx)
         return false;
 
-    GroupsQueueType::iterator itr_team2 = itr_team;
+    GroupsQueueType::iterator itr_team2 = ginfo->queuePosition;
     ++itr_team2;
     // invite players to other selection pool
     for (; itr_team2 != m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].end(); ++itr_team2)
@@ -836,24 +893,47 @@ bool BattleGroundQueue::CheckSkirmishForSameFaction(BattleGroundBracketId bracke
         // set correct team
         (*itr)->groupTeam = otherTeamId;
 
-        // add team to other queue
-        m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + otherTeamIdx].push_front(*itr);
-
-        // remove team from old queue
-        GroupsQueueType::iterator itr2 = itr_team;
-        ++itr2;
-        for (; itr2 != m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].end(); ++itr2)
-        {
-            if (*itr2 == *itr)
-            {
-                m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE + teamIdx].erase(itr2);
-                break;
-            }
-        }
+        // move team to other queue
+        MoveGroup(*itr, BG_QUEUE_NORMAL_ALLIANCE + otherTeamIdx);
     }
     return true;
 }
 
+/**
+  Function that returns the first rated arena team in queue order that may play against the given rating range
+  - teams within the rating range are looked up in the rating index
+  - teams waiting longer than the rating discard time match any rating, only the part of the queue before the indexed candidate needs a check
+
+  @param    bracket id
+  @param    queue index
+  @param    min rating
+  @param    max rating
+  @param    discard time
+  @param    group to skip (already selected)
+*/
+GroupQueueInfo* BattleGroundQueue::SelectRatedArenaGroup(BattleGroundBracketId bracketId, uint8 index, uint32 minRating, uint32 maxRating, uint32 discardTime, GroupQueueInfo const* exclude) const
+{
+    GroupQueueInfo* selected = nullptr;
+
+    RatedGroupsIndex const& ratedGroups = m_waitingRatedGroups[bracketId][index];
+    for (RatedGroupsIndex::const_iterator itr = ratedGroups.lower_bound(minRating); itr != ratedGroups.end() && itr->first <= maxRating; ++itr)
+    {
+        if (itr->second != exclude && (!selected || itr->second->queueOrder < selected->queueOrder))
+            selected = itr->second;
+    }
+
+    for (GroupQueueInfo* group : m_queuedGroups[bracketId][index])
+    {
+        if (selected && group->queueOrder >= selected->queueOrder)
+            break;
+
+        if (!group->isInvitedToBgInstanceGuid && group != exclude && group->joinTime < discardTime)
+            return group;
+    }
+
+    return selected;
+}
+
 /**
   Method that is called when group is inserted, or player / group is removed from BG Queue - there is only one player's status changed, so we don't use while(true) cycles to invite whole queue
   - it must be called after fully adding the members of a group to ensure group joining
@@ -868,11 +948,11 @@ bool BattleGroundQueue::CheckSkirmishForSameFaction(BattleGroundBracketId bracke
 void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketId bracketId, ArenaType arenaType, bool isRated, uint32 arenaRating)
 {
     // std::lock_guard<std::recursive_mutex> guard(m_Lock);
-    // if no players in queue - do nothing
-    if (m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].empty() &&
-            m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].empty() &&
-            m_queuedGroups[bracketId][BG_QUEUE_NORMAL_ALLIANCE].empty() &&
-            m_queuedGroups[bracketId][BG_QUEUE_NORMAL_HORDE].empty())
+    // if no players waiting for invite in queue - do nothing, already invited groups can't be matched again
+    if (!m_waitingPlayers[bracketId][BG_QUEUE_PREMADE_ALLIANCE] &&
+            !m_waitingPlayers[bracketId][BG_QUEUE_PREMADE_HORDE] &&
+            !m_waitingPlayers[bracketId][BG_QUEUE_NORMAL_ALLIANCE] &&
+            !m_waitingPlayers[bracketId][BG_QUEUE_NORMAL_HORDE])
         return;
 
     // battleground with free slot for player should be always in the beggining of the queue
@@ -1056,68 +1136,32 @@ void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketI
         uint32 discardTime = WorldTimer::getMSTime() - sBattleGroundMgr.GetRatingDiscardTimer();
 
         // we need to find 2 teams which will play next game
-
-        GroupsQueueType::iterator itr_team[PVP_TEAM_COUNT];
-
         // optimalization : --- we dont need to use selection_pools - each update we select max 2 groups
-
+        GroupQueueInfo* selected[PVP_TEAM_COUNT];
         for (uint8 i = BG_QUEUE_PREMADE_ALLIANCE; i < BG_QUEUE_NORMAL_ALLIANCE; ++i)
         {
-            // take the group that joined first
-            itr_team[i] = m_queuedGroups[bracketId][i].begin();
-            for (; itr_team[i] != m_queuedGroups[bracketId][i].end(); ++(itr_team[i]))
-            {
-                // if group match conditions, then add it to pool
-                if (!(*itr_team[i])->isInvitedToBgInstanceGuid
-                        && (((*itr_team[i])->arenaTeamRating >= arenaMinRating && (*itr_team[i])->arenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[i])->joinTime < discardTime))
-                {
-                    m_selectionPools[i].AddGroup((*itr_team[i]), maxPlayersPerTeam);
-                    // break for cycle to be able to start selecting another group from same faction queue
-                    break;
-                }
-            }
+            selected[i] = SelectRatedArenaGroup(bracketId, i, arenaMinRating, arenaMaxRating, discardTime, nullptr);
+            if (selected[i] && selected[i]->players.size() > maxPlayersPerTeam)
+                selected[i] = nullptr;
         }
+
         // now we are done if we have 2 groups - ali vs horde!
         // if we don't have, we must try to continue search in same queue
-        // tmp variables are correctly set
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in HORDE queue
-        if (m_selectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount() == 0 && m_selectionPools[TEAM_INDEX_HORDE].GetPlayerCount())
+        if (!selected[TEAM_INDEX_ALLIANCE] && selected[TEAM_INDEX_HORDE])
         {
-            itr_team[TEAM_INDEX_ALLIANCE] = itr_team[TEAM_INDEX_HORDE];
-            ++itr_team[TEAM_INDEX_ALLIANCE];
-
-            for (; itr_team[TEAM_INDEX_ALLIANCE] != m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].end(); ++(itr_team[TEAM_INDEX_ALLIANCE]))
-            {
-                if (!(*itr_team[TEAM_INDEX_ALLIANCE])->isInvitedToBgInstanceGuid
-                        && (((*itr_team[TEAM_INDEX_ALLIANCE])->arenaTeamRating >= arenaMinRating && (*itr_team[TEAM_INDEX_ALLIANCE])->arenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[TEAM_INDEX_ALLIANCE])->joinTime < discardTime))
-                {
-                    m_selectionPools[TEAM_INDEX_ALLIANCE].AddGroup((*itr_team[TEAM_INDEX_ALLIANCE]), maxPlayersPerTeam);
-                    break;
-                }
-            }
+            selected[TEAM_INDEX_ALLIANCE] = SelectRatedArenaGroup(bracketId, BG_QUEUE_PREMADE_HORDE, arenaMinRating, arenaMaxRating, discardTime, selected[TEAM_INDEX_HORDE]);
+            if (selected[TEAM_INDEX_ALLIANCE] && selected[TEAM_INDEX_ALLIANCE]->players.size() > maxPlayersPerTeam)
+                selected[TEAM_INDEX_ALLIANCE] = nullptr;
         }
-        // this code isn't much userfriendly - but it is supposed to continue search for mathing group in ALLIANCE queue
-        if (m_selectionPools[TEAM_INDEX_HORDE].GetPlayerCount() == 0 && m_selectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount())
+        else if (!selected[TEAM_INDEX_HORDE] && selected[TEAM_INDEX_ALLIANCE])
         {
-            itr_team[TEAM_INDEX_HORDE] = itr_team[TEAM_INDEX_ALLIANCE];
-            ++itr_team[TEAM_INDEX_HORDE];
-
-            for (; itr_team[TEAM_INDEX_HORDE] != m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].end(); ++(itr_team[TEAM_INDEX_HORDE]))
-            {
-                if (!(*itr_team[TEAM_INDEX_HORDE])->isInvitedToBgInstanceGuid
-                        && (((*itr_team[TEAM_INDEX_HORDE])->arenaTeamRating >= arenaMinRating && (*itr_team[TEAM_INDEX_HORDE])->arenaTeamRating <= arenaMaxRating)
-                            || (*itr_team[TEAM_INDEX_HORDE])->joinTime < discardTime))
-                {
-                    m_selectionPools[TEAM_INDEX_HORDE].AddGroup((*itr_team[TEAM_INDEX_HORDE]), maxPlayersPerTeam);
-                    break;
-                }
-            }
+            selected[TEAM_INDEX_HORDE] = SelectRatedArenaGroup(bracketId, BG_QUEUE_PREMADE_ALLIANCE, arenaMinRating, arenaMaxRating, discardTime, selected[TEAM_INDEX_ALLIANCE]);
+            if (selected[TEAM_INDEX_HORDE] && selected[TEAM_INDEX_HORDE]->players.size() > maxPlayersPerTeam)
+                selected[TEAM_INDEX_HORDE] = nullptr;
         }
 
         // if we have 2 teams, then start new arena and invite players!
-        if (m_selectionPools[TEAM_INDEX_ALLIANCE].GetPlayerCount() && m_selectionPools[TEAM_INDEX_HORDE].GetPlayerCount())
+        if (selected[TEAM_INDEX_ALLIANCE] && selected[TEAM_INDEX_HORDE])
         {
             BattleGround* arena = sBattleGroundMgr.CreateNewBattleGround(bgTypeId, bracketEntry, arenaType, true);
             if (!arena)
@@ -1126,30 +1170,20 @@ void BattleGroundQueue::Update(BattleGroundTypeId bgTypeId, BattleGroundBracketI
                 return;
             }
 
-            (*(itr_team[TEAM_INDEX_ALLIANCE]))->opponentsTeamRating = (*(itr_team[TEAM_INDEX_HORDE]))->arenaTeamRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[TEAM_INDEX_ALLIANCE]))->arenaTeamId, (*(itr_team[TEAM_INDEX_ALLIANCE]))->opponentsTeamRating);
-            (*(itr_team[TEAM_INDEX_HORDE]))->opponentsTeamRating = (*(itr_team[TEAM_INDEX_ALLIANCE]))->arenaTeamRating;
-            DEBUG_LOG("setting oposite teamrating for team %u to %u", (*(itr_team[TEAM_INDEX_HORDE]))->arenaTeamId, (*(itr_team[TEAM_INDEX_HORDE]))->opponentsTeamRating);
+            selected[TEAM_INDEX_ALLIANCE]->opponentsTeamRating = selected[TEAM_INDEX_HORDE]->arenaTeamRating;
+            DEBUG_LOG("setting oposite teamrating for team %u to %u", selected[TEAM_INDEX_ALLIANCE]->arenaTeamId, selected[TEAM_INDEX_ALLIANCE]->opponentsTeamRating);
+            selected[TEAM_INDEX_HORDE]->opponentsTeamRating = selected[TEAM_INDEX_ALLIANCE]->arenaTeamRating;
+            DEBUG_LOG("setting oposite teamrating for team %u to %u", selected[TEAM_INDEX_HORDE]->arenaTeamId, selected[TEAM_INDEX_HORDE]->opponentsTeamRating);
 
             // now we must move team if we changed its faction to another faction queue, because then we will spam log by errors in Queue::RemovePlayer
-            if ((*(itr_team[TEAM_INDEX_ALLIANCE]))->groupTeam != ALLIANCE)
-            {
-                // add to alliance queue
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].push_front(*(itr_team[TEAM_INDEX_ALLIANCE]));
-                // erase from horde queue
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].erase(itr_team[TEAM_INDEX_ALLIANCE]);
-                itr_team[TEAM_INDEX_ALLIANCE] = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].begin();
-            }
+            if (selected[TEAM_INDEX_ALLIANCE]->queueIndex != BG_QUEUE_PREMADE_ALLIANCE)
+                MoveGroup(selected[TEAM_INDEX_ALLIANCE], BG_QUEUE_PREMADE_ALLIANCE);
 
-            if ((*(itr_team[TEAM_INDEX_HORDE]))->groupTeam != HORDE)
-            {
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].push_front(*(itr_team[TEAM_INDEX_HORDE]));
-                m_queuedGroups[bracketId][BG_QUEUE_PREMADE_ALLIANCE].erase(itr_team[TEAM_INDEX_HORDE]);
-                itr_team[TEAM_INDEX_HORDE] = m_queuedGroups[bracketId][BG_QUEUE_PREMADE_HORDE].begin();
-            }
+            if (selected[TEAM_INDEX_HORDE]->queueIndex != BG_QUEUE_PREMADE_HORDE)
+                MoveGroup(selected[TEAM_INDEX_HORDE], BG_QUEUE_PREMADE_HORDE);
 
-            InviteGroupToBg(*(itr_team[TEAM_INDEX_ALLIANCE]), arena, ALLIANCE);
-            InviteGroupToBg(*(itr_team[TEAM_INDEX_HORDE]), arena, HORDE);
+            InviteGroupToBg(selected[TEAM_INDEX_ALLIANCE], arena, ALLIANCE);
+            InviteGroupToBg(selected[TEAM_INDEX_HORDE], arena, HORDE);
 
             DEBUG_LOG("Starting rated arena match!");
 
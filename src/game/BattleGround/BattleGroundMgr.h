@@ -61,6 +61,12 @@ struct GroupQueueInfo                                       // stores informatio
     uint32  isInvitedToBgInstanceGuid;                      // was invited to certain BG
     uint32  arenaTeamRating;                                // if rated match, inited to the rating of the team
     uint32  opponentsTeamRating;                            // for rated arena matches
+
+    // position in the owning BattleGroundQueue, maintained by the queue
+    BattleGroundBracketId bracketId;
+    uint8   queueIndex;                                     // BattleGroundQueueGroupTypes
+    int64   queueOrder;                                     // ascending in list order of the queue
+    std::list<GroupQueueInfo*>::iterator queuePosition;
 };
 
 enum BattleGroundQueueGroupTypes
@@ -86,6 +92,7 @@ class BattleGroundQueue
         bool CheckPremadeMatch(BattleGroundBracketId /*bracketId*/, uint32 /*minPlayersPerTeam*/, uint32 /*maxPlayersPerTeam*/);
         bool CheckNormalMatch(BattleGround* /*bgTemplate*/, BattleGroundBracketId /*bracketId*/, uint32 /*minPlayers*/, uint32 /*maxPlayers*/);
         bool CheckSkirmishForSameFaction(BattleGroundBracketId /*bracketId*/, uint32 /*minPlayersPerTeam*/);
+        GroupQueueInfo* SelectRatedArenaGroup(BattleGroundBracketId /*bracketId*/, uint8 /*index*/, uint32 /*minRating*/, uint32 /*maxRating*/, uint32 /*discardTime*/, GroupQueueInfo const* /*exclude*/) const;
         GroupQueueInfo* AddGroup(Player* /*leader*/, Group* /*group*/, BattleGroundTypeId /*bgTypeId*/, PvPDifficultyEntry const* /*bracketEntry*/, ArenaType /*arenaType*/, bool /*isRated*/, bool /*isPremade*/, uint32 /*arenaRating*/, uint32 arenaTeamId = 0);
         void RemovePlayer(ObjectGuid /*guid*/, bool /*decreaseInvitedCount*/);
         bool IsPlayerInvited(ObjectGuid /*playerGuid*/, const uint32 /*bgInstanceGuid*/, const uint32 /*removeTime*/);
@@ -114,6 +121,24 @@ class BattleGroundQueue
         */
         GroupsQueueType m_queuedGroups[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
 
+        // players of not yet invited groups per queue, lets Update skip brackets without anyone to match
+        uint32 m_waitingPlayers[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
+
+        // order keys handed out for front and back inserts, give queueOrder of the groups
+        int64 m_queueFrontOrder[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
+        int64 m_queueBackOrder[MAX_BATTLEGROUND_BRACKETS][BG_QUEUE_GROUP_TYPES_COUNT];
+
+        // not yet invited rated arena teams by rating, per premade (rated) queue
+        typedef std::multimap<uint32, GroupQueueInfo*> RatedGroupsIndex;
+        RatedGroupsIndex m_waitingRatedGroups[MAX_BATTLEGROUND_BRACKETS][PVP_TEAM_COUNT];
+
+        // all changes of m_queuedGroups go through these to keep the group position, counters and rating index in sync
+        void LinkGroup(GroupQueueInfo* /*group*/, BattleGroundBracketId /*bracketId*/, uint8 /*index*/, bool /*atFront*/);
+        void UnlinkGroup(GroupQueueInfo* /*group*/);
+        void MoveGroup(GroupQueueInfo* /*group*/, uint8 /*index*/);
+        void AddWaitingGroup(GroupQueueInfo* /*group*/);
+        void RemoveWaitingGroup(GroupQueueInfo* /*group*/);
+
         // class to select and invite groups to bg
         class SelectionPool
         {
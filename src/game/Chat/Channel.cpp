@@ -21,6 +21,7 @@
 #include "World/World.h"
 #include "Social/SocialMgr.h"
 #include "Chat/Chat.h"
+#include "Server/WorldSession.h"
 
 Channel::Channel(const std::string& name, uint32 channel_id/* = 0*/)
     : m_name(name)
@@ -736,16 +737,19 @@ void Channel::SendToOne(WorldPacket const& data, ObjectGuid receiver) const
 
 void Channel::SendToAll(WorldPacket const& data) const
 {
+    PacketBroadcast broadcast(data);
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
-        SendToOne(data, i->first);
+        if (Player* plr = sObjectMgr.GetPlayer(i->first))
+            broadcast.SendTo(plr->GetSession());
 }
 
 void Channel::SendMessage(WorldPacket const& data, ObjectGuid sender) const
 {
+    PacketBroadcast broadcast(data);
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
         if (Player* plr = sObjectMgr.GetPlayer(i->first))
             if (!sender || !plr->GetSocial()->HasIgnore(sender))
-                plr->GetSession()->SendPacket(data);
+                broadcast.SendTo(plr->GetSession());
 }
 
 void Channel::Voice(ObjectGuid /*guid1*/, ObjectGuid /*guid2*/) const
@@ -763,6 +763,14 @@ ChatCommand* ChatHandler::getCommandTable()
         { nullptr,             0,                  false, nullptr,                                           "", nullptr }
     };
 
+    static ChatCommand serverProfileCommandTable[] =
+    {
+        { "dump",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerProfileDumpCommand,   "", nullptr },
+        { "start",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerProfileStartCommand,  "", nullptr },
+        { "stop",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerProfileStopCommand,   "", nullptr },
+        { nullptr,             0,                  false, nullptr,                                           "", nullptr }
+    };
+
     static ChatCommand serverSetCommandTable[] =
     {
         { "motd",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerSetMotdCommand,       "", nullptr },
@@ -777,8 +785,10 @@ ChatCommand* ChatHandler::getCommandTable()
         { "idleshutdown",   SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverIdleShutdownCommandTable },
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", nullptr },
         { "log",            SEC_CONSOLE,        true,  nullptr,                                           "", serverLogCommandTable },
+        { "memory",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerMemoryCommand,        "", nullptr },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", nullptr },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", nullptr },
+        { "profile",        SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverProfileCommandTable },
         { "resetallraid",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerResetAllRaidCommand,  "", nullptr },
         { "restart",        SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverShutdownCommandTable },
@@ -54,8 +54,11 @@
 #include "AI/EventAI/CreatureEventAIMgr.h"
 #include "Server/DBCEnums.h"
 #include "Server/SQLStorages.h"
+#include "Server/QueryResponseCache.h"
 #include "Loot/LootMgr.h"
 #include "World/WorldState.h"
+#include "Metric/TickProfiler.h"
+#include "Memory/SlabPool.h"
 
 #ifdef BUILD_AHBOT
 #include "AuctionHouseBot/AuctionHouseBot.h"
@@ -331,6 +334,7 @@ bool ChatHandler::HandleReloadConfigCommand(char* /*args*/)
     sLog.outString("Re-Loading config settings...");
     sWorld.LoadConfigSettings(true);
     sMapMgr.InitializeVisibilityDistanceInfo();
+    sQueryResponseCache.InvalidateAll();                 // quest responses include rated money
     SendGlobalSysMessage("World config settings reloaded.");
     return true;
 }
@@ -463,6 +467,7 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Quest Templates...");
     sObjectMgr.LoadQuests();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_QUEST);
     SendGlobalSysMessage("DB table `quest_template` (quest definitions) reloaded.");
 
     /// dependent also from `gameobject` but this table not reloaded anyway
@@ -599,6 +604,7 @@ bool ChatHandler::HandleReloadNpcTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading `npc_text` Table!");
     sObjectMgr.LoadGossipText();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_NPC_TEXT);
     SendGlobalSysMessage("DB table `npc_text` reloaded.");
     return true;
 }
@@ -800,6 +806,7 @@ bool ChatHandler::HandleReloadPageTextsCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Page Texts...");
     sObjectMgr.LoadPageTexts();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_PAGE_TEXT);
     SendGlobalSysMessage("DB table `page_texts` reloaded.");
     return true;
 }
@@ -1063,6 +1070,7 @@ bool ChatHandler::HandleReloadLocalesCreatureCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Creature ...");
     sObjectMgr.LoadCreatureLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_CREATURE);
     SendGlobalSysMessage("DB table `locales_creature` reloaded.");
     return true;
 }
@@ -1071,6 +1079,7 @@ bool ChatHandler::HandleReloadLocalesGameobjectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Gameobject ... ");
     sObjectMgr.LoadGameObjectLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_GAMEOBJECT);
     SendGlobalSysMessage("DB table `locales_gameobject` reloaded.");
     return true;
 }
@@ -1087,6 +1096,7 @@ bool ChatHandler::HandleReloadLocalesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Item ... ");
     sObjectMgr.LoadItemLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_ITEM);
     SendGlobalSysMessage("DB table `locales_item` reloaded.");
     return true;
 }
@@ -1095,6 +1105,7 @@ bool ChatHandler::HandleReloadLocalesNpcTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales NPC Text ... ");
     sObjectMgr.LoadGossipTextLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_NPC_TEXT);
     SendGlobalSysMessage("DB table `locales_npc_text` reloaded.");
     return true;
 }
@@ -1103,6 +1114,7 @@ bool ChatHandler::HandleReloadLocalesPageTextCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Page Text ... ");
     sObjectMgr.LoadPageTextLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_PAGE_TEXT);
     SendGlobalSysMessage("DB table `locales_page_text` reloaded.");
     return true;
 }
@@ -1119,6 +1131,7 @@ bool ChatHandler::HandleReloadLocalesQuestCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Quest ... ");
     sObjectMgr.LoadQuestLocales();
+    sQueryResponseCache.Invalidate(QUERY_RESPONSE_QUEST);
     SendGlobalSysMessage("DB table `locales_quest` reloaded.");
     return true;
 }
@@ -4871,9 +4884,7 @@ bool ChatHandler::HandleResetAllCommand(char* args)
     }
 
     CharacterDatabase.PExecute("UPDATE characters SET at_login = at_login | '%u' WHERE (at_login & '%u') = '0'", atLogin, atLogin);
-    HashMapHolder<Player>::MapType const& plist = sObjectAccessor.GetPlayers();
-    for (const auto& itr : plist)
-        itr.second->SetAtLoginFlag(atLogin);
+    sObjectAccessor.ExecuteOnAllPlayers([atLogin](Player* player) { player->SetAtLoginFlag(atLogin); });
 
     return true;
 }
@@ -6000,6 +6011,80 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerMemoryCommand(char* /*args*/)
+{
+    std::vector<MaNGOS::SlabPoolStats> pools = MaNGOS::SlabPool::GetAllStats();
+    std::sort(pools.begin(), pools.end(), [](MaNGOS::SlabPoolStats const& a, MaNGOS::SlabPoolStats const& b) { return a.name < b.name; });
+
+    size_t totalReserved = 0;
+    SendSysMessage("Slab pools (block size, blocks in use / peak, reserved KB, allocations, larger than block):");
+    for (MaNGOS::SlabPoolStats const& pool : pools)
+    {
+        size_t reserved = pool.slabCount * pool.blocksPerSlab * pool.blockSize;
+        totalReserved += reserved;
+        PSendSysMessage("  %-16s " SIZEFMTD " B  " SIZEFMTD " / " SIZEFMTD "  " SIZEFMTD " KB  " UI64FMTD "  " UI64FMTD,
+                        pool.name.c_str(), pool.blockSize, pool.blocksInUse, pool.peakBlocksInUse, reserved / 1024,
+                        pool.totalAllocations, pool.fallbackAllocations);
+    }
+
+    PSendSysMessage("Total reserved by slab pools: " SIZEFMTD " KB", totalReserved / 1024);
+    return true;
+}
+
+bool ChatHandler::HandleServerProfileStartCommand(char* args)
+{
+    uint32 ringTicks;
+    if (!ExtractOptUInt32(&args, ringTicks, sWorld.getConfig(CONFIG_UINT32_PROFILER_RING_TICKS)) || !ringTicks)
+        return false;
+
+    sTickProfiler.Start(ringTicks);
+    PSendSysMessage("Tick profiler started, keeping the last %u world ticks.", ringTicks);
+    return true;
+}
+
+bool ChatHandler::HandleServerProfileStopCommand(char* /*args*/)
+{
+    sTickProfiler.Stop();
+    PSendSysMessage("Tick profiler stopped, %u recorded ticks kept for dump.", sTickProfiler.GetRecordedTicks());
+    return true;
+}
+
+bool ChatHandler::HandleServerProfileDumpCommand(char* args)
+{
+    std::string fileName;
+    if (char* name = ExtractQuotedOrLiteralArg(&args))
+    {
+        fileName = name;
+        // only plain file names, the dump always goes to the logs directory
+        if (fileName.find_first_of("/\\") != std::string::npos || fileName.find("..") != std::string::npos)
+        {
+            SendSysMessage("Profile dump file name must not contain a path.");
+            SetSentErrorMessage(true);
+            return false;
+        }
+    }
+    else
+        fileName = "tickprofile_" + std::to_string(uint64(sWorld.GetGameTime())) + ".folded";
+
+    fileName = sLog.GetLogsDir() + fileName;
+
+    int32 stacks = sTickProfiler.WriteFoldedStacks(fileName);
+    if (stacks < 0)
+    {
+        PSendSysMessage("Can't write profile dump to %s.", fileName.c_str());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Wrote %i stacks of %u ticks to %s.", stacks, sTickProfiler.GetRecordedTicks(), fileName.c_str());
+
+    SendSysMessage("Top frames by self time (self ms / total ms):");
+    for (MaNGOS::ProfileFrameStats const& frame : sTickProfiler.GetTopFrames(10))
+        PSendSysMessage("  %8.1f / %8.1f  %s", frame.selfTime / 1000.0, frame.totalTime / 1000.0, frame.name.c_str());
+
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
@@ -46,6 +46,10 @@
 #include "Grids/CellImpl.h"
 #include "Movement/MoveSplineInit.h"
 #include "Entities/CreatureLinkingMgr.h"
+#include "Metric/TickProfiler.h"
+#include "Memory/SlabPool.h"
+#include "Entities/TemporarySpawn.h"
+#include "Entities/Totem.h"
 
 // apply implementation of the singletons
 #include "Policies/Singleton.h"
@@ -132,6 +136,25 @@ bool CreatureCreatePos::Relocate(Creature* cr) const
     return true;
 }
 
+// Pools are intentionally never destroyed, objects may still be freed during static destruction at shutdown
+// pets are larger than the block and use the global allocator
+static MaNGOS::SlabPool& GetCreaturePool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("Creature",
+        std::max({ sizeof(Creature), sizeof(TemporarySpawn), sizeof(TemporarySpawnWaypoint), sizeof(Totem) }));
+    return *pool;
+}
+
+void* Creature::operator new(size_t size)
+{
+    return GetCreaturePool().Allocate(size);
+}
+
+void Creature::operator delete(void* ptr, size_t size)
+{
+    GetCreaturePool().Deallocate(ptr, size);
+}
+
 Creature::Creature(CreatureSubtype subtype) : Unit(),
     m_lootMoney(0), m_lootGroupRecipientId(0),
     m_lootStatus(CREATURE_LOOT_STATUS_NONE),
@@ -611,6 +634,8 @@ uint32 Creature::ChooseDisplayId(const CreatureInfo* cinfo, const CreatureData*
 
 void Creature::Update(const uint32 diff)
 {
+    PROFILE_SCOPE("Creature", GetEntry(), GetName());
+
     switch (m_deathState)
     {
         case JUST_ALIVED:
@@ -662,6 +687,8 @@ void Creature::Update(const uint32 diff)
                 if (uint16 poolid = sPoolMgr.IsPartOfAPool<Creature>(GetGUIDLow()))
                     sPoolMgr.UpdatePool<Creature>(*GetMap()->GetPersistentState(), poolid, GetGUIDLow());
             }
+            else if (m_respawnTime > time(nullptr))
+                GetMap()->ScheduleRespawn(this, m_respawnTime); // nothing to do until then, left out of the map update
             break;
         }
         case CORPSE:
@@ -1690,6 +1717,8 @@ void Creature::DeleteFromDB(uint32 lowguid, CreatureData const* data)
 
 void Creature::SetDeathState(DeathState s)
 {
+    SetWaitingRespawn(false);
+
     if ((s == JUST_DIED && !m_isDeadByDefault) || (s == JUST_ALIVED && m_isDeadByDefault))
     {
         if (!m_respawnOverriden)
@@ -1763,6 +1792,7 @@ void Creature::Respawn()
         if (HasStaticDBSpawnData())
             GetMap()->GetPersistentState()->SaveCreatureRespawnTime(GetGUIDLow(), 0);
         m_respawnTime = time(nullptr);                         // respawn at next tick
+        SetWaitingRespawn(false);
     }
 }
 
@@ -589,6 +589,10 @@ class Creature : public Unit
         explicit Creature(CreatureSubtype subtype = CREATURE_SUBTYPE_GENERIC);
         virtual ~Creature();
 
+        // creatures are allocated from a dedicated slab pool, see Creature.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
         virtual void CleanupsBeforeDelete() override;
@@ -786,7 +790,7 @@ class Creature : public Unit
 
         time_t const& GetRespawnTime() const { return m_respawnTime; }
         time_t GetRespawnTimeEx() const;
-        void SetRespawnTime(uint32 respawn) { m_respawnTime = respawn ? time(nullptr) + respawn : 0; }
+        void SetRespawnTime(uint32 respawn) { m_respawnTime = respawn ? time(nullptr) + respawn : 0; SetWaitingRespawn(false); }
         void Respawn();
         void SaveRespawnTime() override;
 
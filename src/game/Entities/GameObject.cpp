@@ -40,6 +40,8 @@
 #include "Vmap/GameObjectModel.h"
 #include "Server/SQLStorages.h"
 #include "World/WorldState.h"
+#include "Metric/TickProfiler.h"
+#include "Memory/SlabPool.h"
 #include <G3D/Box.h>
 #include <G3D/CoordinateFrame.h>
 #include <G3D/Quat.h>
@@ -62,6 +64,24 @@ QuaternionData QuaternionData::fromEulerAnglesZYX(float Z, float Y, float X)
 
 #include <G3D/Quat.h>
 
+// Pools are intentionally never destroyed, objects may still be freed during static destruction at shutdown
+// transports are larger than the block and use the global allocator
+static MaNGOS::SlabPool& GetGameObjectPool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("GameObject", sizeof(GameObject));
+    return *pool;
+}
+
+void* GameObject::operator new(size_t size)
+{
+    return GetGameObjectPool().Allocate(size);
+}
+
+void GameObject::operator delete(void* ptr, size_t size)
+{
+    GetGameObjectPool().Deallocate(ptr, size);
+}
+
 GameObject::GameObject() : WorldObject(),
     m_model(nullptr),
     m_captureSlider(0),
@@ -268,6 +288,8 @@ bool GameObject::Create(uint32 guidlow, uint32 name_id, Map* map, uint32 phaseMa
 
 void GameObject::Update(const uint32 diff)
 {
+    PROFILE_SCOPE("GameObject", GetEntry(), GetName());
+
     if (GetObjectGuid().IsMOTransport())
     {
         //((Transport*)this)->Update(p_time);
@@ -394,6 +416,12 @@ void GameObject::Update(const uint32 diff)
                             break;
                     }
                 }
+                else if (!IsSpawned())
+                {
+                    // nothing to do while despawned, left out of the map update until the respawn time
+                    GetMap()->ScheduleRespawn(this, m_respawnTime);
+                    break;
+                }
             }
 
             if (IsSpawned())
@@ -1056,6 +1084,7 @@ void GameObject::Respawn()
     if (m_spawnedByDefault && m_respawnTime > 0)
     {
         m_respawnTime = time(nullptr);
+        SetWaitingRespawn(false);
         GetMap()->GetPersistentState()->SaveGORespawnTime(GetGUIDLow(), 0);
     }
 }
@@ -1994,6 +2023,7 @@ void GameObject::SetWorldRotationAngles(float z_rot, float y_rot, float x_rot)
 void GameObject::SetLootState(LootState state)
 {
     m_lootState = state;
+    SetWaitingRespawn(false);
     UpdateCollisionState();
 
     // Call for GameObjectAI script
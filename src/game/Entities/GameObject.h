@@ -712,6 +712,10 @@ class GameObject : public WorldObject
         explicit GameObject();
         ~GameObject();
 
+        // gameobjects are allocated from a dedicated slab pool, see GameObject.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         void AddToWorld() override;
         void RemoveFromWorld() override;
 
@@ -766,6 +770,7 @@ class GameObject : public WorldObject
         {
             m_respawnTime = respawn > 0 ? time(nullptr) + respawn : 0;
             m_respawnDelay = respawn > 0 ? uint32(respawn) : 0;
+            SetWaitingRespawn(false);
         }
         void Respawn();
         bool IsSpawned() const
@@ -22,6 +22,7 @@
 #include "Server/Opcodes.h"
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
+#include "Server/QueryResponseCache.h"
 #include "Tools/Formulas.h"
 
 GossipMenu::GossipMenu(WorldSession* session) : m_session(session)
@@ -464,6 +465,13 @@ void PlayerMenu::SendQuestGiverQuestDetails(Quest const* pQuest, ObjectGuid guid
 // send only static data in this packet!
 void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
 {
+    int loc_idx = GetMenuSession()->GetSessionDbLocaleIndex();
+    if (QueryResponsePacket cached = sQueryResponseCache.Find(QUERY_RESPONSE_QUEST, pQuest->GetQuestId(), loc_idx))
+    {
+        GetMenuSession()->SendPacket(cached);
+        return;
+    }
+
     std::string ObjectiveText[QUEST_OBJECTIVES_COUNT];
     std::string Title = pQuest->GetTitle();
     std::string Details = pQuest->GetDetails();
@@ -474,7 +482,6 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
     for (int i = 0; i < QUEST_OBJECTIVES_COUNT; ++i)
         ObjectiveText[i] = pQuest->ObjectiveText[i];
 
-    int loc_idx = GetMenuSession()->GetSessionDbLocaleIndex();
     if (loc_idx >= 0)
     {
         if (QuestLocale const* ql = sObjectMgr.GetQuestLocale(pQuest->GetQuestId()))
@@ -606,6 +613,7 @@ void PlayerMenu::SendQuestQueryResponse(Quest const* pQuest) const
     for (iI = 0; iI < QUEST_OBJECTIVES_COUNT; ++iI)
         data << ObjectiveText[iI];
 
+    sQueryResponseCache.Store(QUERY_RESPONSE_QUEST, pQuest->GetQuestId(), loc_idx, data);
     GetMenuSession()->SendPacket(data);
 
     DEBUG_LOG("WORLD: Sent SMSG_QUEST_QUERY_RESPONSE questid=%u", pQuest->GetQuestId());
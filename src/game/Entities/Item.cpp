@@ -26,6 +26,8 @@
 #include "Loot/LootMgr.h"
 #include "Spells/SpellTargetDefines.h"
 #include "Spells/SpellEffectDefines.h"
+#include "Entities/Bag.h"
+#include "Memory/SlabPool.h"
 
 void AddItemsSetItem(Player* player, Item* item)
 {
@@ -233,6 +235,23 @@ bool ItemCanGoIntoBag(ItemPrototype const* pProto, ItemPrototype const* pBagProt
     return false;
 }
 
+// Pools are intentionally never destroyed, objects may still be freed during static destruction at shutdown
+static MaNGOS::SlabPool& GetItemPool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("Item", std::max(sizeof(Item), sizeof(Bag)));
+    return *pool;
+}
+
+void* Item::operator new(size_t size)
+{
+    return GetItemPool().Allocate(size);
+}
+
+void Item::operator delete(void* ptr, size_t size)
+{
+    GetItemPool().Deallocate(ptr, size);
+}
+
 Item::Item()
 {
     m_objectType |= TYPEMASK_ITEM;
@@ -277,6 +277,10 @@ class Item : public Object
 
         Item();
 
+        // items are allocated from a dedicated slab pool, see Item.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         virtual bool Create(uint32 guidlow, uint32 itemid, Player const* owner);
 
         ItemPrototype const* GetProto() const;
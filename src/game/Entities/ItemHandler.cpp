@@ -20,6 +20,7 @@
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
 #include "Server/Opcodes.h"
+#include "Server/QueryResponseCache.h"
 #include "Log.h"
 #include "Globals/ObjectMgr.h"
 #include "Entities/Player.h"
@@ -290,6 +291,11 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
     if (pProto)
     {
         int loc_idx = GetSessionDbLocaleIndex();
+        if (QueryResponsePacket cached = sQueryResponseCache.Find(QUERY_RESPONSE_ITEM, item, loc_idx))
+        {
+            SendPacket(cached);
+            return;
+        }
 
         std::string name = pProto->Name1;
         std::string description = pProto->Description;
@@ -422,6 +428,7 @@ void WorldSession::HandleItemQuerySingleOpcode(WorldPacket& recv_data)
         data << uint32(pProto->Duration);                   // added in 2.4.2.8209, duration (seconds)
         data << uint32(pProto->ItemLimitCategory);          // WotLK, ItemLimitCategory
         data << uint32(pProto->HolidayId);                  // Holiday.dbc?
+        sQueryResponseCache.Store(QUERY_RESPONSE_ITEM, item, loc_idx, data);
         SendPacket(data);
     }
     else
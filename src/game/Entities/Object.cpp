@@ -1174,7 +1174,7 @@ void Object::ForceValuesUpdateAtIndex(uint16 index)
 WorldObject::WorldObject() :
     m_transportInfo(nullptr), m_isOnEventNotified(false),
     m_currMap(nullptr), m_mapId(0),
-    m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_isActiveObject(false), m_visibilityData(this),
+    m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_isActiveObject(false), m_waitingRespawn(false), m_lastUpdateClock(0), m_visibilityData(this),
     m_debugFlags(0)
 {
 }
@@ -879,6 +879,14 @@ class WorldObject : public Object
         bool isActiveObject() const { return m_isActiveObject || m_viewPoint.hasViewers(); }
         void SetActiveObjectState(bool active);
 
+        // dead or despawned object left out of the map update until its respawn time, see Map::ScheduleRespawn
+        bool IsWaitingRespawn() const { return m_waitingRespawn; }
+        void SetWaitingRespawn(bool waiting) { m_waitingRespawn = waiting; }
+
+        // map update clock of the last object update, lets Map::Update give cells around idle players only the time not yet updated
+        uint32 GetLastUpdateClock() const { return m_lastUpdateClock; }
+        void SetLastUpdateClock(uint32 clock) { m_lastUpdateClock = clock; }
+
         ViewPoint& GetViewPoint() { return m_viewPoint; }
 
         // ASSERT print helper
@@ -956,6 +964,8 @@ class WorldObject : public Object
         Position m_position;
         ViewPoint m_viewPoint;
         bool m_isActiveObject;
+        bool m_waitingRespawn;
+        uint32 m_lastUpdateClock;
         uint64 m_debugFlags;
 };
 
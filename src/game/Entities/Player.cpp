@@ -58,12 +58,14 @@
 #include "Spells/Spell.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "Social/SocialMgr.h"
+#include "Social/WhoListIndex.h"
 #include "Achievements/AchievementMgr.h"
 #include "Mails/Mail.h"
 #include "Spells/SpellAuras.h"
 #include "Server/DBCStores.h"
 #include "Server/SQLStorages.h"
 #include "Entities/Vehicle.h"
+#include "Metric/TickProfiler.h"
 #include "Calendar/Calendar.h"
 #include "Loot/LootMgr.h"
 #include "World/WorldStateDefines.h"
@@ -1404,6 +1406,8 @@ void Player::Update(const uint32 diff)
     if (!IsInWorld())
         return;
 
+    PROFILE_SCOPE("Player::Update");
+
     // Remove failed timed Achievements
     GetAchievementMgr().DoFailedTimedAchievementCriterias();
 
@@ -7271,6 +7275,12 @@ void Player::ModifyArenaPoints(int32 value)
     SetArenaPoints(newValue);
 }
 
+void Player::SetInGuild(uint32 GuildId)
+{
+    SetUInt32Value(PLAYER_GUILDID, GuildId);
+    sWhoListIndex.UpdateGuild(this, GuildId);
+}
+
 uint32 Player::GetGuildIdFromDB(ObjectGuid guid)
 {
     uint32 lowguid = guid.GetCounter();
@@ -7437,6 +7447,9 @@ void Player::UpdateZone(uint32 newZone, uint32 newArea, bool force)
         sWorldState.HandlePlayerEnterArea(this, newArea);
     }
 
+    if (m_zoneUpdateId != newZone)
+        sWhoListIndex.UpdateZone(this, newZone);
+
     m_zoneUpdateId    = newZone;
     m_zoneUpdateTimer = ZONE_UPDATE_INTERVAL;
 
@@ -21056,10 +21069,13 @@ void Player::SendAurasForTarget(Unit* target) const
     WorldPacket data(SMSG_AURA_UPDATE_ALL);
     data << target->GetPackGUID();
 
-    Unit::VisibleAuraMap const& visibleAuras = target->GetVisibleAuras();
-    for (const auto& visibleAura : visibleAuras)
+    for (uint8 slot = 0; slot < MAX_AURAS; ++slot)
     {
-        SpellAuraHolderConstBounds bounds = target->GetSpellAuraHolderBounds(visibleAura.second);
+        uint32 spellId = target->GetVisibleAura(slot);
+        if (!spellId)
+            continue;
+
+        SpellAuraHolderConstBounds bounds = target->GetSpellAuraHolderBounds(spellId);
         for (SpellAuraHolderMap::const_iterator iter = bounds.first; iter != bounds.second; ++iter)
             iter->second->BuildUpdatePacket(data);
     }
@@ -30,6 +30,7 @@
 #include "Entities/Player.h"
 #include "Entities/NPCHandler.h"
 #include "Server/SQLStorages.h"
+#include "Server/QueryResponseCache.h"
 #include "Maps/GridDefines.h"
 
 void WorldSession::SendNameQueryResponse(CharacterNameQueryResponse& response) const
@@ -193,6 +194,11 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
     if (ci)
     {
         int loc_idx = GetSessionDbLocaleIndex();
+        if (QueryResponsePacket cached = sQueryResponseCache.Find(QUERY_RESPONSE_CREATURE, entry, loc_idx))
+        {
+            SendPacket(cached);
+            return;
+        }
 
         char const* name = ci->Name;
         char const* subName = ci->SubName;
@@ -222,6 +228,7 @@ void WorldSession::HandleCreatureQueryOpcode(WorldPacket& recv_data)
         for (unsigned int QuestItem : ci->QuestItems)
             data << uint32(QuestItem);              // itemId[6], quest drop
         data << uint32(ci->MovementTemplateId);             // CreatureMovementInfo.dbc
+        sQueryResponseCache.Store(QUERY_RESPONSE_CREATURE, entry, loc_idx, data);
         SendPacket(data);
         DEBUG_LOG("WORLD: Sent SMSG_CREATURE_QUERY_RESPONSE");
     }
@@ -247,11 +254,17 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
     const GameObjectInfo* info = ObjectMgr::GetGameObjectInfo(entryID);
     if (info)
     {
+        int loc_idx = GetSessionDbLocaleIndex();
+        if (QueryResponsePacket cached = sQueryResponseCache.Find(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx))
+        {
+            SendPacket(cached);
+            return;
+        }
+
         std::string Name = info->name;
         std::string IconName = info->IconName;
         std::string CastBarCaption = info->castBarCaption;
 
-        int loc_idx = GetSessionDbLocaleIndex();
         if (loc_idx >= 0)
         {
             GameObjectLocale const* gl = sObjectMgr.GetGameObjectLocale(entryID);
@@ -277,6 +290,7 @@ void WorldSession::HandleGameObjectQueryOpcode(WorldPacket& recv_data)
         data << float(info->size);                          // go size
         for (unsigned int questItem : info->questItems)
             data << uint32(questItem);            // itemId[6], quest drop
+        sQueryResponseCache.Store(QUERY_RESPONSE_GAMEOBJECT, entryID, loc_idx, data);
         SendPacket(data);
         DEBUG_LOG("WORLD: Sent SMSG_GAMEOBJECT_QUERY_RESPONSE");
     }
@@ -354,6 +368,16 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
 
     GossipText const* gossip = sObjectMgr.GetGossipText(textID);
 
+    int loc_idx = GetSessionDbLocaleIndex();
+    if (gossip)
+    {
+        if (QueryResponsePacket cached = sQueryResponseCache.Find(QUERY_RESPONSE_NPC_TEXT, textID, loc_idx))
+        {
+            SendPacket(cached);
+            return;
+        }
+    }
+
     WorldPacket data(SMSG_NPC_TEXT_UPDATE, 100);            // guess size
     data << textID;
 
@@ -377,7 +401,6 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
     {
         std::string Text_0[MAX_GOSSIP_TEXT_OPTIONS], Text_1[MAX_GOSSIP_TEXT_OPTIONS];
         bool locales = true;
-        int loc_idx = GetSessionDbLocaleIndex();
         for (int i = 0; i < MAX_GOSSIP_TEXT_OPTIONS; ++i)
         {
             if (gossip->Options[i].broadcastTextId)
@@ -418,6 +441,8 @@ void WorldSession::HandleNpcTextQueryOpcode(WorldPacket& recv_data)
                 data << Emote._Emote;
             }
         }
+
+        sQueryResponseCache.Store(QUERY_RESPONSE_NPC_TEXT, textID, loc_idx, data);
     }
 
     SendPacket(data);
@@ -434,9 +459,21 @@ void WorldSession::HandlePageTextQueryOpcode(WorldPacket& recv_data)
     recv_data >> pageID;
     recv_data.read_skip<uint64>();                          // guid
 
+    int loc_idx = GetSessionDbLocaleIndex();
+
     while (pageID)
     {
         PageText const* pPage = sPageTextStore.LookupEntry<PageText>(pageID);
+        if (pPage)
+        {
+            if (QueryResponsePacket cached = sQueryResponseCache.Find(QUERY_RESPONSE_PAGE_TEXT, pageID, loc_idx))
+            {
+                SendPacket(cached);
+                pageID = pPage->Next_Page;
+                continue;
+            }
+        }
+
         // guess size
         WorldPacket data(SMSG_PAGE_TEXT_QUERY_RESPONSE, 50);
         data << pageID;
@@ -451,7 +488,6 @@ void WorldSession::HandlePageTextQueryOpcode(WorldPacket& recv_data)
         {
             std::string Text = pPage->Text;
 
-            int loc_idx = GetSessionDbLocaleIndex();
             if (loc_idx >= 0)
             {
                 PageTextLocale const* pl = sObjectMgr.GetPageTextLocale(pageID);
@@ -464,6 +500,7 @@ void WorldSession::HandlePageTextQueryOpcode(WorldPacket& recv_data)
 
             data << Text;
             data << uint32(pPage->Next_Page);
+            sQueryResponseCache.Store(QUERY_RESPONSE_PAGE_TEXT, pageID, loc_idx, data);
             pageID = pPage->Next_Page;
         }
         SendPacket(data);
@@ -110,6 +110,7 @@ void MapManager::LoadTransports()
 
         // If we someday decide to use the grid to track transports, here:
         t->SetMap(sMapMgr.CreateMap(mapid, t));
+        t->GetMap()->AddTransport(t);
 
         // t->GetMap()->Add<GameObject>((GameObject *)t);
         ++count;
@@ -440,7 +441,7 @@ void Transport::MoveToNextWayPoint()
 
 void Transport::TeleportTransport(uint32 newMapid, float x, float y, float z)
 {
-    Map const* oldMap = GetMap();
+    Map* oldMap = GetMap();
     Relocate(x, y, z);
 
     for (PlayerSet::iterator itr = m_passengers.begin(); itr != m_passengers.end();)
@@ -474,6 +475,9 @@ void Transport::TeleportTransport(uint32 newMapid, float x, float y, float z)
 
     if (oldMap != newMap)
     {
+        oldMap->RemoveTransport(this);
+        newMap->AddTransport(this);
+
         UpdateForMap(oldMap);
         UpdateForMap(newMap);
     }
@@ -511,15 +515,15 @@ void Transport::Update(const uint32 /*diff*/)
         DoEventIfAny(*m_curr, false);
 
         // first check help in case client-server transport coordinates de-synchronization
+        // the teleport is done by the world thread after the map updates, the remaining nodes follow with the next update
         if (m_curr->second.mapid != GetMapId() || m_curr->second.teleport)
         {
-            TeleportTransport(m_curr->second.mapid, m_curr->second.x, m_curr->second.y, m_curr->second.z);
-        }
-        else
-        {
-            Relocate(m_curr->second.x, m_curr->second.y, m_curr->second.z);
+            sMapMgr.ScheduleTransportHandoff(this);
+            return;
         }
 
+        Relocate(m_curr->second.x, m_curr->second.y, m_curr->second.z);
+
         /*
         for(PlayerSet::const_iterator itr = m_passengers.begin(); itr != m_passengers.end();)
         {
@@ -538,6 +542,15 @@ void Transport::Update(const uint32 /*diff*/)
     }
 }
 
+void Transport::FinishMapHandoff()
+{
+    TeleportTransport(m_curr->second.mapid, m_curr->second.x, m_curr->second.y, m_curr->second.z);
+
+    m_nextNodeTime = m_curr->first;
+
+    DETAIL_FILTER_LOG(LOG_FILTER_TRANSPORT_MOVES, "%s moved to %f %f %f %d", GetName(), m_curr->second.x, m_curr->second.y, m_curr->second.z, m_curr->second.mapid);
+}
+
 void Transport::UpdateForMap(Map const* targetMap)
 {
     Map::PlayerList const& pl = targetMap->GetPlayers();
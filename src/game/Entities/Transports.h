@@ -35,6 +35,9 @@ class Transport : public GameObject
         bool AddPassenger(Player* passenger);
         bool RemovePassenger(Player* passenger);
 
+        // world thread, completes the map change found by Update
+        void FinishMapHandoff();
+
         typedef std::set<Player*> PlayerSet;
         PlayerSet const& GetPassengers() const { return m_passengers; }
 
@@ -50,6 +50,9 @@
 #include "Entities/CreatureLinkingMgr.h"
 #include "Tools/Formulas.h"
 #include "Metric/Metric.h"
+#include "Metric/TickProfiler.h"
+#include "Social/WhoListIndex.h"
+#include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 
 #include <math.h>
 #include <limits>
@@ -266,6 +269,9 @@ Unit::Unit() :
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
     m_AuraFlags = 0;
 
+    memset(m_visibleAuras, 0, sizeof(m_visibleAuras));
+    m_visibleAuraSlots = 0;
+
     m_Visibility = VISIBILITY_ON;
     m_AINotifyEvent = nullptr;
 
@@ -370,11 +376,11 @@ void Unit::Update(const uint32 diff)
         return;
 
     metric::duration<std::chrono::microseconds> meas("unit.update", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
+        { "entry", GetEntry() },
+        { "guid", GetGUIDLow() },
+        { "unit_type", GetGUIDHigh() },
+        { "map_id", GetMapId() },
+        { "instance_id", GetInstanceId() }
     }, 1000);
 
     /*if(p_time > m_AurasCheck)
@@ -433,13 +439,17 @@ void Unit::Update(const uint32 diff)
     if (AI() && IsAlive())
     {
         metric::duration<std::chrono::microseconds> meas_ai("unit.update.ai", {
-            { "entry", std::to_string(GetEntry()) },
-            { "guid", std::to_string(GetGUIDLow()) },
-            { "unit_type", std::to_string(GetGUIDHigh()) },
-            { "map_id", std::to_string(GetMapId()) },
-            { "instance_id", std::to_string(GetInstanceId()) }
+            { "entry", GetEntry() },
+            { "guid", GetGUIDLow() },
+            { "unit_type", GetGUIDHigh() },
+            { "map_id", GetMapId() },
+            { "instance_id", GetInstanceId() }
         }, 1000);
 
+        // creature AIs are also reported by script, so a script shared by several entries adds up
+        uint32 scriptId = (MaNGOS::TickProfiler::IsEnabled() && GetTypeId() == TYPEID_UNIT) ? static_cast<Creature*>(this)->GetScriptId() : 0;
+        PROFILE_SCOPE("AI", scriptId, sScriptDevAIMgr.GetScriptName(scriptId));
+
         AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
     }
 
@@ -2579,9 +2589,9 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
             incanterAbsorption += currentAbsorb;
 
         // Reduce shield amount
-        mod->m_amount -= currentAbsorb;
+        (*i)->SetAmount(mod->m_amount - currentAbsorb);
         if ((*i)->GetHolder()->DropAuraCharge())
-            mod->m_amount = 0;
+            (*i)->SetAmount(0);
         // Need remove it later
         if (mod->m_amount <= 0)
             existExpired = true;
@@ -2644,7 +2654,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* caster, SpellSchoolMask schoolMa
 
         (*i)->OnManaAbsorb(currentAbsorb);
 
-        (*i)->GetModifier()->m_amount -= currentAbsorb;
+        (*i)->SetAmount((*i)->GetModifier()->m_amount - currentAbsorb);
         if ((*i)->GetModifier()->m_amount <= 0)
         {
             RemoveAurasDueToSpell((*i)->GetId());
@@ -2851,9 +2861,9 @@ void Unit::CalculateHealAbsorb(const uint32 heal, uint32* absorb)
         RemainingHeal -= currentAbsorb;
 
         // Reduce aura amount
-        mod->m_amount -= currentAbsorb;
+        (*i)->SetAmount(mod->m_amount - currentAbsorb);
         if ((*i)->GetHolder()->DropAuraCharge())
-            mod->m_amount = 0;
+            (*i)->SetAmount(0);
         // Need remove it later
         if (mod->m_amount <= 0)
             existExpired = true;
@@ -5033,50 +5043,53 @@ void Unit::DeMorph()
     SetDisplayId(GetNativeDisplayId());
 }
 
-int32 Unit::GetTotalAuraModifier(AuraType auratype) const
+Unit::AuraModifierTotals const& Unit::GetAuraModifierTotals(AuraType auratype) const
 {
-    int32 modifier = 0;
+    static AuraModifierTotals const emptyTotals = { SPELL_AURA_NONE, 0, 1.0f, 0, 0 };
 
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
+    if (mTotalAuraList.empty())
+        return emptyTotals;
+
+    // only types with applied auras are cached, so the table stays a handful of entries long
+    for (AuraModifierTotals const& totals : m_auraModifierTotals)
+        if (totals.type == auratype)
+            return totals;
+
+    AuraModifierTotals totals = { auratype, 0, 1.0f, 0, 0 };
     for (auto i : mTotalAuraList)
-        modifier += i->GetModifier()->m_amount;
+    {
+        int32 amount = i->GetModifier()->m_amount;
+        totals.total += amount;
+        totals.multiplier *= (100.0f + amount) / 100.0f;
+        if (amount > totals.maxPositive)
+            totals.maxPositive = amount;
+        if (amount < totals.maxNegative)
+            totals.maxNegative = amount;
+    }
 
-    return modifier;
+    m_auraModifierTotals.push_back(totals);
+    return m_auraModifierTotals.back();
 }
 
-float Unit::GetTotalAuraMultiplier(AuraType auratype) const
+int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        multiplier *= (100.0f + i->GetModifier()->m_amount) / 100.0f;
+    return GetAuraModifierTotals(auratype).total;
+}
 
-    return multiplier;
+float Unit::GetTotalAuraMultiplier(AuraType auratype) const
+{
+    return GetAuraModifierTotals(auratype).multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        if (i->GetModifier()->m_amount > modifier)
-            modifier = i->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAuraModifierTotals(auratype).maxPositive;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (auto i : mTotalAuraList)
-        if (i->GetModifier()->m_amount < modifier)
-            modifier = i->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAuraModifierTotals(auratype).maxNegative;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -5284,7 +5297,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
                                     int32 remainingTicks = existing->GetAuraMaxTicks() - existing->GetAuraTicks();
                                     int32 remainingDamage = existing->GetModifier()->m_amount * remainingTicks;
 
-                                    aur->GetModifier()->m_amount += int32(remainingDamage / aur->GetAuraMaxTicks());
+                                    aur->SetAmount(aur->GetModifier()->m_amount + int32(remainingDamage / aur->GetAuraMaxTicks()));
                                 }
                                 else
                                     DEBUG_LOG("Holder (spell %u) on target (lowguid: %u) doesn't have aura on effect index %u. skipping.", aurSpellInfo->Id, holder->GetTarget()->GetGUIDLow(), i);
@@ -5455,10 +5468,36 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     return true;
 }
 
+uint8 Unit::GetVisibleAurasCount() const
+{
+    uint8 count = 0;
+    for (uint64 slots = m_visibleAuraSlots; slots; slots &= slots - 1)
+        ++count;
+    return count;
+}
+
+uint8 Unit::GetFreeVisibleAuraSlot() const
+{
+    uint64 freeSlots = ~m_visibleAuraSlots;
+    if (MAX_AURAS < 64)
+        freeSlots &= (uint64(1) << (MAX_AURAS % 64)) - 1;
+
+    if (!freeSlots)
+        return NULL_AURA_SLOT;
+
+    uint8 slot = 0;
+    while (!(freeSlots & (uint64(1) << slot)))
+        ++slot;
+    return slot;
+}
+
 void Unit::AddAuraToModList(Aura* aura)
 {
     if (aura->GetModifier()->m_auraname < TOTAL_AURAS)
+    {
         m_modAuras[aura->GetModifier()->m_auraname].push_back(aura);
+        InvalidateAuraModifierTotals();
+    }
 }
 
 void Unit::RemoveRankAurasDueToSpell(uint32 spellId)
@@ -6126,6 +6165,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        InvalidateAuraModifierTotals();
     }
 
     // Set remove mode
@@ -9748,6 +9788,7 @@ void Unit::UpdateVisibilityAndView()
             if (!owner || !IsVisibleForOrDetect(owner, this, false))
             {
                 alist.erase(it);
+                InvalidateAuraModifierTotals();
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -10728,9 +10769,14 @@ void Unit::SetLevel(uint32 lvl)
 {
     SetUInt32Value(UNIT_FIELD_LEVEL, lvl);
 
-    // group update
-    if ((GetTypeId() == TYPEID_PLAYER) && ((Player*)this)->GetGroup())
-        ((Player*)this)->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        // group update
+        if (((Player*)this)->GetGroup())
+            ((Player*)this)->SetGroupUpdateFlag(GROUP_UPDATE_FLAG_LEVEL);
+
+        sWhoListIndex.UpdateLevel((Player*)this, lvl);
+    }
 }
 
 void Unit::SetHealth(uint32 val)
@@ -10881,6 +10927,8 @@ void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
         tAuraProcTriggerDamage.push_back(aura);
     else
         tAuraProcTriggerDamage.remove(aura);
+
+    InvalidateAuraModifierTotals();
 }
 
 uint32 Unit::GetCreatePowers(Powers power) const
@@ -12658,11 +12706,11 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
         return;
 
     metric::duration<std::chrono::microseconds> meas("unit.updatesplinemovement", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
+        { "entry", GetEntry() },
+        { "guid", GetGUIDLow() },
+        { "unit_type", GetGUIDHigh() },
+        { "map_id", GetMapId() },
+        { "instance_id", GetInstanceId() }
     }, 1000);
 
     movespline->updateState(t_diff);
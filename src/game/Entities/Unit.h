@@ -1322,7 +1322,6 @@ class Unit : public WorldObject
         typedef std::list<Aura*> AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
-        typedef std::map<uint8 /*slot*/, uint32 /*spellId*/> VisibleAuraMap;
         typedef std::map<SpellEntry const*, ObjectGuid /*targetGuid*/> TrackedAuraTargetMap;
 
         virtual ~Unit();
@@ -2308,22 +2307,22 @@ class Unit : public WorldObject
         void TriggerEvadeEvents();
         void EvadeTimerExpired();
 
-        uint32 GetVisibleAura(uint8 slot) const
-        {
-            VisibleAuraMap::const_iterator itr = m_visibleAuras.find(slot);
-            if (itr != m_visibleAuras.end())
-                return itr->second;
-            return 0;
-        }
+        uint32 GetVisibleAura(uint8 slot) const { return slot < MAX_AURAS ? m_visibleAuras[slot] : 0; }
         void SetVisibleAura(uint8 slot, uint32 spellid)
         {
+            if (slot >= MAX_AURAS)
+                return;
+
+            uint64 const slotMask = uint64(1) << slot;
             if (spellid == 0)
-                m_visibleAuras.erase(slot);
+                m_visibleAuraSlots &= ~slotMask;
             else
-                m_visibleAuras[slot] = spellid;
+                m_visibleAuraSlots |= slotMask;
+            m_visibleAuras[slot] = spellid;
         }
-        VisibleAuraMap const& GetVisibleAuras() const { return m_visibleAuras; }
-        uint8 GetVisibleAurasCount() const { return m_visibleAuras.size(); }
+        uint8 GetVisibleAurasCount() const;
+        uint8 GetFreeVisibleAuraSlot() const;               // NULL_AURA_SLOT if all slots are used
+        uint64 GetVisibleAuraSlotsMask() const { return m_visibleAuraSlots; }
 
         Aura* GetAura(uint32 spellId, SpellEffectIndex effindex);
         Aura* GetAura(AuraType type, SpellFamily family, uint64 familyFlag, uint32 familyFlag2 = 0, ObjectGuid casterGuid = ObjectGuid()) const;
@@ -2336,6 +2335,9 @@ class Unit : public WorldObject
         AuraList const& GetAurasByType(AuraType type) const { return m_modAuras[type]; }
         void ApplyAuraProcTriggerDamage(Aura* aura, bool apply);
 
+        // called by Aura::SetAmount and whenever the aura lists change
+        void InvalidateAuraModifierTotals() { m_auraModifierTotals.clear(); }
+
         int32 GetTotalAuraModifier(AuraType auratype) const;
         float GetTotalAuraMultiplier(AuraType auratype) const;
         int32 GetMaxPositiveAuraModifier(AuraType auratype) const;
@@ -2702,13 +2704,27 @@ class Unit : public WorldObject
         uint32 m_transform;
 
         AuraList m_modAuras[TOTAL_AURAS];
+
+        // aggregated modifiers of m_modAuras types, computed on first request and dropped on any aura list or amount change
+        struct AuraModifierTotals
+        {
+            AuraType type;
+            int32 total;
+            float multiplier;
+            int32 maxPositive;
+            int32 maxNegative;
+        };
+        AuraModifierTotals const& GetAuraModifierTotals(AuraType auratype) const;
+        mutable std::vector<AuraModifierTotals> m_auraModifierTotals;
+
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
 
         WeaponDamageInfo m_weaponDamageInfo;
 
         bool m_canModifyStats;
         // std::list< spellEffectPair > AuraSpells[TOTAL_AURAS];  // TODO: use this if ok for mem
-        VisibleAuraMap m_visibleAuras;
+        uint32 m_visibleAuras[MAX_AURAS];                   // spell id per client aura slot
+        uint64 m_visibleAuraSlots;                          // bit per used client aura slot
 
         float m_speed_rate[MAX_MOVE_TYPE];
 
@@ -768,6 +768,16 @@ void GameEventMgr::ApplyNewEvent(uint16 event_id, bool resume)
     OnEventHappened(event_id, true, resume);
 }
 
+// objects are created by the maps themselves, spread over their next updates (see Map::UpdateEventSpawns)
+void GameEventMgr::QueueSpawnInMaps(TypeID typeId, uint32 dbGuid, int16 event_id, uint32 mapId, float x, float y)
+{
+    sMapMgr.DoForAllMapsWithMapId(mapId, [&](Map* map)
+    {
+        if (map->IsLoaded(x, y))
+            map->AddEventSpawn(typeId, dbGuid, event_id, x, y);
+    });
+}
+
 void GameEventMgr::GameEventSpawn(int16 event_id)
 {
     int32 internal_event_id = m_gameEvents.size() + event_id - 1;
@@ -798,7 +808,10 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
 
             sObjectMgr.AddCreatureToGrid(itr, data);
 
-            Creature::SpawnInMaps(itr, data);
+            if (sWorld.getConfig(CONFIG_UINT32_EVENT_SPAWN_BUDGET))
+                QueueSpawnInMaps(TYPEID_UNIT, itr, event_id, data->mapid, data->posX, data->posY);
+            else
+                Creature::SpawnInMaps(itr, data);
         }
     }
 
@@ -828,7 +841,10 @@ void GameEventMgr::GameEventSpawn(int16 event_id)
 
             sObjectMgr.AddGameobjectToGrid(itr, data);
 
-            GameObject::SpawnInMaps(itr, data);
+            if (sWorld.getConfig(CONFIG_UINT32_EVENT_SPAWN_BUDGET))
+                QueueSpawnInMaps(TYPEID_GAMEOBJECT, itr, event_id, data->mapid, data->posX, data->posY);
+            else
+                GameObject::SpawnInMaps(itr, data);
         }
     }
 
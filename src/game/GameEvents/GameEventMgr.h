@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Globals/SharedDefines.h"
 #include "Platform/Define.h"
+#include "Entities/ObjectGuid.h"
 
 #define max_ge_check_delay 86400                            // 1 day in seconds
 #define FAR_FUTURE 1609459200                               // 2021, January 1st
@@ -119,6 +120,7 @@ class GameEventMgr
         void ApplyNewEvent(uint16 event_id, bool resume);
         void UnApplyEvent(uint16 event_id);
         void GameEventSpawn(int16 event_id);
+        void QueueSpawnInMaps(TypeID typeId, uint32 dbGuid, int16 event_id, uint32 mapId, float x, float y);
         void GameEventUnspawn(int16 event_id);
         void UpdateCreatureData(int16 event_id, bool activate);
         void UpdateEventQuests(uint16 event_id, bool Activate);
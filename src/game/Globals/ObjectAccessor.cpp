@@ -28,6 +28,7 @@
 #include "Grids/GridNotifiersImpl.h"
 #include "Entities/ObjectGuid.h"
 #include "World/World.h"
+#include "Social/WhoListIndex.h"
 
 #include <mutex>
 
@@ -35,33 +36,58 @@
 INSTANTIATE_SINGLETON_2(ObjectAccessor, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(ObjectAccessor, std::mutex);
 
+template<class T>
+template<class Guard>
+void HashMapHolder<T>::AcquireLock(Guard& guard)
+{
+    if (guard.try_lock())
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    guard.lock();
+    ++m_contended;
+    m_waitTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
 template<class T>
 void HashMapHolder<T>::Insert(T* o)
 {
-    WriteGuard guard(i_lock);
-    m_objectMap[o->GetObjectGuid()] = o;
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.lock, boost::defer_lock);
+    AcquireLock(guard);
+    auto result = shard.objects.insert(typename MapType::value_type(o->GetObjectGuid(), o));
+    if (result.second)
+        ++m_count;
+    else
+        result.first->second = o;
 }
 
 template<class T>
 void HashMapHolder<T>::Remove(T* o)
 {
-    WriteGuard guard(i_lock);
-    m_objectMap.erase(o->GetObjectGuid());
+    Shard& shard = GetShard(o->GetObjectGuid());
+    WriteGuard guard(shard.lock, boost::defer_lock);
+    AcquireLock(guard);
+    if (shard.objects.erase(o->GetObjectGuid()))
+        --m_count;
 }
 
 template<class T>
 T* HashMapHolder<T>::Find(ObjectGuid guid)
 {
-    ReadGuard guard(i_lock);
-    typename MapType::iterator itr = m_objectMap.find(guid);
-    return (itr != m_objectMap.end()) ? itr->second : nullptr;
+    Shard& shard = GetShard(guid);
+    ReadGuard guard(shard.lock, boost::defer_lock);
+    AcquireLock(guard);
+    typename MapType::const_iterator itr = shard.objects.find(guid);
+    return (itr != shard.objects.end()) ? itr->second : nullptr;
 }
 
 template<class T>
-typename HashMapHolder<T>::MapType& HashMapHolder<T>::GetContainer() { return m_objectMap; }
-
-template<class T>
-typename HashMapHolder<T>::LockType& HashMapHolder<T>::GetLock() { return i_lock; }
+void HashMapHolder<T>::TakeContentionStats(uint64& contended, uint64& waitTime)
+{
+    contended = m_contended.exchange(0);
+    waitTime = m_waitTime.exchange(0);
+}
 
 ObjectAccessor::ObjectAccessor() {}
 ObjectAccessor::~ObjectAccessor()
@@ -122,18 +148,12 @@ Player* ObjectAccessor::FindPlayerByName(char const* name, bool inWorld /*=true*
 
 void ObjectAccessor::SaveAllPlayers() const
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (auto& itr : m)
-        itr.second->SaveToDB();
+    HashMapHolder<Player>::DoForAll([](Player* player) { player->SaveToDB(); });
 }
 
 void ObjectAccessor::ExecuteOnAllPlayers(std::function<void(Player*)> executor)
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        executor(itr->second);
+    HashMapHolder<Player>::DoForAll(executor);
 }
 
 void ObjectAccessor::KickPlayer(ObjectGuid guid)
@@ -303,18 +323,22 @@ void ObjectAccessor::AddObject(Player* player)
 {
     HashMapHolder<Player>::Insert(player);
     PlayerNameMapHolder::Insert(player);
+    sWhoListIndex.AddPlayer(player);
 }
 
 void ObjectAccessor::RemoveObject(Player* player)
 {
     HashMapHolder<Player>::Remove(player);
     PlayerNameMapHolder::Remove(player);
+    sWhoListIndex.RemovePlayer(player);
 }
 
 /// Define the static member of HashMapHolder
 
-template <class T> typename HashMapHolder<T>::MapType HashMapHolder<T>::m_objectMap;
-template <class T> std::mutex HashMapHolder<T>::i_lock;
+template <class T> typename HashMapHolder<T>::Shard HashMapHolder<T>::m_shards[HashMapHolder<T>::SHARD_COUNT];
+template <class T> std::atomic<size_t> HashMapHolder<T>::m_count(0);
+template <class T> std::atomic<uint64> HashMapHolder<T>::m_contended(0);
+template <class T> std::atomic<uint64> HashMapHolder<T>::m_waitTime(0);
 
 /// Global definitions for the hashmap storage
 
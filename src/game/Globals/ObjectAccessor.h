@@ -31,21 +31,29 @@
 #include "Entities/Player.h"
 #include "Entities/Corpse.h"
 
+#include <atomic>
 #include <mutex>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/locks.hpp>
 
 class Unit;
 class WorldObject;
 class Map;
 
+// Objects are spread over shards by guid counter, each guarded by its own reader-writer lock:
+// lookups in the same shard share the lock and do not exclude each other, but still briefly serialize on the
+// lock's internal mutex and block while an insert/remove into that shard holds or waits for the write lock
 template <class T>
 class HashMapHolder
 {
     public:
 
         typedef std::unordered_map<ObjectGuid, T*>   MapType;
-        typedef std::mutex LockType;
-        typedef std::lock_guard<std::mutex> ReadGuard;
-        typedef std::lock_guard<std::mutex> WriteGuard;
+        typedef boost::shared_mutex LockType;
+        typedef boost::shared_lock<LockType> ReadGuard;
+        typedef boost::unique_lock<LockType> WriteGuard;
+
+        static uint32 const SHARD_COUNT = 32;
 
         static void Insert(T* o);
 
@@ -53,17 +61,41 @@ class HashMapHolder
 
         static T* Find(ObjectGuid guid);
 
-        static MapType& GetContainer();
+        static size_t GetCount() { return m_count; }
+
+        // shards are read locked one at a time, worker must not insert or remove objects of this type
+        template<class F>
+        static void DoForAll(F&& worker)
+        {
+            for (Shard& shard : m_shards)
+            {
+                ReadGuard guard(shard.lock);
+                for (typename MapType::const_iterator itr = shard.objects.begin(); itr != shard.objects.end(); ++itr)
+                    worker(itr->second);
+            }
+        }
 
-        static LockType& GetLock();
+        // lock acquisitions that had to wait and their total wait time in microseconds since last call
+        static void TakeContentionStats(uint64& contended, uint64& waitTime);
 
     private:
 
         // Non instanceable only static
         HashMapHolder() {}
 
-        static LockType i_lock;
-        static MapType  m_objectMap;
+        struct Shard
+        {
+            LockType lock;
+            MapType objects;
+        };
+
+        static Shard& GetShard(ObjectGuid guid) { return m_shards[guid.GetCounter() % SHARD_COUNT]; }
+        template<class Guard> static void AcquireLock(Guard& guard);
+
+        static Shard m_shards[SHARD_COUNT];
+        static std::atomic<size_t> m_count;
+        static std::atomic<uint64> m_contended;
+        static std::atomic<uint64> m_waitTime;
 };
 
 class PlayerNameMapHolder
@@ -104,10 +136,7 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
         static Player* FindPlayerByName(char const* name, bool inWorld = true);
         static void KickPlayer(ObjectGuid guid);
 
-        HashMapHolder<Player>::MapType& GetPlayers() const
-        {
-            return HashMapHolder<Player>::GetContainer();
-        }
+        size_t GetPlayersCount() const { return HashMapHolder<Player>::GetCount(); }
 
         void SaveAllPlayers() const;
         void ExecuteOnAllPlayers(std::function<void(Player*)> executor);
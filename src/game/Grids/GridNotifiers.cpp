@@ -123,7 +123,7 @@ void MessageDeliverer::Visit(CameraMapType& m)
                 continue;
 
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                i_message.SendTo(session);
         }
     }
 }
@@ -138,7 +138,7 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
             continue;
 
         if (WorldSession* session = owner->GetSession())
-            session->SendPacket(i_message);
+            i_message.SendTo(session);
     }
 }
 
@@ -150,7 +150,7 @@ void ObjectMessageDeliverer::Visit(CameraMapType& m)
             continue;
 
         if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-            session->SendPacket(i_message);
+            i_message.SendTo(session);
     }
 }
 
@@ -168,7 +168,7 @@ void MessageDistDeliverer::Visit(CameraMapType& m)
                 continue;
 
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                i_message.SendTo(session);
         }
     }
 }
@@ -183,7 +183,7 @@ void ObjectMessageDistDeliverer::Visit(CameraMapType& m)
                 continue;
 
             if (WorldSession* session = iter.getSource()->GetOwner()->GetSession())
-                session->SendPacket(i_message);
+                i_message.SendTo(session);
         }
     }
 }
@@ -192,7 +192,11 @@ template<class T>
 void ObjectUpdater::Visit(GridRefManager<T>& m)
 {
     for (auto& iter : m)
-        m_objectToUpdateSet.emplace(iter.getSource());
+    {
+        ++m_visitedCount;
+        if (!iter.getSource()->IsWaitingRespawn())
+            m_objectToUpdateSet.emplace(iter.getSource());
+    }
 }
 
 bool CannibalizeObjectCheck::operator()(Corpse* u)
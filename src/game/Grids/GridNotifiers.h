@@ -27,6 +27,7 @@
 #include "Entities/GameObject.h"
 #include "Entities/Player.h"
 #include "Entities/Unit.h"
+#include "Server/WorldSession.h"
 
 #include <memory>
 
@@ -57,7 +58,7 @@ namespace MaNGOS
     struct MessageDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        PacketBroadcast i_message;
         bool i_toSelf;
         MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
@@ -67,7 +68,7 @@ namespace MaNGOS
     struct MessageDelivererExcept
     {
         uint32        i_phaseMask;
-        WorldPacket const& i_message;
+        PacketBroadcast i_message;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldObject const* obj, WorldPacket const& msg, Player const* skipped)
@@ -80,7 +81,7 @@ namespace MaNGOS
     struct ObjectMessageDeliverer
     {
         uint32 i_phaseMask;
-        WorldPacket const& i_message;
+        PacketBroadcast i_message;
         explicit ObjectMessageDeliverer(WorldObject const& obj, WorldPacket const& msg)
             : i_phaseMask(obj.GetPhaseMask()), i_message(msg) {}
         void Visit(CameraMapType& m);
@@ -90,7 +91,7 @@ namespace MaNGOS
     struct MessageDistDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        PacketBroadcast i_message;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
@@ -104,7 +105,7 @@ namespace MaNGOS
     struct ObjectMessageDistDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket const& i_message;
+        PacketBroadcast i_message;
         float i_dist;
         ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
@@ -113,16 +114,20 @@ namespace MaNGOS
 
     struct ObjectUpdater
     {
-        ObjectUpdater(WorldObjectUnSet& otus, const uint32& diff) : m_objectToUpdateSet(otus), m_timeDiff(diff) {}
+        ObjectUpdater(WorldObjectUnSet& otus, const uint32& diff) : m_objectToUpdateSet(otus), m_timeDiff(diff), m_visitedCount(0) {}
         template<class T> void Visit(GridRefManager<T>& m);
         void Visit(PlayerMapType&) {}
         void Visit(CorpseMapType&) {}
         void Visit(CameraMapType&) {}
         void Visit(CreatureMapType&);
 
+        // updatable objects seen, including those waiting for respawn
+        uint32 GetVisitedCount() const { return m_visitedCount; }
+
         private:
             WorldObjectUnSet& m_objectToUpdateSet;
             uint32 m_timeDiff;
+            uint32 m_visitedCount;
     };
 
     struct PlayerVisitObjectsNotifier
@@ -42,7 +42,11 @@ inline void MaNGOS::VisibleNotifier::Visit(GridRefManager<T>& m)
 inline void MaNGOS::ObjectUpdater::Visit(CreatureMapType& m)
 {
     for (auto& iter : m)
-        m_objectToUpdateSet.emplace(iter.getSource());
+    {
+        ++m_visitedCount;
+        if (!iter.getSource()->IsWaitingRespawn())
+            m_objectToUpdateSet.emplace(iter.getSource());
+    }
 }
 
 inline void UnitVisitObjectsNotifierWorker(Unit* unitA, Unit* unitB)
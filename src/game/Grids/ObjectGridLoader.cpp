@@ -120,6 +120,7 @@ void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>&
         }
 
         grid.AddGridObject(obj);
+        map->MarkCellOccupied(cell);
 
         addUnitState(obj, cell);
         obj->SetMap(map);
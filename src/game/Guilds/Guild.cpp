@@ -577,12 +577,13 @@ void Guild::BroadcastToGuild(WorldSession* session, const std::string& msg, uint
     WorldPacket data;
     ChatHandler::BuildChatPacket(data, CHAT_MSG_GUILD, msg.c_str(), Language(language), player->GetChatTag(), player->GetObjectGuid(), player->GetName());
 
+    PacketBroadcast broadcast(data);
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
 
         if (pl && pl->GetSession() && HasRankRight(pl->GetRank(), GR_RIGHT_GCHATLISTEN) && !pl->GetSocial()->HasIgnore(player->GetObjectGuid()))
-            pl->GetSession()->SendPacket(data);
+            broadcast.SendTo(pl->GetSession());
     }
 }
 
@@ -595,37 +596,40 @@ void Guild::BroadcastToOfficers(WorldSession* session, const std::string& msg, u
     if (!player || !HasRankRight(player->GetRank(), GR_RIGHT_OFFCHATSPEAK))
         return;
 
+    WorldPacket data;
+    ChatHandler::BuildChatPacket(data, CHAT_MSG_OFFICER, msg.c_str(), Language(language), player->GetChatTag(), player->GetObjectGuid(), player->GetName());
+
+    PacketBroadcast broadcast(data);
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
-        WorldPacket data;
-        ChatHandler::BuildChatPacket(data, CHAT_MSG_OFFICER, msg.c_str(), Language(language), player->GetChatTag(), player->GetObjectGuid(), player->GetName());
-
         Player* pl = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
 
         if (pl && pl->GetSession() && HasRankRight(pl->GetRank(), GR_RIGHT_OFFCHATLISTEN) && !pl->GetSocial()->HasIgnore(player->GetObjectGuid()))
-            pl->GetSession()->SendPacket(data);
+            broadcast.SendTo(pl->GetSession());
     }
 }
 
 void Guild::BroadcastPacket(WorldPacket const& packet)
 {
+    PacketBroadcast broadcast(packet);
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
         if (player)
-            player->GetSession()->SendPacket(packet);
+            broadcast.SendTo(player->GetSession());
     }
 }
 
 void Guild::BroadcastPacketToRank(WorldPacket const& packet, uint32 rankId)
 {
+    PacketBroadcast broadcast(packet);
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         if (itr->second.RankId == rankId)
         {
             Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
             if (player)
-                player->GetSession()->SendPacket(packet);
+                broadcast.SendTo(player->GetSession());
         }
     }
 }
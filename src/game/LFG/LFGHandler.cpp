@@ -136,21 +136,17 @@ void WorldSession::SendLfgSearchResults(LfgType type, uint32 entry) const
         }
     }
 
-    // TODO: Guard Player map
-    HashMapHolder<Player>::MapType const& players = sObjectAccessor.GetPlayers();
-    uint32 playersSize = players.size();
+    uint32 playersSize = sObjectAccessor.GetPlayersCount();
     data << uint32(playersSize);                            // players count
     data << uint32(playersSize);                            // players count (total?)
 
-    for (const auto& player : players)
+    sObjectAccessor.ExecuteOnAllPlayers([&](Player* plr)
     {
-        Player* plr = player.second;
-
         if (!plr || plr->GetTeam() != _player->GetTeam())
-            continue;
+            return;
 
         if (!plr->IsInWorld())
-            continue;
+            return;
 
         data << plr->GetObjectGuid();                       // guid
 
@@ -211,7 +207,7 @@ void WorldSession::SendLfgSearchResults(LfgType type, uint32 entry) const
             data << uint64(0);                              // instance guid
             data << uint32(0);                              // completed encounters
         }
-    }
+    });
 
     SendPacket(data);
 }
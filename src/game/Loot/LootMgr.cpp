@@ -30,6 +30,7 @@
 #include "Tools/Language.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 INSTANTIATE_SINGLETON_1(LootMgr);
 
@@ -74,6 +75,11 @@ class LootTemplate::LootGroup                               // A set of loot def
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
+        // Running totals of the ExplicitlyChanced chances. As long as no entry is certain and the total doesn't pass 100%
+        // every entry drops with its own chance whatever the order, so a roll is a search in the totals instead of a shuffle
+        std::vector<float> ExplicitlyChancedTotals;
+        bool ExplicitlyChancedNeedShuffle = false;
+
         LootStoreItem const* Roll(Loot const& loot, Player const* lootOwner) const; // Rolls an item from the group, returns NULL if all miss their chances
 };
 
@@ -150,6 +156,8 @@ void LootStore::LoadLootTable()
             if (!storeitem.IsValid(*this, entry))           // Validity checks
                 continue;
 
+            storeitem.InitRate();
+
             // Looking for the template of the entry
             // often entries are put together
             if (m_LootTemplates.empty() || tab->first != entry)
@@ -256,17 +264,23 @@ bool LootStoreItem::Roll(bool rate) const
     if (chance >= 100.0f)
         return true;
 
-    if (mincountOrRef < 0)                                  // reference case
-        return roll_chance_f(chance * (rate ? sWorld.getConfig(CONFIG_FLOAT_RATE_DROP_ITEM_REFERENCED) : 1.0f));
-
-    if (needs_quest)
-        return roll_chance_f(chance * (rate ? sWorld.getConfig(CONFIG_FLOAT_RATE_DROP_ITEM_QUEST) : 1.0f));
-
-    ItemPrototype const* pProto = ObjectMgr::GetItemPrototype(itemid);
+    if (!rate || rateConfig < 0)
+        return roll_chance_f(chance);
 
-    float qualityModifier = pProto && rate ? sWorld.getConfig(qualityToRate[pProto->Quality]) : 1.0f;
+    return roll_chance_f(chance * sWorld.getConfig(eConfigFloatValues(rateConfig)));
+}
 
-    return roll_chance_f(chance * qualityModifier);
+// Selects the drop rate of the entry once at loading, rates stay reloadable with the config
+void LootStoreItem::InitRate()
+{
+    if (mincountOrRef < 0)                                  // reference case
+        rateConfig = CONFIG_FLOAT_RATE_DROP_ITEM_REFERENCED;
+    else if (needs_quest)
+        rateConfig = CONFIG_FLOAT_RATE_DROP_ITEM_QUEST;
+    else if (ItemPrototype const* pProto = ObjectMgr::GetItemPrototype(itemid))
+        rateConfig = qualityToRate[pProto->Quality];
+    else
+        rateConfig = -1;
 }
 
 // Checks correctness of values
@@ -2332,31 +2346,59 @@ ByteBuffer& operator<<(ByteBuffer& b, LootItem const& li)
 void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
 {
     if (item.chance != 0)
+    {
         ExplicitlyChanced.push_back(item);
+
+        float total = (ExplicitlyChancedTotals.empty() ? 0.0f : ExplicitlyChancedTotals.back()) + item.chance;
+        ExplicitlyChancedTotals.push_back(total);
+        if (item.chance >= 100.0f || total > 100.0f)
+            ExplicitlyChancedNeedShuffle = true;
+    }
     else
         EqualChanced.push_back(item);
 }
 
+// Identity order of count entries in a per thread buffer that is reused, so group rolls don't allocate
+static std::vector<uint32>& GetLootRollOrder(uint32 count)
+{
+    static thread_local std::vector<uint32> order;
+    order.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+        order[i] = i;
+    return order;
+}
+
 // Rolls an item from the group, returns NULL if all miss their chances
 LootStoreItem const* LootTemplate::LootGroup::Roll(Loot const& loot, Player const* lootOwner) const
 {
-    if (!ExplicitlyChanced.empty())                         // First explicitly chanced entries are checked
+    if (!ExplicitlyChanced.empty() && !ExplicitlyChancedNeedShuffle)
     {
-        std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
+        // an entry failing its condition leaves its range empty, the chances of the others are unchanged
+        float chance = rand_chance_f();
+        if (chance < ExplicitlyChancedTotals.back())
+        {
+            size_t index = std::upper_bound(ExplicitlyChancedTotals.begin(), ExplicitlyChancedTotals.end(), chance) - ExplicitlyChancedTotals.begin();
+            LootStoreItem const* lsi = &ExplicitlyChanced[std::min(index, ExplicitlyChanced.size() - 1)];
 
-        // fill the new vector with correct pointer to our item list
-        for (auto& itr : ExplicitlyChanced)
-            lootStoreItemVector.push_back(&itr);
+            if (!lsi->conditionId || !lootOwner || LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
+                return lsi;
 
-        // randomize the new vector
-        random_shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end());
+            sLog.outDebug("In explicit chance -> This item cannot be added! (%u)", lsi->itemid);
+        }
+    }
+    else if (!ExplicitlyChanced.empty())                    // First explicitly chanced entries are checked
+    {
+        // entries are tried in random order, shuffled as they are walked (Fisher-Yates)
+        uint32 count = uint32(ExplicitlyChanced.size());
+        std::vector<uint32>& order = GetLootRollOrder(count);
 
         float chance = rand_chance_f();
 
-        // as the new vector is randomized we can start from first element and stop at first one that meet the condition
-        for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
+        // stop at the first entry that meets the condition and wins its chance
+        for (uint32 i = 0; i < count; ++i)
         {
-            LootStoreItem const* lsi = *itr;
+            std::swap(order[i], order[urand(i, count - 1)]);
+            LootStoreItem const* lsi = &ExplicitlyChanced[order[i]];
 
             if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
             {
@@ -2375,20 +2417,8 @@ LootStoreItem const* LootTemplate::LootGroup::Roll(Loot const& loot, Player cons
 
     if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
     {
-        std::vector <LootStoreItem const*> lootStoreItemVector; // we'll use new vector to make easy the randomization
-
-        // fill the new vector with correct pointer to our item list
-        for (auto& itr : EqualChanced)
-            lootStoreItemVector.push_back(&itr);
-
-        // randomize the new vector
-        random_shuffle(lootStoreItemVector.begin(), lootStoreItemVector.end());
-
-        // as the new vector is randomized we can start from first element and stop at first one that meet the condition
-        for (std::vector <LootStoreItem const*>::const_iterator itr = lootStoreItemVector.begin(); itr != lootStoreItemVector.end(); ++itr)
+        auto canPick = [&loot, lootOwner](LootStoreItem const* lsi)
         {
-            LootStoreItem const* lsi = *itr;
-
             //check if we already have that item in the loot list
             if (loot.IsItemAlreadyIn(lsi->itemid))
             {
@@ -2396,15 +2426,35 @@ LootStoreItem const* LootTemplate::LootGroup::Roll(Loot const& loot, Player cons
                 uint32 chance = urand(0, 1);
 
                 if (chance)
-                    continue;                               // pass this item
+                    return false;                           // pass this item
             }
 
             if (lsi->conditionId && lootOwner && !LootTemplate::PlayerOrGroupFulfilsCondition(loot, lootOwner, lsi->conditionId))
             {
                 sLog.outDebug("In equal chance -> This item cannot be added! (%u)", lsi->itemid);
-                continue;
+                return false;
+            }
+            return true;
+        };
+
+        // entries are tried in random order until one meets the conditions; the order is shuffled as it is walked
+        // (Fisher-Yates), so the usual case of the first entry taken costs a single random number
+        uint32 count = uint32(EqualChanced.size());
+        uint32 first = urand(0, count - 1);
+        if (canPick(&EqualChanced[first]))
+            return &EqualChanced[first];
+
+        if (count > 1)
+        {
+            std::vector<uint32>& order = GetLootRollOrder(count);
+            std::swap(order[0], order[first]);
+
+            for (uint32 i = 1; i < count; ++i)
+            {
+                std::swap(order[i], order[urand(i, count - 1)]);
+                if (canPick(&EqualChanced[order[i]]))
+                    return &EqualChanced[order[i]];
             }
-            return lsi;
         }
     }
 
@@ -2535,7 +2585,7 @@ void LootTemplate::Process(Loot& loot, Player const* lootOwner, LootStore const&
     }
 
     // Rolling non-grouped items
-    for (auto Entrie : Entries)
+    for (auto const& Entrie : Entries)
     {
         // Check condition
         if (Entrie.conditionId && lootOwner && !PlayerOrGroupFulfilsCondition(loot, lootOwner, Entrie.conditionId))
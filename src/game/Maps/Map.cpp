@@ -22,7 +22,9 @@
 #include "Grids/GridNotifiers.h"
 #include "Log.h"
 #include "Grids/ObjectGridLoader.h"
+#include "GameEvents/GameEventMgr.h"
 #include "Metric/Metric.h"
+#include "Metric/TickProfiler.h"
 #include "Grids/CellImpl.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Maps/GridDefines.h"
@@ -41,17 +43,49 @@
 #include "Calendar/Calendar.h"
 #include "Chat/Chat.h"
 #include "Weather/Weather.h"
+#include "Memory/SlabPool.h"
 #include "Grids/ObjectGridLoader.h"
 
+#include <chrono>
+#include <thread>
+
+// Pools are intentionally never destroyed, the continents are only freed during static destruction at shutdown
+static MaNGOS::SlabPool& GetMapPool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("Map",
+        std::max({ sizeof(WorldMap), sizeof(DungeonMap), sizeof(BattleGroundMap) }), 8);
+    return *pool;
+}
+
+static MaNGOS::SlabPool& GetGridPool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("NGrid", sizeof(NGridType), 64);
+    return *pool;
+}
+
+void* Map::operator new(size_t size)
+{
+    return GetMapPool().Allocate(size);
+}
+
+void Map::operator delete(void* ptr, size_t size)
+{
+    GetMapPool().Deallocate(ptr, size);
+}
+
 Map::~Map()
 {
+    // queued or running jobs deliver their result to this map, they have to finish before it is freed
+    while (m_pendingJobs)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
     UnloadAll(true);
 
     if (!m_scriptSchedule.empty())
         sScriptMgr.DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
     if (m_persistentState)
-        m_persistentState->SetUsedByMapState(nullptr);         // field pointer can be deleted after this
+        m_persistentState->SetUsedByMapState(nullptr);         // field pointer can be deleted after this, saves the pending respawn times
 
     delete i_data;
     i_data = nullptr;
@@ -97,7 +131,9 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
-      i_data(nullptr), i_script_id(0), i_defaultLight(GetDefaultMapLight(id))
+      i_data(nullptr), i_script_id(0), m_respawnSaveTimer(RESPAWN_SAVE_INTERVAL),
+      m_pendingUpdateDiff(0), m_idleTime(0), m_idleCellsDiff(0), m_updateClock(0), m_pendingJobs(0),
+      i_defaultLight(GetDefaultMapLight(id))
 {
     m_weatherSystem = new WeatherSystem(this);
 }
@@ -143,6 +179,7 @@ template<class T>
 void Map::AddToGrid(T* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).AddGridObject<T>(obj);
+    MarkCellOccupied(cell.cellPair());
 }
 
 template<>
@@ -181,6 +218,8 @@ void Map::AddToGrid(Creature* obj, NGridType* grid, Cell const& cell)
         (*grid)(cell.CellX(), cell.CellY()).AddGridObject<Creature>(obj);
         obj->SetCurrentCell(cell);
     }
+
+    MarkCellOccupied(cell.cellPair());
 }
 
 template<class T>
@@ -235,7 +274,8 @@ void Map::EnsureGridCreated(const GridPair& p)
 {
     if (!getNGrid(p.x_coord, p.y_coord))
     {
-        setNGrid(new NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld.getConfig(CONFIG_BOOL_GRID_UNLOAD)),
+        void* gridMemory = GetGridPool().Allocate(sizeof(NGridType));
+        setNGrid(new (gridMemory) NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld.getConfig(CONFIG_BOOL_GRID_UNLOAD)),
                  p.x_coord, p.y_coord);
 
         // build a linkage between this map and NGridType
@@ -378,6 +418,7 @@ Map::Add(T* obj)
     }
 
     obj->SetMap(this);
+    obj->SetWaitingRespawn(false);
 
     Cell cell(p);
     if (obj->isActiveObject())
@@ -560,7 +601,7 @@ bool Map::loaded(const GridPair& p) const
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
-void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
+void Map::VisitNearbyCellsOf(WorldObject* obj, MaNGOS::ObjectUpdater& updater, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor)
 {
     // lets update mobs/objects in ALL visible cells around player!
     CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
@@ -570,17 +611,24 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
         for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
         {
             // marked cells are those that have been visited
-            // don't visit the same cell twice
+            // don't visit the same cell twice, and skip cells nothing updatable entered
             uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-            if (!isCellMarked(cell_id))
-            {
-                markCell(cell_id);
-                CellPair pair(x, y);
-                Cell cell(pair);
-                cell.SetNoCreate();
-                Visit(cell, gridVisitor);
-                Visit(cell, worldVisitor);
-            }
+            if (!m_occupiedCells.test(cell_id) || isCellMarked(cell_id))
+                continue;
+
+            markCell(cell_id);
+            CellPair pair(x, y);
+            Cell cell(pair);
+            cell.SetNoCreate();
+
+            uint32 visited = updater.GetVisitedCount();
+            Visit(cell, gridVisitor);
+            Visit(cell, worldVisitor);
+
+            // the cell was found empty, objects entering it again will set the bit back
+            // cells of grids not loaded yet are kept, objects may already have been added to them
+            if (updater.GetVisitedCount() == visited && loaded(GridPair(cell.GridX(), cell.GridY())))
+                m_occupiedCells.reset(cell_id);
         }
     }
 }
@@ -588,15 +636,20 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
 void Map::Update(const uint32& t_diff)
 {
     metric::duration<std::chrono::milliseconds> meas("map.update", {
-        { "map_id", std::to_string(i_id) },
-        { "instance_id", std::to_string(i_InstanceId) }
+        { "map_id", i_id },
+        { "instance_id", i_InstanceId }
         });
+    PROFILE_SCOPE("Map::Update", i_id, GetMapName());
 
     uint64 count = 0;
 
     m_dyn_tree.update(t_diff);
 
-    GetMessager().Execute(this);
+    meas.add_field("messages", uint64(GetMessager().Execute(this)));
+
+    UpdateEventSpawns();
+
+    UpdateRespawns(t_diff);
 
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -604,6 +657,7 @@ void Map::Update(const uint32& t_diff)
         Player* plr = m_mapRefIter->getSource();
         if (plr && plr->IsInWorld())
         {
+            PROFILE_SCOPE("WorldSession::Update");
             WorldSession* pSession = plr->GetSession();
             MapSessionFilter updater(pSession);
 
@@ -627,6 +681,11 @@ void Map::Update(const uint32& t_diff)
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
+    // cells around idle players are updated at the idle interval, after the cells of everything else
+    // so cells also seen by an active player or active object keep the full rate
+    uint32 idleInterval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE);
+    std::vector<Player*> idlePlayers;
+
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -635,16 +694,24 @@ void Map::Update(const uint32& t_diff)
         if (!player->IsInWorld() || !player->IsPositionValid())
             continue;
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+        if (idleInterval && IsIdlePlayer(player))
+        {
+            idlePlayers.push_back(player);
+            continue;
+        }
+
+        PROFILE_SCOPE("Map::VisitNearbyCells");
+        VisitNearbyCellsOf(player, obj_updater, grid_object_update, world_object_update);
 
         // If player is using far sight, visit that object too
         if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            VisitNearbyCellsOf(viewPoint, obj_updater, grid_object_update, world_object_update);
     }
 
     // non-player active objects
     if (!m_activeNonPlayers.empty())
     {
+        PROFILE_SCOPE("Map::VisitNearbyCells");
         for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
         {
             // skip not in world
@@ -657,46 +724,79 @@ void Map::Update(const uint32& t_diff)
             if (!obj->IsInWorld() || !obj->IsPositionValid())
                 continue;
 
-            // lets update mobs/objects in ALL visible cells around player!
-            CellArea area = Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), GetVisibilityDistance());
+            VisitNearbyCellsOf(obj, obj_updater, grid_object_update, world_object_update);
+        }
+    }
 
-            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
-            {
-                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
-                {
-                    // marked cells are those that have been visited
-                    // don't visit the same cell twice
-                    uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-                    if (!isCellMarked(cell_id))
-                    {
-                        markCell(cell_id);
-                        CellPair pair(x, y);
-                        Cell cell(pair);
-                        cell.SetNoCreate();
-                        Visit(cell, grid_object_update);
-                        Visit(cell, world_object_update);
-                    }
-                }
-            }
+    WorldObjectUnSet idleObjToUpdate;
+    uint32 idleDiff = 0;
+    m_idleCellsDiff += t_diff;
+    if (m_idleCellsDiff >= idleInterval)
+    {
+        idleDiff = m_idleCellsDiff;
+        m_idleCellsDiff = 0;
+
+        MaNGOS::ObjectUpdater idle_updater(idleObjToUpdate, idleDiff);
+        TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > idle_grid_object_update(idle_updater);
+        TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > idle_world_object_update(idle_updater);
+
+        for (Player* player : idlePlayers)
+        {
+            PROFILE_SCOPE("Map::VisitNearbyCells");
+            VisitNearbyCellsOf(player, idle_updater, idle_grid_object_update, idle_world_object_update);
+
+            if (WorldObject* viewPoint = GetWorldObject(player->GetFarSightGuid()))
+                VisitNearbyCellsOf(viewPoint, idle_updater, idle_grid_object_update, idle_world_object_update);
         }
     }
 
     // update all objects
-    for (auto wObj : objToUpdate)
+    // objects around idle players may have been updated at the full rate since the last idle pass
+    // (an active player came by), they only get the time passed since then
+    uint64 idleCount = 0;
+    m_updateClock += t_diff;
     {
-        wObj->Update(t_diff);
-        ++count;
+        PROFILE_SCOPE("Map::UpdateObjects");
+        for (auto wObj : objToUpdate)
+        {
+            wObj->SetLastUpdateClock(m_updateClock);
+            wObj->Update(t_diff);
+            ++count;
+        }
+
+        for (auto wObj : idleObjToUpdate)
+        {
+            uint32 diff = std::min(m_updateClock - wObj->GetLastUpdateClock(), idleDiff);
+            wObj->SetLastUpdateClock(m_updateClock);
+            wObj->Update(diff);
+            ++idleCount;
+        }
+    }
+
+    if (!m_transports.empty())
+    {
+        PROFILE_SCOPE("Map::UpdateTransports");
+        for (Transport* transport : m_transports)
+            transport->Update(t_diff);
     }
 
-    meas.add_field("count", std::to_string(static_cast<int32>(count)));
+    meas.add_field("count", static_cast<int32>(count));
+    meas.add_field("idle_count", static_cast<int32>(idleCount));
+    meas.add_field("cells", static_cast<int32>(m_markedCellIds.size()));
+    // posted by other threads during this update, executed by the next one
+    meas.add_field("message_queue", static_cast<int32>(GetMessager().GetQueueDepth()));
 
     // Send world objects and item update field changes
-    SendObjectUpdates();
+    {
+        PROFILE_SCOPE("Map::SendObjectUpdates");
+        SendObjectUpdates();
+    }
 
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGroundOrArena())
     {
+        PROFILE_SCOPE("Map::UpdateGridState");
         for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
         {
             NGridType* grid = i->getSource();
@@ -707,16 +807,77 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
-    ///- Process necessary scripts
+    ///- Process necessary scripts and tasks, what doesn't fit into the budget is continued with the next update
+    uint32 taskBudget = sWorld.getConfig(CONFIG_UINT32_MAP_TASK_BUDGET);
+    uint32 taskStartTime = WorldTimer::getMSTime();
     if (!m_scriptSchedule.empty())
-        ScriptsProcess();
+    {
+        PROFILE_SCOPE("Map::ScriptsProcess");
+        ScriptsProcess(taskStartTime, taskBudget);
+    }
+
+    if (!m_tasks.empty())
+    {
+        PROFILE_SCOPE("Map::UpdateTasks");
+        UpdateTasks(taskStartTime, taskBudget);
+    }
 
     if (i_data)
+    {
+        PROFILE_SCOPE("InstanceData", i_script_id, sScriptDevAIMgr.GetScriptName(i_script_id));
         i_data->Update(t_diff);
+    }
 
     m_weatherSystem->UpdateWeathers(t_diff);
 }
 
+/**
+ * Decides if the map is updated in this tick of the map manager.
+ * Maps with activity are updated every tick. After MapUpdate.IdleDelay without activity the map is only
+ * updated every MapUpdate.IdleInterval, with the time passed since its last update.
+ */
+bool Map::IsUpdateDue(uint32 diff, uint32& updateDiff)
+{
+    m_pendingUpdateDiff += diff;
+
+    uint32 idleInterval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE);
+    uint32 idleDelay = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_IDLE_DELAY);
+    if (!idleInterval || HasActivity())
+        m_idleTime = 0;
+    else
+        m_idleTime = std::min(m_idleTime + diff, idleDelay);
+
+    if (idleInterval && m_idleTime >= idleDelay && m_pendingUpdateDiff < idleInterval)
+        return false;
+
+    updateDiff = m_pendingUpdateDiff;
+    m_pendingUpdateDiff = 0;
+    return true;
+}
+
+bool Map::HasActivity()
+{
+    if (!m_activeNonPlayers.empty() || !m_scriptSchedule.empty() || !m_eventSpawns.empty() || m_messager.HasMessages())
+        return true;
+
+    if (m_pendingJobs || !m_tasks.empty())
+        return true;
+
+    for (auto& itr : m_mapRefManager)
+    {
+        Player* player = itr.getSource();
+        if (!IsIdlePlayer(player) || player->GetSession()->HasPendingPackets())
+            return true;
+    }
+
+    return false;
+}
+
+bool Map::IsIdlePlayer(Player const* player)
+{
+    return !player->IsInCombat() && (player->isAFK() || player->IsDead());
+}
+
 void Map::Remove(Player* player, bool remove)
 {
     if (i_data)
@@ -942,7 +1103,8 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
         RemoveAllObjectsInRemoveList();
 
         unloader.UnloadN();
-        delete getNGrid(x, y);
+        grid->~NGridType();
+        GetGridPool().Deallocate(grid, sizeof(NGridType));
         setNGrid(nullptr, x, y);
     }
 
@@ -1785,15 +1947,12 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
 
     if (execParams)                                         // Check if the execution should be uniquely
     {
-        for (ScriptScheduleMap::const_iterator searchItr = m_scriptSchedule.begin(); searchItr != m_scriptSchedule.end(); ++searchItr)
+        ObjectGuid uniqueSource = execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE ? sourceGuid : ObjectGuid();
+        ObjectGuid uniqueTarget = execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET ? targetGuid : ObjectGuid();
+        if (m_scriptSchedule.AnyOf([&](ScriptAction const& action) { return action.IsSameScript(scripts.first, id, uniqueSource, uniqueTarget, ownerGuid); }))
         {
-            if (searchItr->second.IsSameScript(scripts.first, id,
-                                               execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE ? sourceGuid : ObjectGuid(),
-                                               execParams & SCRIPT_EXEC_PARAM_UNIQUE_BY_TARGET ? targetGuid : ObjectGuid(), ownerGuid))
-            {
-                DEBUG_LOG("DB-SCRIPTS: Process table `%s` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", scripts.first, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
-                return true;
-            }
+            DEBUG_LOG("DB-SCRIPTS: Process table `%s` id %u. Skip script as script already started for source %s, target %s - ScriptsStartParams %u", scripts.first, id, sourceGuid.GetString().c_str(), targetGuid.GetString().c_str(), execParams);
+            return true;
         }
     }
 
@@ -1821,8 +1980,7 @@ bool Map::ScriptsStart(ScriptMapMapName const& scripts, uint32 id, Object* sourc
     {
         auto const& scriptInfo = scriptInfoItr->second;
         ScriptAction sa(scripts.first, this, sourceGuid, targetGuid, ownerGuid, &scriptInfo);
-        m_scriptSchedule.emplace(GetCurrentClockTime() + std::chrono::milliseconds(scriptInfoItr->first), sa);
-        sScriptMgr.IncreaseScheduledScriptsCount();
+        ScheduleScriptStep(scriptInfoItr->first, sa);
     }
 
     return true;
@@ -1840,55 +1998,90 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
     ScriptAction sa("Internal Activate Command used for spell", this, sourceGuid, targetGuid, ownerGuid, &script);
 
     if (delay)
-    {
-        m_scriptSchedule.emplace(GetCurrentClockTime() + std::chrono::milliseconds(delay), sa);
-        sScriptMgr.IncreaseScheduledScriptsCount();
-    }
+        ScheduleScriptStep(delay, sa);
     else
         sa.HandleScriptStep();
 }
 
+void Map::ScheduleScriptStep(uint32 delay, ScriptAction const& action)
+{
+    uint64 now = GetCurrentClockTime().time_since_epoch().count();
+    DEBUG_FILTER_LOG(LOG_FILTER_DB_SCRIPT, "DB-SCRIPTS: schedule on map %u at " UI64FMTD " delay %u", i_id, now, delay);
+
+    m_scriptSchedule.Insert(now + delay, action);
+    sScriptMgr.IncreaseScheduledScriptsCount();
+}
+
 /// Process queued scripts
-void Map::ScriptsProcess()
+void Map::ScriptsProcess(uint32 startTime, uint32 budget)
 {
     if (m_scriptSchedule.empty())
         return;
 
-    ///- Process overdue queued scripts
-    ScriptScheduleMap::iterator iter = m_scriptSchedule.begin();
-    // ok as multimap is a *sorted* associative container
-    while (!m_scriptSchedule.empty() && (iter->first <= GetCurrentClockTime()))
+    ///- Process overdue queued scripts in due order, at least one step per update
+    uint64 now = GetCurrentClockTime().time_since_epoch().count();
+    m_scriptSchedule.CollectDue(now);
+
+    bool budgetUsed = false;
+    while (m_scriptSchedule.HasReady() && !budgetUsed)
     {
-        if (iter->second.HandleScriptStep())
+        // copied, the step may schedule further steps; it stays queued while it runs for the uniqueness checks
+        ScriptAction action = m_scriptSchedule.FrontReady();
+        size_t queued = m_scriptSchedule.size();
+        bool terminated = action.HandleScriptStep();
+
+        // steps scheduled without delay are run in this loop too, after the steps already due
+        if (m_scriptSchedule.size() > queued)
+            m_scriptSchedule.CollectDue(now);
+
+        if (terminated)
         {
-            // Terminate following script steps of this script
-            const char* tableName = iter->second.GetTableName();
-            uint32 id = iter->second.GetId();
-            ObjectGuid sourceGuid = iter->second.GetSourceGuid();
-            ObjectGuid targetGuid = iter->second.GetTargetGuid();
-            ObjectGuid ownerGuid = iter->second.GetOwnerGuid();
-
-            for (ScriptScheduleMap::iterator rmItr = m_scriptSchedule.begin(); rmItr != m_scriptSchedule.end();)
-            {
-                if (rmItr->second.IsSameScript(tableName, id, sourceGuid, targetGuid, ownerGuid))
-                {
-                    m_scriptSchedule.erase(rmItr++);
-                    sScriptMgr.DecreaseScheduledScriptCount();
-                }
-                else
-                    ++rmItr;
-            }
+            // Terminate following script steps of this script, including this one
+            const char* tableName = action.GetTableName();
+            uint32 id = action.GetId();
+            ObjectGuid sourceGuid = action.GetSourceGuid();
+            ObjectGuid targetGuid = action.GetTargetGuid();
+            ObjectGuid ownerGuid = action.GetOwnerGuid();
+
+            size_t removed = m_scriptSchedule.RemoveIf([&](ScriptAction const& other) { return other.IsSameScript(tableName, id, sourceGuid, targetGuid, ownerGuid); });
+            sScriptMgr.DecreaseScheduledScriptCount(removed);
         }
         else
         {
-            m_scriptSchedule.erase(iter);
+            m_scriptSchedule.PopReady();
 
             sScriptMgr.DecreaseScheduledScriptCount();
         }
-        iter = m_scriptSchedule.begin();
+
+        budgetUsed = budget && WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) >= budget;
     }
 }
 
+void Map::UpdateTasks(uint32 startTime, uint32 budget)
+{
+    // one step per task and round, more rounds while budget is left
+    size_t steps = m_tasks.size();
+    while (!m_tasks.empty())
+    {
+        MapTask task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        if (!task())
+            m_tasks.push_back(std::move(task));
+
+        if (steps)
+            --steps;
+
+        if (!steps && (!budget || WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) >= budget))
+            break;
+    }
+}
+
+void Map::AddJob(MapJob const& job)
+{
+    ++m_pendingJobs;
+    sMapMgr.ScheduleMapJob(*this, job);
+}
+
 /**
  * Function return player that in world at CURRENT map
  *
@@ -2479,6 +2672,129 @@ void Map::RemoveFromSpawnCount(const ObjectGuid& guid)
     m_spawnedCount[guid.GetEntry()].erase(guid);
 }
 
+void Map::AddEventSpawn(TypeID typeId, uint32 dbGuid, int16 eventId, float x, float y)
+{
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    EventSpawn spawn = { typeId, dbGuid, eventId };
+    m_eventSpawns[p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord].push_back(spawn);
+}
+
+void Map::ScheduleRespawn(WorldObject* obj, time_t respawnTime)
+{
+    obj->SetWaitingRespawn(true);
+    m_respawnQueue.push({ respawnTime, obj->GetObjectGuid() });
+}
+
+/**
+ * Wakes up the objects whose respawn time came and writes the respawn times saved since the last
+ * RESPAWN_SAVE_INTERVAL to the DB in one go.
+ */
+void Map::UpdateRespawns(uint32 diff)
+{
+    time_t now = time(nullptr);
+    while (!m_respawnQueue.empty() && m_respawnQueue.top().respawnTime <= now)
+    {
+        // objects unloaded with their grid are gone, their respawn time is kept by the persistent state
+        if (WorldObject* obj = GetWorldObject(m_respawnQueue.top().guid))
+            obj->SetWaitingRespawn(false);
+
+        m_respawnQueue.pop();
+    }
+
+    if (m_respawnSaveTimer <= diff)
+    {
+        m_respawnSaveTimer = RESPAWN_SAVE_INTERVAL;
+        m_persistentState->SaveRespawnTimes();
+    }
+    else
+        m_respawnSaveTimer -= diff;
+}
+
+/**
+ * Creates queued game event spawns, grids with players first, until the time budget is used up.
+ * At least one spawn is done per update so big events always make progress.
+ */
+void Map::UpdateEventSpawns()
+{
+    if (m_eventSpawns.empty())
+        return;
+
+    uint32 budget = sWorld.getConfig(CONFIG_UINT32_EVENT_SPAWN_BUDGET);
+    uint32 startTime = WorldTimer::getMSTime();
+
+    std::vector<EventSpawnsByGrid::iterator> grids;
+    grids.reserve(m_eventSpawns.size());
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->getSource();
+        GridPair p = MaNGOS::ComputeGridPair(player->GetPositionX(), player->GetPositionY());
+        EventSpawnsByGrid::iterator gridItr = m_eventSpawns.find(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord);
+        if (gridItr != m_eventSpawns.end() && std::find(grids.begin(), grids.end(), gridItr) == grids.end())
+            grids.push_back(gridItr);
+    }
+
+    size_t playerGrids = grids.size();
+    for (EventSpawnsByGrid::iterator gridItr = m_eventSpawns.begin(); gridItr != m_eventSpawns.end(); ++gridItr)
+        if (std::find(grids.begin(), grids.begin() + playerGrids, gridItr) == grids.begin() + playerGrids)
+            grids.push_back(gridItr);
+
+    bool budgetUsed = false;
+    for (EventSpawnsByGrid::iterator gridItr : grids)
+    {
+        std::vector<EventSpawn>& spawns = gridItr->second;
+        while (!spawns.empty() && !budgetUsed)
+        {
+            ApplyEventSpawn(spawns.back());
+            spawns.pop_back();
+
+            budgetUsed = budget && WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) >= budget;
+        }
+
+        if (spawns.empty())
+            m_eventSpawns.erase(gridItr);
+
+        if (budgetUsed)
+            break;
+    }
+}
+
+void Map::ApplyEventSpawn(EventSpawn const& spawn)
+{
+    // event was toggled again before the spawn got its turn
+    if (sGameEventMgr.IsActiveEvent(std::abs(spawn.eventId)) != (spawn.eventId > 0))
+        return;
+
+    if (spawn.typeId == TYPEID_UNIT)
+    {
+        CreatureData const* data = sObjectMgr.GetCreatureData(spawn.dbGuid);
+
+        // not loaded grids get the spawn from the grid loader
+        if (!data || !IsLoaded(data->posX, data->posY))
+            return;
+
+        // already spawned creatures (grid reloaded meanwhile) are skipped by LoadFromDB
+        Creature* creature = new Creature;
+        if (!creature->LoadFromDB(spawn.dbGuid, this))
+            delete creature;
+    }
+    else
+    {
+        GameObjectData const* data = sObjectMgr.GetGOData(spawn.dbGuid);
+        if (!data || !IsLoaded(data->posX, data->posY))
+            return;
+
+        if (GetGameObject(ObjectGuid(HIGHGUID_GAMEOBJECT, data->id, spawn.dbGuid)))
+            return;
+
+        GameObject* gameobject = new GameObject;
+        if (!gameobject->LoadFromDB(spawn.dbGuid, this))
+            delete gameobject;
+        else
+            Add(gameobject);
+    }
+}
+
 /**
  * Function to set the zone dynamic info
  */
@@ -35,10 +35,14 @@
 #include "Entities/CreatureLinkingMgr.h"
 #include "Vmap/DynamicTree.h"
 #include "Multithreading/Messager.h"
+#include "Utilities/TimerWheel.h"
 
+#include <atomic>
 #include <bitset>
+#include <deque>
 #include <functional>
 #include <list>
+#include <queue>
 
 struct CreatureInfo;
 class Creature;
@@ -55,8 +59,11 @@ class BattleGround;
 class GridMap;
 class GameObjectModel;
 class WeatherSystem;
+class Transport;
 namespace MaNGOS { struct ObjectUpdater; }
 
+#define RESPAWN_SAVE_INTERVAL (5 * IN_MILLISECONDS)         // respawn times saved by the map's objects are written to DB in bulk this often
+
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
 #pragma pack(1)
@@ -120,11 +127,15 @@ class Map : public GridRefManager<NGridType>
     public:
         virtual ~Map();
 
+        // instances are created and unloaded all the time, maps and their grids are recycled through pools
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         // currently unused for normal maps
         bool CanUnload(uint32 diff)
         {
             if (!m_unloadTimer) return false;
-            if (m_unloadTimer <= diff) return true;
+            if (m_unloadTimer <= diff) return !m_pendingJobs;   // job results are delivered to the map
             m_unloadTimer -= diff;
             return false;
         }
@@ -138,8 +149,9 @@ class Map : public GridRefManager<NGridType>
 
         static void DeleteFromWorld(Player* pl);        // player object will deleted at call
 
-        void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
+        void VisitNearbyCellsOf(WorldObject* obj, MaNGOS::ObjectUpdater& updater, TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(const uint32&);
+        bool IsUpdateDue(uint32 diff, uint32& updateDiff);
 
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket const&);
@@ -229,9 +241,17 @@ class Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, const CellPair& cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
+        void resetMarkedCells()
+        {
+            for (uint32 cellId : m_markedCellIds)
+                marked_cells.reset(cellId);
+            m_markedCellIds.clear();
+        }
         bool isCellMarked(uint32 pCellId) const { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+        void markCell(uint32 pCellId) { marked_cells.set(pCellId); m_markedCellIds.push_back(pCellId); }
+
+        // cell may hold creatures, gameobjects or dynamic objects: set when one enters it, cleared by the update finding it empty
+        void MarkCellOccupied(CellPair const& cellPair) { m_occupiedCells.set(cellPair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + cellPair.x_coord); }
 
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
@@ -357,6 +377,30 @@ class Map : public GridRefManager<NGridType>
 
         Messager<Map>& GetMessager() { return m_messager; }
 
+        typedef std::function<void(Map*)> MapJobResult;
+        typedef std::function<MapJobResult()> MapJob;
+
+        // runs the job on a map job thread without holding up any update, so it must not touch the map or its objects
+        // the returned result (if any) is executed by the map at the start of an update through the messager
+        // a map is only deleted once all its jobs are done, see ~Map
+        void AddJob(MapJob const& job);
+        void FinishJob() { --m_pendingJobs; }
+
+        // work done in steps by the map update, the step returns true when the task is complete
+        // steps are repeated until the MapUpdate.TaskBudget of the update is used, at least one step per task and update
+        typedef std::function<bool()> MapTask;
+        void AddTask(MapTask const& task) { m_tasks.push_back(task); }
+
+        // transports currently on this map, updated with the map
+        void AddTransport(Transport* transport) { m_transports.insert(transport); }
+        void RemoveTransport(Transport* transport) { m_transports.erase(transport); }
+
+        // game event spawn in a loaded grid, created by UpdateEventSpawns within the Event.SpawnBudget of each update
+        void AddEventSpawn(TypeID typeId, uint32 dbGuid, int16 eventId, float x, float y);
+
+        // dead creature or despawned gameobject is left out of the object updates until respawnTime
+        void ScheduleRespawn(WorldObject* obj, time_t respawnTime);
+
     private:
         void LoadMapAndVMap(int gx, int gy);
 
@@ -389,7 +433,34 @@ class Map : public GridRefManager<NGridType>
         void setGridObjectDataLoaded(bool pLoaded, uint32 x, uint32 y) { getNGrid(x, y)->setGridObjectDataLoaded(pLoaded); }
 
         void setNGrid(NGridType* grid, uint32 x, uint32 y);
-        void ScriptsProcess();
+        void ScheduleScriptStep(uint32 delay, ScriptAction const& action);
+        void ScriptsProcess(uint32 startTime, uint32 budget);
+        void UpdateTasks(uint32 startTime, uint32 budget);
+
+        struct EventSpawn
+        {
+            TypeID typeId;                                  // TYPEID_UNIT or TYPEID_GAMEOBJECT
+            uint32 dbGuid;
+            int16 eventId;                                  // negative for spawns of a stopped event
+        };
+
+        void UpdateEventSpawns();
+        void ApplyEventSpawn(EventSpawn const& spawn);
+
+        struct RespawnEvent
+        {
+            time_t respawnTime;
+            ObjectGuid guid;
+
+            bool operator>(RespawnEvent const& other) const { return respawnTime > other.respawnTime; }
+        };
+
+        void UpdateRespawns(uint32 diff);
+
+        // players, scripts, active objects or pending packets/messages keep the map at the full update rate
+        bool HasActivity();
+        // AFK or dead players out of combat, the cells around them are updated at the idle rate
+        static bool IsIdlePlayer(Player const* player);
 
         void SendObjectUpdates();
         std::set<Object*> i_objectsToClientUpdate;
@@ -427,11 +498,14 @@ class Map : public GridRefManager<NGridType>
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::vector<uint32> m_markedCellIds;                // cleared by resetMarkedCells instead of the whole bitset
+        std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> m_occupiedCells;
 
         WorldObjectSet i_objectsToRemove;
 
-        typedef std::multimap<TimePoint, ScriptAction> ScriptScheduleMap;
-        ScriptScheduleMap m_scriptSchedule;
+        // pending steps of DB scripts by due time (milliseconds of TimePoint)
+        typedef TimerWheel<ScriptAction> ScriptSchedule;
+        ScriptSchedule m_scriptSchedule;
 
         InstanceData* i_data;
         uint32 i_script_id;
@@ -460,6 +534,23 @@ class Map : public GridRefManager<NGridType>
 
         std::unordered_map<uint32, std::set<ObjectGuid>> m_spawnedCount;
 
+        typedef std::map<uint32 /*grid id*/, std::vector<EventSpawn>> EventSpawnsByGrid;
+        EventSpawnsByGrid m_eventSpawns;
+
+        // earliest first; an event only wakes its object up, the object checks its own respawn time and schedules again if needed
+        std::priority_queue<RespawnEvent, std::vector<RespawnEvent>, std::greater<RespawnEvent>> m_respawnQueue;
+        uint32 m_respawnSaveTimer;
+
+        uint32 m_pendingUpdateDiff;                         // time passed since the last update
+        uint32 m_idleTime;                                  // time without activity, up to MapUpdate.IdleDelay
+        uint32 m_idleCellsDiff;                             // time passed since the cells around idle players were updated
+        uint32 m_updateClock;                               // sum of update diffs, see WorldObject::GetLastUpdateClock
+
+        std::set<Transport*> m_transports;
+
+        std::atomic<uint32> m_pendingJobs;
+        std::deque<MapTask> m_tasks;
+
         ZoneDynamicInfoMap m_zoneDynamicInfo;
         uint32 i_defaultLight;
 };
@@ -57,7 +57,7 @@ void MapManager::Initialize()
 
     int num_threads(sWorld.getConfig(CONFIG_UINT32_NUM_MAP_THREADS));
     if (num_threads > 0)
-        m_updater.activate(num_threads);
+        m_updater.activate(num_threads, sWorld.getConfig(CONFIG_UINT32_NUM_MAP_JOB_THREADS));
 }
 
 void MapManager::InitStateMachine()
@@ -195,40 +195,79 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (auto& map : i_maps)
-    {
-        if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
-        else
-            map.second->Update((uint32)i_timer.GetCurrent());
-    }
-
-    if (m_updater.activated())
-        m_updater.wait();
-
-    for (Transport* m_Transport : m_Transports)
-        m_Transport->Update((uint32)i_timer.GetCurrent());
-
-    // remove all maps which can be unloaded
-    MapMapType::iterator iter = i_maps.begin();
-    while (iter != i_maps.end())
+    // maps to unload leave the map list first, their grids are unloaded by the map workers next to the updates
+    // of the other maps; the world thread waits for both, so nothing else sees a map while it is taken apart
+    std::vector<Map*> unloadedMaps;
+    std::vector<Map*> workerUnloads;
+    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end();)
     {
         Map* pMap = iter->second;
-        // check if map can be unloaded
         if (pMap->CanUnload((uint32)i_timer.GetCurrent()))
         {
-            pMap->UnloadAll(true);
-            delete pMap;
+            // players still inside are teleported out, which is only done by the world thread
+            if (pMap->HavePlayers() || !m_updater.activated())
+                pMap->UnloadAll(true);
+            else
+                workerUnloads.push_back(pMap);
 
+            unloadedMaps.push_back(pMap);
             i_maps.erase(iter++);
         }
         else
             ++iter;
     }
 
+    // idle maps skip ticks and get the accumulated time with their next update
+    // decided before any map is scheduled, the activity check reads the players of the map
+    std::vector<std::pair<Map*, uint32>> dueMaps;
+    dueMaps.reserve(i_maps.size());
+    for (auto& map : i_maps)
+    {
+        uint32 mapDiff;
+        if (map.second->IsUpdateDue((uint32)i_timer.GetCurrent(), mapDiff))
+            dueMaps.emplace_back(map.second, mapDiff);
+    }
+
+    for (Map* pMap : workerUnloads)
+        m_updater.schedule_update(new MapUnloadWorker(*pMap, m_updater));
+
+    for (auto& map : dueMaps)
+    {
+        if (m_updater.activated())
+            m_updater.schedule_update(new MapUpdateWorker(*map.first, map.second, m_updater));
+        else
+            map.first->Update(map.second);
+    }
+
+    if (m_updater.activated())
+        m_updater.wait();
+
+    // releases the persistent state and terrain, the memory goes back to the map pool
+    for (Map* pMap : unloadedMaps)
+        delete pMap;
+
+    // transports are updated by the map they are on, changing map teleports passengers and touches both maps
+    for (Transport* transport : m_transportHandoffs)
+        transport->FinishMapHandoff();
+    m_transportHandoffs.clear();
+
     i_timer.SetCurrent(0);
 }
 
+void MapManager::ScheduleMapJob(Map& map, Map::MapJob const& job)
+{
+    if (m_updater.activated())
+        m_updater.schedule_job(new MapJobWorker(map, job, m_updater));
+    else
+        MapJobWorker(map, job, m_updater).execute();
+}
+
+void MapManager::ScheduleTransportHandoff(Transport* transport)
+{
+    std::lock_guard<std::mutex> guard(m_transportHandoffLock);
+    m_transportHandoffs.push_back(transport);
+}
+
 void MapManager::RemoveAllObjectsInRemoveList()
 {
     for (auto& i_map : i_maps)
@@ -254,6 +293,10 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    // no map job may be left running or queued while the maps are deleted
+    if (m_updater.activated())
+        m_updater.deactivate();
+
     for (auto& i_map : i_maps)
         i_map.second->UnloadAll(true);
 
@@ -263,9 +306,6 @@ void MapManager::UnloadAll()
         i_maps.erase(i_maps.begin());
     }
 
-    if (m_updater.activated())
-        m_updater.deactivate();
-
     TerrainManager::Instance().UnloadAll();
 }
 
@@ -140,6 +140,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         typedef std::map<uint32, TransportSet> TransportMap;
         TransportMap m_TransportsByMap;
 
+        // called by map workers, the transport moves to its next map once all maps are updated
+        void ScheduleTransportHandoff(Transport* transport);
+
+        // see Map::AddJob
+        void ScheduleMapJob(Map& map, Map::MapJob const& job);
+
         void InitializeVisibilityDistanceInfo();
         /* statistics */
         uint32 GetNumInstances();
@@ -180,6 +186,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         IntervalTimer i_timer;
 
         MapUpdater m_updater;
+
+        std::mutex m_transportHandoffLock;
+        std::vector<Transport*> m_transportHandoffs;
 };
 
 template<typename Do>
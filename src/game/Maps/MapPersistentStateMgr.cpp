@@ -50,6 +50,7 @@ MapPersistentState::MapPersistentState(uint16 MapId, uint32 InstanceId, Difficul
 
 MapPersistentState::~MapPersistentState()
 {
+    SaveRespawnTimes();
 }
 
 MapEntry const* MapPersistentState::GetMapEntry() const
@@ -76,21 +77,10 @@ void MapPersistentState::SaveCreatureRespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGroundOrArena())
         return;
 
-    CharacterDatabase.BeginTransaction();
-
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM creature_respawn WHERE guid = ? AND instance = ?");
-    stmt.PExecute(loguid, m_instanceid);
-
-    if (t > sWorld.GetGameTime())
-    {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO creature_respawn VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
-    }
-
-    CharacterDatabase.CommitTransaction();
+    // written with the next SaveRespawnTimes, at once if no map does it
+    m_pendingCreatureRespawnSaves[loguid] = t;
+    if (!m_usedByMap)
+        SaveRespawnTimes();
 }
 
 void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
@@ -101,21 +91,61 @@ void MapPersistentState::SaveGORespawnTime(uint32 loguid, time_t t)
     if (GetMapEntry()->IsBattleGroundOrArena())
         return;
 
-    CharacterDatabase.BeginTransaction();
+    m_pendingGORespawnSaves[loguid] = t;
+    if (!m_usedByMap)
+        SaveRespawnTimes();
+}
 
-    static SqlStatementID delSpawnTime ;
-    static SqlStatementID insSpawnTime ;
+// rows per DELETE/INSERT statement of SaveRespawnTimes
+static size_t const RESPAWN_SAVE_BATCH_SIZE = 500;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delSpawnTime, "DELETE FROM gameobject_respawn WHERE guid = ? AND instance = ?");
-    stmt.PExecute(loguid, m_instanceid);
+static void SaveRespawnTimesToTable(char const* table, uint32 instanceId, std::unordered_map<uint32, time_t> const& respawnTimes)
+{
+    time_t now = sWorld.GetGameTime();
 
-    if (t > sWorld.GetGameTime())
+    std::ostringstream delSql;
+    std::ostringstream insSql;
+    size_t delCount = 0;
+    size_t insCount = 0;
+
+    for (auto itr = respawnTimes.begin(); itr != respawnTimes.end();)
     {
-        stmt = CharacterDatabase.CreateStatement(insSpawnTime, "INSERT INTO gameobject_respawn VALUES ( ?, ?, ? )");
-        stmt.PExecute(loguid, uint64(t), m_instanceid);
+        delSql << (delCount ? "," : "") << itr->first;
+        ++delCount;
+
+        if (itr->second > now)
+        {
+            insSql << (insCount ? ",(" : "(") << itr->first << "," << uint64(itr->second) << "," << instanceId << ")";
+            ++insCount;
+        }
+
+        ++itr;
+        if (delCount < RESPAWN_SAVE_BATCH_SIZE && itr != respawnTimes.end())
+            continue;
+
+        CharacterDatabase.PExecute("DELETE FROM %s WHERE instance = '%u' AND guid IN (%s)", table, instanceId, delSql.str().c_str());
+        if (insCount)
+            CharacterDatabase.PExecute("INSERT INTO %s VALUES %s", table, insSql.str().c_str());
+
+        delSql.str("");
+        insSql.str("");
+        delCount = 0;
+        insCount = 0;
     }
+}
+
+void MapPersistentState::SaveRespawnTimes()
+{
+    if (m_pendingCreatureRespawnSaves.empty() && m_pendingGORespawnSaves.empty())
+        return;
 
+    CharacterDatabase.BeginTransaction();
+    SaveRespawnTimesToTable("creature_respawn", m_instanceid, m_pendingCreatureRespawnSaves);
+    SaveRespawnTimesToTable("gameobject_respawn", m_instanceid, m_pendingGORespawnSaves);
     CharacterDatabase.CommitTransaction();
+
+    m_pendingCreatureRespawnSaves.clear();
+    m_pendingGORespawnSaves.clear();
 }
 
 void MapPersistentState::SetCreatureRespawnTime(uint32 loguid, time_t t)
@@ -144,6 +174,8 @@ void MapPersistentState::ClearRespawnTimes()
 {
     m_goRespawnTimes.clear();
     m_creatureRespawnTimes.clear();
+    m_pendingGORespawnSaves.clear();
+    m_pendingCreatureRespawnSaves.clear();
 
     UnloadIfEmpty();
 }
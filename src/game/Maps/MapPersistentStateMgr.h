@@ -86,7 +86,10 @@ class MapPersistentState
         {
             m_usedByMap = map;
             if (!map)
+            {
+                SaveRespawnTimes();
                 UnloadIfEmpty();
+            }
         }
 
         time_t GetCreatureRespawnTime(uint32 loguid) const
@@ -101,6 +104,8 @@ class MapPersistentState
             return itr != m_goRespawnTimes.end() ? itr->second : 0;
         }
         void SaveGORespawnTime(uint32 loguid, time_t t);
+        // writes the respawn times saved since the last call in bulk statements, called periodically by the map
+        void SaveRespawnTimes();
 
         // pool system
         void InitPools();
@@ -137,6 +142,8 @@ class MapPersistentState
         // persistent data
         RespawnTimes m_creatureRespawnTimes;                // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
+        RespawnTimes m_pendingCreatureRespawnSaves;         // not yet written to DB, see SaveRespawnTimes
+        RespawnTimes m_pendingGORespawnSaves;
         MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
 
         SpawnedPoolData m_spawnedPoolData;                  // Pools spawns state for map copy
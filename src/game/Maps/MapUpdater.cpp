@@ -19,19 +19,21 @@
 #include "MapUpdater.h"
 #include "MapWorkers.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+MapUpdater::MapUpdater(size_t num_threads, size_t num_job_threads) : _cancelationToken(false), pending_requests(0)
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    activate(num_threads, num_job_threads);
 }
 
-void MapUpdater::activate(size_t num_threads)
+void MapUpdater::activate(size_t num_threads, size_t num_job_threads)
 {
     if (activated())
         return;
 
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, std::ref(_queue)));
+
+    for (size_t i = 0; i < num_job_threads; ++i)
+        _jobThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, std::ref(_jobQueue)));
 }
 
 void MapUpdater::deactivate()
@@ -39,9 +41,17 @@ void MapUpdater::deactivate()
     _cancelationToken = true;
 
     _queue.Cancel();
+    _jobQueue.Cancel();
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    for (auto& thread : _jobThreads)
+        thread.join();
+
+    // work scheduled from now on is done inline by the callers
+    _workerThreads.clear();
+    _jobThreads.clear();
 }
 
 void MapUpdater::wait()
@@ -79,13 +89,18 @@ void MapUpdater::schedule_update(Worker* worker)
     _queue.Push(std::move(worker));
 }
 
-void MapUpdater::WorkerThread()
+void MapUpdater::schedule_job(Worker* worker)
+{
+    _jobQueue.Push(std::move(worker));
+}
+
+void MapUpdater::WorkerThread(ProducerConsumerQueue<Worker*>& queue)
 {
     while (true)
     {
         Worker* request = nullptr;
 
-        _queue.WaitAndPop(request);
+        queue.WaitAndPop(request);
 
         if (_cancelationToken)
         {
@@ -27,6 +27,7 @@
 #include <atomic>
 #include <vector>
 #include <condition_variable>
+#include <functional>
 
 class Worker;
 
@@ -34,28 +35,31 @@ class MapUpdater
 {
     public:
         MapUpdater() : _cancelationToken(false), pending_requests(0) {}
-        MapUpdater(size_t num_threads);
+        MapUpdater(size_t num_threads, size_t num_job_threads);
         MapUpdater(const MapUpdater&) = delete;
         
-        void activate(size_t num_threads);
+        void activate(size_t num_threads, size_t num_job_threads);
         void deactivate();
         void wait();
         void join();
         bool activated();
         void update_finished();
         void schedule_update(Worker* worker);
+        void schedule_job(Worker* worker);                  // not waited for by wait(), run by the job threads
 
     private:
         ProducerConsumerQueue<Worker *> _queue;
+        ProducerConsumerQueue<Worker *> _jobQueue;          // own threads, long jobs never hold up map updates
 
         std::vector<std::thread> _workerThreads;
+        std::vector<std::thread> _jobThreads;
         std::atomic<bool> _cancelationToken;
 
         std::mutex _lock;
         std::condition_variable _condition;
         size_t pending_requests;
 
-        void WorkerThread();
+        void WorkerThread(ProducerConsumerQueue<Worker*>& queue);
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
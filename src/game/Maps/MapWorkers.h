@@ -30,6 +30,7 @@ class Worker
 {
     public:
         Worker(MapUpdater& updater) : m_updater(updater) {}
+        virtual ~Worker() {}
         virtual void execute() {};
 
     protected:
@@ -57,6 +58,44 @@ class MapUpdateWorker : public Worker
         uint32 m_diff;
 };
 
+class MapUnloadWorker : public Worker
+{
+    public:
+        MapUnloadWorker(Map& map, MapUpdater& updater) :
+            Worker(updater), m_map(map)
+        {}
+
+        void execute() override
+        {
+            m_map.UnloadAll(true);
+            GetWorker().update_finished();
+        }
+
+    private:
+        Map& m_map;
+};
+
+class MapJobWorker : public Worker
+{
+    public:
+        MapJobWorker(Map& map, Map::MapJob const& job, MapUpdater& updater) :
+            Worker(updater), m_map(map), m_job(job)
+        {}
+
+        // also reached for jobs dropped from the queue by MapUpdater::deactivate, the map waits for this
+        ~MapJobWorker() override { m_map.FinishJob(); }
+
+        void execute() override
+        {
+            if (Map::MapJobResult result = m_job())
+                m_map.GetMessager().AddMessage(std::move(result));
+        }
+
+    private:
+        Map& m_map;
+        Map::MapJob m_job;
+};
+
 class GridCrawler : public Worker
 {
     public:
@@ -49,11 +49,11 @@ inline bool isStatic(MovementGenerator* mv)
 void MotionMaster::Initialize()
 {
     metric::duration<std::chrono::microseconds> meas("motionmaster.initialize", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
+        { "entry", m_owner->GetEntry() },
+        { "guid", m_owner->GetGUIDLow() },
+        { "unit_type", m_owner->GetGUIDHigh() },
+        { "map_id", m_owner->GetMapId() },
+        { "instance_id", m_owner->GetInstanceId() }
     }, 1000);
 
     // stop current move
@@ -94,11 +94,11 @@ void MotionMaster::UpdateMotion(uint32 diff)
         return;
 
     metric::duration<std::chrono::microseconds> meas("motionmaster.updatemotion", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
+        { "entry", m_owner->GetEntry() },
+        { "guid", m_owner->GetGUIDLow() },
+        { "unit_type", m_owner->GetGUIDHigh() },
+        { "map_id", m_owner->GetMapId() },
+        { "instance_id", m_owner->GetInstanceId() }
     }, 1000);
 
     MANGOS_ASSERT(!empty());
@@ -68,11 +68,11 @@ bool PathFinder::calculate(const Vector3& start, const Vector3& dest, bool force
         return false;
 
     metric::duration<std::chrono::microseconds> meas("pathfinder.calculate", {
-        { "entry", std::to_string(m_sourceUnit->GetEntry()) },
-        { "guid", std::to_string(m_sourceUnit->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_sourceUnit->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_sourceUnit->GetMapId()) },
-        { "instance_id", std::to_string(m_sourceUnit->GetInstanceId()) }
+        { "entry", m_sourceUnit->GetEntry() },
+        { "guid", m_sourceUnit->GetGUIDLow() },
+        { "unit_type", m_sourceUnit->GetGUIDHigh() },
+        { "map_id", m_sourceUnit->GetMapId() },
+        { "instance_id", m_sourceUnit->GetInstanceId() }
     }, 1000);
 
     setStartPosition(start);
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/OpcodeStats.h"
+#include "Policies/Singleton.h"
+#include "World/World.h"
+#include "Metric/Metric.h"
+#include "Log.h"
+
+INSTANTIATE_SINGLETON_1(OpcodeStatsMgr);
+
+namespace
+{
+    // an opcode needs this many calls before its average handler time decides about rate limiting
+    uint64 const RATE_LIMIT_MIN_SAMPLES = 100;
+}
+
+OpcodeStatsMgr::OpcodeStatsMgr() : m_totals(NUM_MSG_TYPES)
+{
+    for (std::atomic<bool>& limited : m_rateLimited)
+        limited.store(false, std::memory_order_relaxed);
+}
+
+OpcodeStatsMgr::ThreadTable& OpcodeStatsMgr::GetThreadTable()
+{
+    // the table is shared with the registry so the merge can still read it after the thread exits
+    thread_local std::shared_ptr<ThreadTable> t_table;
+    if (!t_table)
+    {
+        t_table = std::make_shared<ThreadTable>();
+
+        std::lock_guard<std::mutex> guard(m_tablesLock);
+        m_tables.push_back(t_table);
+    }
+
+    return *t_table;
+}
+
+void OpcodeStatsMgr::AddCall(uint16 opcode, uint32 time, uint32 bytesIn, uint32 bytesOut)
+{
+    OpcodeThreadCounters& counters = GetThreadTable().counters[opcode];
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.time.fetch_add(time, std::memory_order_relaxed);
+    counters.bytesIn.fetch_add(bytesIn, std::memory_order_relaxed);
+    counters.bytesOut.fetch_add(bytesOut, std::memory_order_relaxed);
+
+    // single writer, the merge only resets it
+    if (time > counters.maxTime.load(std::memory_order_relaxed))
+        counters.maxTime.store(time, std::memory_order_relaxed);
+}
+
+void OpcodeStatsMgr::AddThrottled(uint16 opcode)
+{
+    GetThreadTable().counters[opcode].throttled.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OpcodeStatsMgr::Merge()
+{
+    std::vector<OpcodeStatsEntry> interval(NUM_MSG_TYPES);
+    {
+        std::lock_guard<std::mutex> guard(m_tablesLock);
+        for (auto const& table : m_tables)
+        {
+            for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+            {
+                OpcodeThreadCounters& counters = table->counters[i];
+                if (!counters.calls.load(std::memory_order_relaxed) && !counters.throttled.load(std::memory_order_relaxed))
+                    continue;
+
+                OpcodeStatsEntry& entry = interval[i];
+                entry.calls += counters.calls.exchange(0, std::memory_order_relaxed);
+                entry.time += counters.time.exchange(0, std::memory_order_relaxed);
+                entry.maxTime = std::max(entry.maxTime, counters.maxTime.exchange(0, std::memory_order_relaxed));
+                entry.bytesIn += counters.bytesIn.exchange(0, std::memory_order_relaxed);
+                entry.bytesOut += counters.bytesOut.exchange(0, std::memory_order_relaxed);
+                entry.throttled += counters.throttled.exchange(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint32 limitCost = sWorld.getConfig(CONFIG_UINT32_OPCODE_RATE_LIMIT_COST);
+    bool limitEnabled = sWorld.getConfig(CONFIG_UINT32_OPCODE_RATE_LIMIT) != 0;
+
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        OpcodeStatsEntry const& entry = interval[i];
+        if (!entry.calls && !entry.throttled)
+            continue;
+
+        OpcodeStatsEntry& total = m_totals[i];
+        total.calls += entry.calls;
+        total.time += entry.time;
+        total.maxTime = std::max(total.maxTime, entry.maxTime);
+        total.bytesIn += entry.bytesIn;
+        total.bytesOut += entry.bytesOut;
+        total.throttled += entry.throttled;
+
+        bool limited = limitEnabled && total.calls >= RATE_LIMIT_MIN_SAMPLES && total.time / total.calls >= limitCost;
+        if (limited != m_rateLimited[i].load(std::memory_order_relaxed))
+        {
+            m_rateLimited[i].store(limited, std::memory_order_relaxed);
+            DETAIL_LOG("OpcodeStatsMgr: opcode %s (0x%.4X) average handler time " UI64FMTD " us, session rate limit %s",
+                       LookupOpcodeName(i), i, total.time / total.calls, limited ? "enabled" : "disabled");
+        }
+
+        metric::measurement meas("world.metrics.packets.handled", { {"opcode", opcodeTable[i].name} });
+        meas.add_field("calls", entry.calls);
+        meas.add_field("time", entry.time);
+        meas.add_field("max_time", entry.maxTime);
+        meas.add_field("bytes_in", entry.bytesIn);
+        meas.add_field("bytes_out", entry.bytesOut);
+        meas.add_field("throttled", entry.throttled);
+    }
+}
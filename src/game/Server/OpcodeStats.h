@@ -0,0 +1,92 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODESTATS_H
+#define MANGOS_OPCODESTATS_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Server/Opcodes.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// Counters of one opcode in one thread table, only written by the owning thread
+struct OpcodeThreadCounters
+{
+    std::atomic<uint64> calls;
+    std::atomic<uint64> time;                               // microseconds
+    std::atomic<uint32> maxTime;                            // microseconds
+    std::atomic<uint64> bytesIn;
+    std::atomic<uint64> bytesOut;                           // sent by any session while the handler ran
+    std::atomic<uint32> throttled;                          // dropped by the session rate limit
+};
+
+struct OpcodeStatsEntry
+{
+    OpcodeStatsEntry() : calls(0), time(0), maxTime(0), bytesIn(0), bytesOut(0), throttled(0) {}
+
+    uint64 calls;
+    uint64 time;                                            // microseconds
+    uint32 maxTime;                                         // microseconds
+    uint64 bytesIn;
+    uint64 bytesOut;
+    uint64 throttled;
+};
+
+/**
+ * Handler cost accounting per opcode.
+ * Session updates (world thread and map workers) add to a table of their own thread, the world thread merges
+ * all tables each metric interval, reports the interval to the metric and keeps the totals since startup.
+ * Opcodes whose average handler time is above Network.OpcodeRateLimitCost are rate limited per session
+ * to Network.OpcodeRateLimit calls per second.
+ */
+class OpcodeStatsMgr
+{
+    public:
+        OpcodeStatsMgr();
+
+        void AddCall(uint16 opcode, uint32 time, uint32 bytesIn, uint32 bytesOut);
+        void AddThrottled(uint16 opcode);
+
+        // world thread
+        void Merge();
+
+        bool IsRateLimited(uint16 opcode) const { return m_rateLimited[opcode].load(std::memory_order_relaxed); }
+
+    private:
+        struct ThreadTable
+        {
+            OpcodeThreadCounters counters[NUM_MSG_TYPES];
+        };
+
+        ThreadTable& GetThreadTable();
+
+        std::mutex m_tablesLock;                            // only taken when a thread adds its first call and by Merge
+        std::vector<std::shared_ptr<ThreadTable>> m_tables;
+
+        std::atomic<bool> m_rateLimited[NUM_MSG_TYPES];
+
+        std::vector<OpcodeStatsEntry> m_totals;             // world thread only
+};
+
+#define sOpcodeStats MaNGOS::Singleton<OpcodeStatsMgr>::Instance()
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/QueryResponseCache.h"
+#include "Policies/Singleton.h"
+#include "Metric/Metric.h"
+
+INSTANTIATE_SINGLETON_1(QueryResponseCache);
+
+namespace
+{
+    char const* const QueryResponseTypeNames[MAX_QUERY_RESPONSE_TYPE] =
+    {
+        "creature",
+        "gameobject",
+        "item",
+        "quest",
+        "page_text",
+        "npc_text",
+    };
+}
+
+QueryResponseCache::QueryResponseCache()
+{
+    for (ResponseStore& store : m_stores)
+    {
+        store.hits.store(0, std::memory_order_relaxed);
+        store.misses.store(0, std::memory_order_relaxed);
+    }
+}
+
+QueryResponsePacket QueryResponseCache::Find(QueryResponseType type, uint32 entry, int32 locIdx)
+{
+    ResponseStore& store = m_stores[type];
+    {
+        boost::shared_lock<boost::shared_mutex> guard(store.lock);
+        auto itr = store.responses.find(MakeKey(entry, locIdx));
+        if (itr != store.responses.end())
+        {
+            store.hits.fetch_add(1, std::memory_order_relaxed);
+            return itr->second;
+        }
+    }
+
+    store.misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void QueryResponseCache::Store(QueryResponseType type, uint32 entry, int32 locIdx, WorldPacket const& packet)
+{
+    QueryResponsePacket response = std::make_shared<WorldPacket const>(packet);
+
+    ResponseStore& store = m_stores[type];
+    boost::unique_lock<boost::shared_mutex> guard(store.lock);
+    // two sessions may have built the same response, keep the first
+    store.responses.emplace(MakeKey(entry, locIdx), std::move(response));
+}
+
+void QueryResponseCache::Invalidate(QueryResponseType type)
+{
+    ResponseStore& store = m_stores[type];
+    boost::unique_lock<boost::shared_mutex> guard(store.lock);
+    store.responses.clear();
+}
+
+void QueryResponseCache::InvalidateAll()
+{
+    for (uint32 i = 0; i < MAX_QUERY_RESPONSE_TYPE; ++i)
+        Invalidate(QueryResponseType(i));
+}
+
+void QueryResponseCache::ReportMetrics()
+{
+    for (uint32 i = 0; i < MAX_QUERY_RESPONSE_TYPE; ++i)
+    {
+        ResponseStore& store = m_stores[i];
+        uint64 hits = store.hits.exchange(0, std::memory_order_relaxed);
+        uint64 misses = store.misses.exchange(0, std::memory_order_relaxed);
+        if (!hits && !misses)
+            continue;
+
+        size_t size;
+        {
+            boost::shared_lock<boost::shared_mutex> guard(store.lock);
+            size = store.responses.size();
+        }
+
+        metric::measurement meas("world.metrics.query_cache", { {"type", QueryResponseTypeNames[i]} });
+        meas.add_field("hits", hits);
+        meas.add_field("misses", misses);
+        meas.add_field("hit_rate", float(hits) / float(hits + misses));
+        meas.add_field("size", uint32(size));
+    }
+}
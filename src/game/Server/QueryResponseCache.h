@@ -0,0 +1,83 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_QUERYRESPONSECACHE_H
+#define MANGOS_QUERYRESPONSECACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "WorldPacket.h"
+
+#include <boost/thread/shared_mutex.hpp>
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+enum QueryResponseType
+{
+    QUERY_RESPONSE_CREATURE,
+    QUERY_RESPONSE_GAMEOBJECT,
+    QUERY_RESPONSE_ITEM,
+    QUERY_RESPONSE_QUEST,
+    QUERY_RESPONSE_PAGE_TEXT,
+    QUERY_RESPONSE_NPC_TEXT,
+
+    MAX_QUERY_RESPONSE_TYPE
+};
+
+typedef SharedWorldPacket QueryResponsePacket;
+
+/**
+ * Serialized responses to the static data queries, per (entry, db locale index).
+ * Packets are built by the query handler on the first request and never modified afterwards, so every
+ * other session asking for the same entry in the same locale gets the same buffer referenced by its socket.
+ * Reloading the tables the responses are built from drops the cached responses of that type.
+ * Handlers run in network threads and map workers at the same time, lookups take a shared lock.
+ */
+class QueryResponseCache
+{
+    public:
+        QueryResponseCache();
+
+        QueryResponsePacket Find(QueryResponseType type, uint32 entry, int32 locIdx);
+        void Store(QueryResponseType type, uint32 entry, int32 locIdx, WorldPacket const& packet);
+
+        void Invalidate(QueryResponseType type);
+        void InvalidateAll();
+
+        // world thread, reports hits and misses since the previous call
+        void ReportMetrics();
+
+    private:
+        static uint64 MakeKey(uint32 entry, int32 locIdx) { return (uint64(entry) << 32) | uint32(locIdx + 1); }
+
+        struct ResponseStore
+        {
+            boost::shared_mutex lock;
+            std::unordered_map<uint64, QueryResponsePacket> responses;
+            std::atomic<uint64> hits;
+            std::atomic<uint64> misses;
+        };
+
+        ResponseStore m_stores[MAX_QUERY_RESPONSE_TYPE];
+};
+
+#define sQueryResponseCache MaNGOS::Singleton<QueryResponseCache>::Instance()
+
+#endif
@@ -40,18 +40,23 @@
 #include "Auth/HMACSHA1.h"
 #include "GMTickets/GMTicketMgr.h"
 #include "Loot/LootMgr.h"
+#include "Server/OpcodeStats.h"
 
 #include <boost/asio/ip/address_v4.hpp>
 
 #include <mutex>
 #include <deque>
 #include <cstdarg>
+#include <chrono>
 
 #ifdef BUILD_PLAYERBOT
 #include "PlayerBot/Base/PlayerbotMgr.h"
 #include "PlayerBot/Base/PlayerbotAI.h"
 #endif
 
+// bytes sent to clients by this thread, the difference around a handler is accounted to its opcode
+static thread_local uint64 t_sentBytes = 0;
+
 // select opcodes appropriate for processing in Map::Update context for current session state
 static bool MapSessionFilterHelper(WorldSession* session, OpcodeHandler const& opHandle)
 {
@@ -224,9 +229,44 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 
 #endif                                                  // !MANGOS_DEBUG
 
+    t_sentBytes += packet.size();
     m_Socket->SendPacket(packet);
 }
 
+void WorldSession::SendPacket(std::shared_ptr<WorldPacket const> const& packet) const
+{
+#ifdef BUILD_PLAYERBOT
+    // Send packet to bot AI
+    if (GetPlayer())
+    {
+        if (GetPlayer()->GetPlayerbotAI())
+            GetPlayer()->GetPlayerbotAI()->HandleBotOutgoingPacket(*packet);
+        else if (GetPlayer()->GetPlayerbotMgr())
+            GetPlayer()->GetPlayerbotMgr()->HandleMasterOutgoingPacket(*packet);
+    }
+#endif
+
+    if (!m_Socket || m_Socket->IsClosed())
+        return;
+
+    t_sentBytes += packet->size();
+    m_Socket->SendPacket(packet);
+}
+
+void PacketBroadcast::SendTo(WorldSession* session)
+{
+    if (m_packet.size() < BROADCAST_SHARED_MIN_SIZE)
+    {
+        session->SendPacket(m_packet);
+        return;
+    }
+
+    if (!m_shared)
+        m_shared = std::make_shared<WorldPacket const>(m_packet);
+
+    session->SendPacket(m_shared);
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 {
@@ -235,6 +275,13 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
     m_recvQueue.push_back(std::move(new_packet));
 }
 
+/// Packets are waiting for the next session update
+bool WorldSession::HasPendingPackets()
+{
+    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+    return !m_recvQueue.empty();
+}
+
 /// Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const
 {
@@ -272,6 +319,15 @@ bool WorldSession::Update(PacketFilter& updater)
         #endif*/
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
+
+        if (!CheckOpcodeRate(packet->GetOpcode()))
+        {
+            sOpcodeStats.AddThrottled(packet->GetOpcode());
+            DEBUG_LOG("SESSION: opcode %s (0x%.4X) from account %u over the rate limit, dropped",
+                      packet->GetOpcodeName(), packet->GetOpcode(), GetAccountId());
+            continue;
+        }
+
         try
         {
             switch (opHandle.status)
@@ -1134,6 +1190,9 @@ void WorldSession::SendRedirectClient(std::string& ip, uint16 port) const
 
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet)
 {
+    auto startTime = std::chrono::steady_clock::now();
+    uint64 startSentBytes = t_sentBytes;
+
     // need prevent do internal far teleports in handlers because some handlers do lot steps
     // or call code that can do far teleports in some conditions unexpectedly for generic way work code
     if (_player)
@@ -1154,6 +1213,32 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& pac
 
     if (packet.rpos() < packet.wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
         LogUnprocessedTail(packet);
+
+    uint32 elapsed = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+    sOpcodeStats.AddCall(packet.GetOpcode(), elapsed, uint32(packet.size()), uint32(t_sentBytes - startSentBytes));
+
+    uint32 slowThreshold = sWorld.getConfig(CONFIG_UINT32_SLOW_OPCODE_THRESHOLD);
+    if (slowThreshold && elapsed >= slowThreshold * IN_MILLISECONDS)
+        sLog.outString("SESSION: opcode %s (0x%.4X) handled in %u us (size " SIZEFMTD ") for account %u, player %s",
+                       packet.GetOpcodeName(), packet.GetOpcode(), elapsed, packet.size(), GetAccountId(), GetPlayerName());
+}
+
+/// Per second limit of expensive opcodes, see OpcodeStatsMgr
+bool WorldSession::CheckOpcodeRate(uint16 opcode)
+{
+    uint32 limit = sWorld.getConfig(CONFIG_UINT32_OPCODE_RATE_LIMIT);
+    if (!limit || GetSecurity() > SEC_PLAYER || !sOpcodeStats.IsRateLimited(opcode))
+        return true;
+
+    uint32 now = WorldTimer::getMSTime();
+    OpcodeRate& rate = m_opcodeRates[opcode];
+    if (!rate.calls || WorldTimer::getMSTimeDiff(rate.windowStart, now) >= IN_MILLISECONDS)
+    {
+        rate.windowStart = now;
+        rate.calls = 0;
+    }
+
+    return ++rate.calls <= limit;
 }
 
 void WorldSession::SendPlaySpellVisual(ObjectGuid guid, uint32 spellArtKit) const
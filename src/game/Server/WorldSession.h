@@ -33,6 +33,7 @@
 #include <deque>
 #include <mutex>
 #include <memory>
+#include <unordered_map>
 
 struct ItemPrototype;
 struct AuctionEntry;
@@ -289,6 +290,7 @@ class WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const& packet) const;
+        void SendPacket(std::shared_ptr<WorldPacket const> const& packet) const;
         void SendExpectedSpamRecords();
         void SendMotd();
         void SendOfflineNameQueryResponses();
@@ -351,6 +353,7 @@ class WorldSession
         void KickPlayer();
 
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
+        bool HasPendingPackets();
 
         bool Update(PacketFilter& updater);
 
@@ -965,6 +968,7 @@ class WorldSession
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet);
+        bool CheckOpcodeRate(uint16 opcode);
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const;
@@ -1002,6 +1006,35 @@ class WorldSession
 
         std::mutex m_recvQueueLock;
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
+
+        struct OpcodeRate
+        {
+            OpcodeRate() : windowStart(0), calls(0) {}
+
+            uint32 windowStart;
+            uint32 calls;
+        };
+        std::unordered_map<uint16, OpcodeRate> m_opcodeRates;   // only expensive opcodes, see OpcodeStatsMgr
+};
+
+// payloads below this size are copied to each socket, referencing them would cost more
+#define BROADCAST_SHARED_MIN_SIZE 64
+
+/**
+ * Sends one packet to many sessions.
+ * The payload is copied once into a shared buffer when the first session gets it, the sockets of all
+ * sessions then reference that buffer and only build and encrypt their own header.
+ */
+class PacketBroadcast
+{
+    public:
+        explicit PacketBroadcast(WorldPacket const& packet) : m_packet(packet) {}
+
+        void SendTo(WorldSession* session);
+
+    private:
+        WorldPacket const& m_packet;
+        std::shared_ptr<WorldPacket const> m_shared;
 };
 #endif
 /// @}
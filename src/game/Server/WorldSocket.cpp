@@ -118,6 +118,24 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
         m_opcodeHistory.resize(20);
 }
 
+void WorldSocket::SendPacket(std::shared_ptr<WorldPacket const> const& pct)
+{
+    if (IsClosed())
+        return;
+
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, false);
+
+    ServerPktHeader header(pct->size() + 2, pct->GetOpcode());
+    m_crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
+
+    Write(reinterpret_cast<const char*>(&header.header), header.getHeaderLength(), pct);
+
+    m_opcodeHistory.push_front(uint32(pct->GetOpcode()));
+    if (m_opcodeHistory.size() > 50)
+        m_opcodeHistory.resize(20);
+}
+
 bool WorldSocket::Open()
 {
     if (!Socket::Open())
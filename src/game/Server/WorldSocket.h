@@ -128,6 +128,8 @@ class WorldSocket : public MaNGOS::Socket
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct, bool immediate = false);
+        // the payload is referenced by the out buffer instead of copied, only the header is built per socket
+        void SendPacket(std::shared_ptr<WorldPacket const> const& pct);
 
         void FinalizeSession() { m_session = nullptr; }
 
@@ -0,0 +1,321 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Social/WhoListIndex.h"
+#include "Policies/Singleton.h"
+#include "Entities/Player.h"
+#include "Guilds/GuildMgr.h"
+#include "Server/WorldSession.h"
+#include "Server/DBCStores.h"
+#include "World/World.h"
+#include "Util.h"
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(WhoListIndex);
+
+static void SetLowerName(std::string const& name, std::wstring& wname)
+{
+    if (!Utf8toWStr(name, wname))
+        wname.clear();
+    wstrToLower(wname);
+}
+
+void WhoListIndex::AddPlayer(Player* player)
+{
+    WhoListEntry entry;
+    entry.player = player;
+    entry.name = player->GetName();
+    SetLowerName(entry.name, entry.wname);
+    entry.guildId = player->GetGuildId();
+    entry.guildName = sGuildMgr.GetGuildNameById(entry.guildId);
+    SetLowerName(entry.guildName, entry.wguildName);
+    entry.level = std::min(player->getLevel(), uint32(STRONG_MAX_LEVEL));
+    entry.zoneId = player->GetCachedZoneId();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto result = m_entries.emplace(player->GetGUIDLow(), entry);
+    if (!result.second)
+    {
+        Unlink(result.first->second);
+        result.first->second = entry;
+    }
+    Link(result.first->second);
+}
+
+void WhoListIndex::RemovePlayer(Player* player)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_entries.find(player->GetGUIDLow());
+    if (itr == m_entries.end())
+        return;
+
+    Unlink(itr->second);
+    m_entries.erase(itr);
+}
+
+void WhoListIndex::UpdateLevel(Player* player, uint32 level)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_entries.find(player->GetGUIDLow());
+    if (itr == m_entries.end())
+        return;
+
+    Unlink(itr->second);
+    itr->second.level = std::min(level, uint32(STRONG_MAX_LEVEL));
+    Link(itr->second);
+}
+
+void WhoListIndex::UpdateZone(Player* player, uint32 zoneId)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_entries.find(player->GetGUIDLow());
+    if (itr == m_entries.end() || itr->second.zoneId == zoneId)
+        return;
+
+    Unlink(itr->second);
+    itr->second.zoneId = zoneId;
+    Link(itr->second);
+}
+
+void WhoListIndex::UpdateGuild(Player* player, uint32 guildId)
+{
+    // guild names never change, only look up a new one
+    std::string guildName = sGuildMgr.GetGuildNameById(guildId);
+    std::wstring wguildName;
+    SetLowerName(guildName, wguildName);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_entries.find(player->GetGUIDLow());
+    if (itr == m_entries.end())
+        return;
+
+    itr->second.guildId = guildId;
+    itr->second.guildName = guildName;
+    itr->second.wguildName = wguildName;
+}
+
+void WhoListIndex::Unlink(WhoListEntry& entry)
+{
+    m_byLevel[entry.level].erase(&entry);
+
+    auto itr = m_byZone.find(entry.zoneId);
+    if (itr != m_byZone.end())
+    {
+        itr->second.erase(&entry);
+        if (itr->second.empty())
+            m_byZone.erase(itr);
+    }
+}
+
+void WhoListIndex::Link(WhoListEntry& entry)
+{
+    m_byLevel[entry.level].insert(&entry);
+    m_byZone[entry.zoneId].insert(&entry);
+}
+
+void WhoListIndex::BuildWhoList(WorldSession* session, WhoListQuery& query, WorldPacket& data)
+{
+    Player* requester = session->GetPlayer();
+    Team team = requester->GetTeam();
+    uint32 security = session->GetSecurity();
+    bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
+    AccountTypes gmLevelInWhoList = (AccountTypes)sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST);
+    LocaleConstant locale = session->GetSessionDbcLocale();
+
+    std::sort(query.zoneIds.begin(), query.zoneIds.end());
+    query.zoneIds.erase(std::unique(query.zoneIds.begin(), query.zoneIds.end()), query.zoneIds.end());
+    std::sort(query.strings.begin(), query.strings.end());
+
+    // players only differ in team and locale for the same query, gm results depend on their own security
+    std::wstring cacheKey;
+    uint32 now = World::GetCurrentMSTime();
+    if (security == SEC_PLAYER)
+    {
+        cacheKey = std::to_wstring(allowTwoSideWhoList ? 0 : uint32(team)) + L'|' + std::to_wstring(uint32(locale)) + L'|' +
+                   std::to_wstring(query.levelMin) + L'|' + std::to_wstring(query.levelMax) + L'|' +
+                   std::to_wstring(query.raceMask) + L'|' + std::to_wstring(query.classMask) + L'|';
+        for (uint32 zoneId : query.zoneIds)
+            cacheKey += std::to_wstring(zoneId) + L',';
+        cacheKey += L'|' + query.playerName + L'|' + query.guildName;
+        for (std::wstring const& str : query.strings)
+            cacheKey += L'|' + str;
+
+        auto itr = m_responses.find(cacheKey);
+        if (itr != m_responses.end() && WorldTimer::getMSTimeDiff(itr->second.createTime, now) < WHO_LIST_CACHE_TIME)
+        {
+            data = itr->second.packet;
+            return;
+        }
+    }
+
+    uint32 matchcount = 0;
+    uint32 displaycount = 0;
+
+    data.Initialize(SMSG_WHO, 50);                          // guess size
+    data << uint32(matchcount);                             // placeholder, count of players matching criteria
+    data << uint32(displaycount);                           // placeholder, count of players displayed
+
+    std::unordered_map<uint32, bool> zoneNameMatches;       // any user string fits the zone name
+    auto visit = [&](WhoListEntry const& entry)
+    {
+        Player* pl = entry.player;
+        if (security == SEC_PLAYER)
+        {
+            // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
+            if (pl->GetTeam() != team && !allowTwoSideWhoList)
+                return;
+
+            // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
+            if (pl->GetSession()->GetSecurity() > gmLevelInWhoList)
+                return;
+        }
+
+        // do not process players which are not in world
+        if (!pl->IsInWorld())
+            return;
+
+        // check if target is globally visible for player
+        if (!pl->IsVisibleGloballyFor(requester))
+            return;
+
+        // check if target's level is in level range
+        if (entry.level < query.levelMin || entry.level > query.levelMax)
+            return;
+
+        // check if class matches classmask
+        uint32 class_ = pl->getClass();
+        if (!(query.classMask & (1 << class_)))
+            return;
+
+        // check if race matches racemask
+        uint32 race = pl->getRace();
+        if (!(query.raceMask & (1 << race)))
+            return;
+
+        if (!query.zoneIds.empty() && !std::binary_search(query.zoneIds.begin(), query.zoneIds.end(), entry.zoneId))
+            return;
+
+        if (!query.playerName.empty() && entry.wname.find(query.playerName) == std::wstring::npos)
+            return;
+
+        if (!query.guildName.empty() && entry.wguildName.find(query.guildName) == std::wstring::npos)
+            return;
+
+        if (!query.strings.empty())
+        {
+            bool s_show = false;
+            for (std::wstring const& str : query.strings)
+            {
+                if (entry.wguildName.find(str) != std::wstring::npos || entry.wname.find(str) != std::wstring::npos)
+                {
+                    s_show = true;
+                    break;
+                }
+            }
+
+            if (!s_show)
+            {
+                auto itr = zoneNameMatches.find(entry.zoneId);
+                if (itr == zoneNameMatches.end())
+                {
+                    bool fits = false;
+                    if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(entry.zoneId))
+                    {
+                        std::string aname = areaEntry->area_name[locale];
+                        for (std::wstring const& str : query.strings)
+                        {
+                            if (Utf8FitTo(aname, str))
+                            {
+                                fits = true;
+                                break;
+                            }
+                        }
+                    }
+                    itr = zoneNameMatches.emplace(entry.zoneId, fits).first;
+                }
+
+                if (!itr->second)
+                    return;
+            }
+        }
+
+        // 49 is maximum player count sent to client
+        if (++matchcount > 49)
+            return;
+
+        ++displaycount;
+
+        data << entry.name;                                 // player name
+        data << entry.guildName;                            // guild name
+        data << uint32(entry.level);                        // player level
+        data << uint32(class_);                             // player class
+        data << uint32(race);                               // player race
+        data << uint8(pl->getGender());                     // player gender
+        data << uint32(entry.zoneId);                       // player zone id
+    };
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        // candidates from the smallest bucket set the query allows
+        if (!query.zoneIds.empty())
+        {
+            for (uint32 zoneId : query.zoneIds)
+            {
+                auto itr = m_byZone.find(zoneId);
+                if (itr != m_byZone.end())
+                    for (WhoListEntry const* entry : itr->second)
+                        visit(*entry);
+            }
+        }
+        else if (query.levelMin > 1 || query.levelMax < STRONG_MAX_LEVEL)
+        {
+            for (uint32 level = query.levelMin; level <= query.levelMax && level <= STRONG_MAX_LEVEL; ++level)
+                for (WhoListEntry const* entry : m_byLevel[level])
+                    visit(*entry);
+        }
+        else
+        {
+            for (auto const& itr : m_entries)
+                visit(itr.second);
+        }
+    }
+
+    if (sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS) && matchcount > sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS))
+        matchcount = sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS);
+
+    data.put(0, displaycount);                              // insert right count, count displayed
+    data.put(4, matchcount);                                // insert right count, count of matches
+
+    if (!cacheKey.empty())
+    {
+        // drop expired responses, addons repeat few distinct queries so the map stays small
+        for (auto itr = m_responses.begin(); itr != m_responses.end();)
+        {
+            if (WorldTimer::getMSTimeDiff(itr->second.createTime, now) >= WHO_LIST_CACHE_TIME)
+                itr = m_responses.erase(itr);
+            else
+                ++itr;
+        }
+
+        CachedResponse& response = m_responses[cacheKey];
+        response.createTime = now;
+        response.packet = data;
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WHOLISTINDEX_H
+#define MANGOS_WHOLISTINDEX_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Server/DBCEnums.h"
+#include "WorldPacket.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+class Player;
+class WorldSession;
+
+// how long a /who response of a player account is reused for the same query
+#define WHO_LIST_CACHE_TIME (2 * IN_MILLISECONDS)
+
+/// Search data of one online player, names are kept lower case for the matching
+struct WhoListEntry
+{
+    Player* player;
+    std::string name;
+    std::wstring wname;
+    uint32 guildId;
+    std::string guildName;
+    std::wstring wguildName;
+    uint32 level;
+    uint32 zoneId;
+};
+
+/// Normalized CMSG_WHO filter, strings are lower case and empty ones dropped
+struct WhoListQuery
+{
+    uint32 levelMin;
+    uint32 levelMax;
+    uint32 raceMask;
+    uint32 classMask;
+    std::vector<uint32> zoneIds;
+    std::wstring playerName;
+    std::wstring guildName;
+    std::vector<std::wstring> strings;
+};
+
+/**
+ * Index of online players for the /who search.
+ * Players are bucketed by level and zone, so typical queries only look at a small candidate set, and names
+ * are converted once at login instead of on every query. Kept up to date on login/logout, level, zone and
+ * guild changes, which may happen in map worker threads; queries run in the world thread.
+ * Responses to player accounts are additionally cached per query for WHO_LIST_CACHE_TIME.
+ */
+class WhoListIndex
+{
+    public:
+        void AddPlayer(Player* player);
+        void RemovePlayer(Player* player);
+        void UpdateLevel(Player* player, uint32 level);
+        void UpdateZone(Player* player, uint32 zoneId);
+        void UpdateGuild(Player* player, uint32 guildId);
+
+        // world thread
+        void BuildWhoList(WorldSession* session, WhoListQuery& query, WorldPacket& data);
+
+    private:
+        typedef std::unordered_set<WhoListEntry*> WhoListBucket;
+
+        void Unlink(WhoListEntry& entry);
+        void Link(WhoListEntry& entry);
+
+        std::mutex m_lock;
+        std::unordered_map<uint32, WhoListEntry> m_entries;   // by player low guid
+        WhoListBucket m_byLevel[STRONG_MAX_LEVEL + 1];
+        std::unordered_map<uint32, WhoListBucket> m_byZone;
+
+        struct CachedResponse
+        {
+            uint32 createTime;
+            WorldPacket packet;
+        };
+        std::unordered_map<std::wstring, CachedResponse> m_responses;  // world thread only
+};
+
+#define sWhoListIndex MaNGOS::Singleton<WhoListIndex>::Instance()
+
+#endif
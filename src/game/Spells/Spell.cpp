@@ -48,6 +48,7 @@
 #include "MotionGenerators/PathFinder.h"
 #include "Spells/Scripts/SpellScript.h"
 #include "Entities/ObjectGuid.h"
+#include "Memory/SlabPool.h"
 
 extern pEffect SpellEffects[MAX_SPELL_EFFECTS];
 
@@ -405,6 +406,23 @@ void SpellLog::SendToSet()
 // Spell class
 // ***********
 
+// Pool is intentionally never destroyed, spells may still be freed during static destruction at shutdown
+static MaNGOS::SlabPool& GetSpellPool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("Spell", sizeof(Spell));
+    return *pool;
+}
+
+void* Spell::operator new(size_t size)
+{
+    return GetSpellPool().Allocate(size);
+}
+
+void Spell::operator delete(void* ptr, size_t size)
+{
+    GetSpellPool().Deallocate(ptr, size);
+}
+
 Spell::Spell(Unit* caster, SpellEntry const* info, uint32 triggeredFlags, ObjectGuid originalCasterGUID, SpellEntry const* triggeredBy) :
     m_spellLog(this), m_spellScript(SpellScriptMgr::GetSpellScript(info->Id))
 {
@@ -1249,7 +1267,7 @@ void Spell::DoAllEffectOnTarget(TargetInfo* target)
         if (m_spellInfo->SpellFamilyName == SPELLFAMILY_WARLOCK && m_spellInfo->SpellIconID == 3172 &&
             (m_spellInfo->SpellFamilyFlags & uint64(0x0004000000000000)))
             if (Aura* dummy = unitTarget->GetDummyAura(m_spellInfo->Id))
-                dummy->GetModifier()->m_amount = spellDamageInfo.damage;
+                dummy->SetAmount(spellDamageInfo.damage);
     }
     // Passive spell hits/misses or active spells only misses (only triggers if proc flags set)
     else if (procAttacker || procVictim)
@@ -448,6 +448,10 @@ class Spell
         Spell(Unit* caster, SpellEntry const* info, uint32 triggeredFlags, ObjectGuid originalCasterGUID = ObjectGuid(), SpellEntry const* triggeredBy = nullptr);
         ~Spell();
 
+        // spells are allocated from a dedicated slab pool, see Spell.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         SpellCastResult SpellStart(SpellCastTargets const* targets, Aura* triggeredByAura = nullptr);
 
         void cancel();
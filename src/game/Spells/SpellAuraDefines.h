@@ -20,6 +20,7 @@
 #define MANGOS_SPELLAURADEFINES_H
 
 #define MAX_AURAS 64                                        // client support up to 255, but it will cause problems with group auras updating
+#define NULL_AURA_SLOT 0xFF
 
 enum AuraFlags
 {
@@ -50,8 +50,7 @@
 #include "Entities/TemporarySpawn.h"
 #include "Maps/InstanceData.h"
 #include "AI/ScriptDevAI/include/sc_grid_searchers.h"
-
-#define NULL_AURA_SLOT 0xFF
+#include "Memory/SlabPool.h"
 
 /**
  * An array with all the different handlers for taking care of
@@ -560,6 +559,40 @@ SpellAuraHolder* CreateSpellAuraHolder(SpellEntry const* spellproto, Unit* targe
     return new SpellAuraHolder(spellproto, target, caster, castItem, triggeredBy);
 }
 
+// Pools are intentionally never destroyed, holders and auras may still be freed during static destruction at shutdown
+static MaNGOS::SlabPool& GetAuraPool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("Aura",
+        std::max({ sizeof(Aura), sizeof(AreaAura), sizeof(PersistentAreaAura), sizeof(SingleEnemyTargetAura), sizeof(GameObjectAura) }));
+    return *pool;
+}
+
+static MaNGOS::SlabPool& GetSpellAuraHolderPool()
+{
+    static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("SpellAuraHolder", sizeof(SpellAuraHolder));
+    return *pool;
+}
+
+void* Aura::operator new(size_t size)
+{
+    return GetAuraPool().Allocate(size);
+}
+
+void Aura::operator delete(void* ptr, size_t size)
+{
+    GetAuraPool().Deallocate(ptr, size);
+}
+
+void* SpellAuraHolder::operator new(size_t size)
+{
+    return GetSpellAuraHolderPool().Allocate(size);
+}
+
+void SpellAuraHolder::operator delete(void* ptr, size_t size)
+{
+    GetSpellAuraHolderPool().Deallocate(ptr, size);
+}
+
 void Aura::SetModifier(AuraType type, int32 amount, uint32 periodicTime, int32 miscValue)
 {
     m_modifier.m_auraname = type;
@@ -569,6 +602,15 @@ void Aura::SetModifier(AuraType type, int32 amount, uint32 periodicTime, int32 m
     m_modifier.periodictime = periodicTime;
 }
 
+void Aura::SetAmount(int32 amount)
+{
+    if (m_modifier.m_amount == amount)
+        return;
+
+    m_modifier.m_amount = amount;
+    GetTarget()->InvalidateAuraModifierTotals();
+}
+
 void Aura::Update(uint32 diff)
 {
     if (m_isPeriodic)
@@ -930,7 +972,7 @@ void Aura::UpdateAuraScaling()
             if (IsAuraRemoveOnStacking(this->GetSpellProto(), GetEffIndex()))
                 ApplyModifier(false, true);
             GetModifier()->m_recentAmount = amount - GetModifier()->m_amount;
-            GetModifier()->m_amount = amount;
+            SetAmount(amount);
             ApplyModifier(true, true);
         }
     }
@@ -1820,7 +1862,7 @@ void Aura::TriggerSpell()
                             {
                                 UnitMods unitMod = UnitMods(UNIT_MOD_POWER_START + m_modifier.m_miscvalue);
                                 GetTarget()->HandleStatModifier(unitMod, TOTAL_PCT, float(aura->m_modifier.m_amount), false);
-                                aura->m_modifier.m_amount -= 5;
+                                aura->SetAmount(aura->GetModifier()->m_amount - 5);
                                 GetTarget()->HandleStatModifier(unitMod, TOTAL_PCT, float(aura->m_modifier.m_amount), true);
                             }
                         }
@@ -2043,14 +2085,14 @@ void Aura::TriggerSpell()
                         // Reset reapply counter at move
                         if (triggerTarget->IsMoving())
                         {
-                            m_modifier.m_amount = 6;
+                            SetAmount(6);
                             return;
                         }
 
                         // We are standing at the moment
                         if (m_modifier.m_amount > 0)
                         {
-                            --m_modifier.m_amount;
+                            SetAmount(m_modifier.m_amount - 1);
                             return;
                         }
 
@@ -3081,8 +3123,8 @@ void Aura::HandleAuraDummy(bool apply, bool Real)
                     {
                         if (Unit* caster = GetCaster())
                         {
-                            m_modifier.m_amount = caster->SpellHealingBonusDone(target, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE);
-                            m_modifier.m_amount = target->SpellHealingBonusTaken(caster, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE);
+                            SetAmount(caster->SpellHealingBonusDone(target, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE));
+                            SetAmount(target->SpellHealingBonusTaken(caster, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE));
                         }
                     }
                     return;
@@ -3699,12 +3741,12 @@ void Aura::HandleAuraDummy(bool apply, bool Real)
                         InstanceData* data = target->GetInstanceData();
                         if (data)
                         {
-                            m_modifier.m_amount = target->GetInstanceData()->GetData(6);
+                            SetAmount(target->GetInstanceData()->GetData(6));
                             target->GetInstanceData()->SetData(6, m_modifier.m_amount + 1);
-                            m_modifier.m_amount += 1018;
+                            SetAmount(m_modifier.m_amount + 1018);
                         }
                         else
-                            m_modifier.m_amount = 1018;
+                            SetAmount(1018);
                     }
 
                     ReputationRank faction_rank = ReputationRank(1); // value taken from sniff
@@ -3909,7 +3951,7 @@ void Aura::HandleAuraDummy(bool apply, bool Real)
             {
                 // NOTE: for avoid use additional field damage stored in dummy value (replace unused 100%
                 if (apply)
-                    m_modifier.m_amount = 0;                // use value as damage counter instead redundant 100% percent
+                    SetAmount(0);                // use value as damage counter instead redundant 100% percent
                 else
                 {
                     int32 bp0 = m_modifier.m_amount;
@@ -3962,8 +4004,8 @@ void Aura::HandleAuraDummy(bool apply, bool Real)
                         // prevent double apply bonuses
                         if (target->GetTypeId() != TYPEID_PLAYER || !((Player*)target)->GetSession()->PlayerLoading())
                         {
-                            m_modifier.m_amount = caster->SpellHealingBonusDone(target, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE);
-                            m_modifier.m_amount = target->SpellHealingBonusTaken(caster, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE);
+                            SetAmount(caster->SpellHealingBonusDone(target, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE));
+                            SetAmount(target->SpellHealingBonusTaken(caster, GetSpellProto(), m_modifier.m_amount, SPELL_DIRECT_DAMAGE));
                         }
                     }
                 }
@@ -4211,7 +4253,7 @@ void Aura::HandleAuraMounted(bool apply, bool Real)
         if (minfo)
             display_id = minfo->modelid;
 
-        m_modifier.m_amount = display_id;
+        SetAmount(display_id);
 
         target->Mount(display_id, this);
 
@@ -4306,28 +4348,28 @@ void Aura::HandleAuraModShapeshift(bool apply, bool Real)
         // since no field in creature_templates describes wether an alliance or
         // horde modelid should be used at shapeshifting
         if (target->GetTypeId() != TYPEID_PLAYER)
-            m_modifier.m_amount = ssEntry->modelID_A;
+            SetAmount(ssEntry->modelID_A);
         else
         {
             // players are a bit different since the dbc has seldomly an horde modelid
             if (Player::TeamForRace(target->getRace()) == HORDE)
             {
                 if (ssEntry->modelID_H)
-                    m_modifier.m_amount = ssEntry->modelID_H;           // 3.2.3 only the moonkin form has this information
+                    SetAmount(ssEntry->modelID_H);           // 3.2.3 only the moonkin form has this information
                 else                                        // get model for race
-                    m_modifier.m_amount = sObjectMgr.GetModelForRace(ssEntry->modelID_A, target->getRaceMask());
+                    SetAmount(sObjectMgr.GetModelForRace(ssEntry->modelID_A, target->getRaceMask()));
             }
 
             // nothing found in above, so use default
             if (!m_modifier.m_amount)
-                m_modifier.m_amount = ssEntry->modelID_A;
+                SetAmount(ssEntry->modelID_A);
         }
     }
 
     switch (GetId())
     {
         case 35200: // Roc Form
-            m_modifier.m_amount = 4877;
+            SetAmount(4877);
             break;
     }
 
@@ -4384,7 +4426,7 @@ void Aura::HandleAuraModShapeshift(bool apply, bool Real)
             {
                 if (Aura* threatAura = defianceHolder->m_auras[0])
                 {
-                    threatAura->GetModifier()->m_amount = apply ? threatAura->GetModifier()->m_baseAmount : 0;
+                    threatAura->SetAmount(apply ? threatAura->GetModifier()->m_baseAmount : 0);
                     for (int8 x = 0; x < MAX_SPELL_SCHOOL; ++x)
                         if (threatAura->GetModifier()->m_miscvalue & int32(1 << x))
                             ApplyPercentModFloatVar(target->m_threatModifier[x], float(threatAura->GetModifier()->m_baseAmount), apply);
@@ -4583,51 +4625,51 @@ void Aura::HandleAuraTransform(bool apply, bool Real)
                     switch (orb_model)
                     {
                         // Troll Female
-                        case 1479: m_modifier.m_amount = 10134; break;
+                        case 1479: SetAmount(10134); break;
                         // Troll Male
-                        case 1478: m_modifier.m_amount = 10135; break;
+                        case 1478: SetAmount(10135); break;
                         // Tauren Male
-                        case 59:   m_modifier.m_amount = 10136; break;
+                        case 59:   SetAmount(10136); break;
                         // Human Male
-                        case 49:   m_modifier.m_amount = 10137; break;
+                        case 49:   SetAmount(10137); break;
                         // Human Female
-                        case 50:   m_modifier.m_amount = 10138; break;
+                        case 50:   SetAmount(10138); break;
                         // Orc Male
-                        case 51:   m_modifier.m_amount = 10139; break;
+                        case 51:   SetAmount(10139); break;
                         // Orc Female
-                        case 52:   m_modifier.m_amount = 10140; break;
+                        case 52:   SetAmount(10140); break;
                         // Dwarf Male
-                        case 53:   m_modifier.m_amount = 10141; break;
+                        case 53:   SetAmount(10141); break;
                         // Dwarf Female
-                        case 54:   m_modifier.m_amount = 10142; break;
+                        case 54:   SetAmount(10142); break;
                         // NightElf Male
-                        case 55:   m_modifier.m_amount = 10143; break;
+                        case 55:   SetAmount(10143); break;
                         // NightElf Female
-                        case 56:   m_modifier.m_amount = 10144; break;
+                        case 56:   SetAmount(10144); break;
                         // Undead Female
-                        case 58:   m_modifier.m_amount = 10145; break;
+                        case 58:   SetAmount(10145); break;
                         // Undead Male
-                        case 57:   m_modifier.m_amount = 10146; break;
+                        case 57:   SetAmount(10146); break;
                         // Tauren Female
-                        case 60:   m_modifier.m_amount = 10147; break;
+                        case 60:   SetAmount(10147); break;
                         // Gnome Male
-                        case 1563: m_modifier.m_amount = 10148; break;
+                        case 1563: SetAmount(10148); break;
                         // Gnome Female
-                        case 1564: m_modifier.m_amount = 10149; break;
+                        case 1564: SetAmount(10149); break;
                         // BloodElf Female
-                        case 15475: m_modifier.m_amount = 17830; break;
+                        case 15475: SetAmount(17830); break;
                         // BloodElf Male
-                        case 15476: m_modifier.m_amount = 17829; break;
+                        case 15476: SetAmount(17829); break;
                         // Dranei Female
-                        case 16126: m_modifier.m_amount = 17828; break;
+                        case 16126: SetAmount(17828); break;
                         // Dranei Male
-                        case 16125: m_modifier.m_amount = 17827; break;
+                        case 16125: SetAmount(17827); break;
                         default: break;
                     }
                     break;
                 }
                 case 42365:                                 // Murloc costume
-                    m_modifier.m_amount = 21723;
+                    SetAmount(21723);
                     break;
                 // case 44186:                          // Gossip NPC Appearance - All, Brewfest
                 // break;
@@ -4642,37 +4684,37 @@ void Aura::HandleAuraTransform(bool apply, bool Real)
                     switch (race)
                     {
                         case RACE_HUMAN:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25037 : 25048;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25037 : 25048);
                             break;
                         case RACE_ORC:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25039 : 25050;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25039 : 25050);
                             break;
                         case RACE_DWARF:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25034 : 25045;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25034 : 25045);
                             break;
                         case RACE_NIGHTELF:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25038 : 25049;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25038 : 25049);
                             break;
                         case RACE_UNDEAD:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25042 : 25053;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25042 : 25053);
                             break;
                         case RACE_TAUREN:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25040 : 25051;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25040 : 25051);
                             break;
                         case RACE_GNOME:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25035 : 25046;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25035 : 25046);
                             break;
                         case RACE_TROLL:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25041 : 25052;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25041 : 25052);
                             break;
                         case RACE_GOBLIN:                   // not really player race (3.x), but model exist
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25036 : 25047;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25036 : 25047);
                             break;
                         case RACE_BLOODELF:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25032 : 25043;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25032 : 25043);
                             break;
                         case RACE_DRAENEI:
-                            m_modifier.m_amount = target->getGender() == GENDER_MALE ? 25033 : 25044;
+                            SetAmount(target->getGender() == GENDER_MALE ? 25033 : 25044);
                             break;
                     }
                     break;
@@ -4697,11 +4739,11 @@ void Aura::HandleAuraTransform(bool apply, bool Real)
                     switch (target->getGender())
                     {
                         case GENDER_MALE:
-                            m_modifier.m_amount = 29203;    // Chapman
+                            SetAmount(29203);    // Chapman
                             break;
                         case GENDER_FEMALE:
                         case GENDER_NONE:
-                            m_modifier.m_amount = 29204;    // Catrina
+                            SetAmount(29204);    // Catrina
                             break;
                     }
                     break;
@@ -4727,37 +4769,37 @@ void Aura::HandleAuraTransform(bool apply, bool Real)
                     switch (target->getRace())
                     {
                         case RACE_HUMAN:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25037 : 25048;
+                            SetAmount(roll_chance_i(50) ? 25037 : 25048);
                             break;
                         case RACE_ORC:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25039 : 25050;
+                            SetAmount(roll_chance_i(50) ? 25039 : 25050);
                             break;
                         case RACE_DWARF:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25034 : 25045;
+                            SetAmount(roll_chance_i(50) ? 25034 : 25045);
                             break;
                         case RACE_NIGHTELF:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25038 : 25049;
+                            SetAmount(roll_chance_i(50) ? 25038 : 25049);
                             break;
                         case RACE_UNDEAD:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25042 : 25053;
+                            SetAmount(roll_chance_i(50) ? 25042 : 25053);
                             break;
                         case RACE_TAUREN:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25040 : 25051;
+                            SetAmount(roll_chance_i(50) ? 25040 : 25051);
                             break;
                         case RACE_GNOME:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25035 : 25046;
+                            SetAmount(roll_chance_i(50) ? 25035 : 25046);
                             break;
                         case RACE_TROLL:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25041 : 25052;
+                            SetAmount(roll_chance_i(50) ? 25041 : 25052);
                             break;
                         case RACE_GOBLIN:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25036 : 25047;
+                            SetAmount(roll_chance_i(50) ? 25036 : 25047);
                             break;
                         case RACE_BLOODELF:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25032 : 25043;
+                            SetAmount(roll_chance_i(50) ? 25032 : 25043);
                             break;
                         case RACE_DRAENEI:
-                            m_modifier.m_amount = roll_chance_i(50) ? 25033 : 25044;
+                            SetAmount(roll_chance_i(50) ? 25033 : 25044);
                             break;
                     }
 
@@ -4765,7 +4807,7 @@ void Aura::HandleAuraTransform(bool apply, bool Real)
                 }
                 case 65529:                                 // Gossip NPC Appearance - Day of the Dead (DotD)
                     // random, regardless of current gender
-                    m_modifier.m_amount = roll_chance_i(50) ? 29203 : 29204;
+                    SetAmount(roll_chance_i(50) ? 29203 : 29204);
                     break;
                 // case 66236:                          // Incinerate Flesh
                 // break;
@@ -4776,7 +4818,7 @@ void Aura::HandleAuraTransform(bool apply, bool Real)
                 // case 71309:                          // [DND] Spawn Portal
                 // break;
                 case 71450:                                 // Crown Parcel Service Uniform
-                    m_modifier.m_amount = target->getGender() == GENDER_MALE ? 31002 : 31003;
+                    SetAmount(target->getGender() == GENDER_MALE ? 31002 : 31003);
                     break;
                 // case 75531:                          // Gnomeregan Pride
                 // break;
@@ -4792,17 +4834,17 @@ void Aura::HandleAuraTransform(bool apply, bool Real)
             CreatureInfo const* cInfo = ObjectMgr::GetCreatureTemplate(m_modifier.m_miscvalue);
             if (!cInfo)
             {
-                m_modifier.m_amount = 16358;                           // pig pink ^_^
+                SetAmount(16358);                           // pig pink ^_^
                 sLog.outError("Auras: unknown creature id = %d (only need its modelid) Form Spell Aura Transform in Spell ID = %d", m_modifier.m_amount, GetId());
             }
             else
-                m_modifier.m_amount = Creature::ChooseDisplayId(cInfo);   // Will use the default model here
+                SetAmount(Creature::ChooseDisplayId(cInfo));   // Will use the default model here
 
             // Polymorph (sheep/penguin case)
             if (GetSpellProto()->SpellFamilyName == SPELLFAMILY_MAGE && GetSpellProto()->SpellIconID == 82)
                 if (Unit* caster = GetCaster())
                     if (caster->HasAura(52648))             // Glyph of the Penguin
-                        m_modifier.m_amount = 26452;
+                        SetAmount(26452);
 
             // creature case, need to update equipment if additional provided
             if (cInfo && target->GetTypeId() == TYPEID_UNIT)
@@ -5810,12 +5852,12 @@ void Aura::HandleModThreat(bool apply, bool Real)
         case 12788:
         case 12789:
             if (target->GetShapeshiftForm() != FORM_DEFENSIVESTANCE)
-                m_modifier.m_amount = 0;
+                SetAmount(0);
             break;
     }
 
     if (level_diff > 0)
-        m_modifier.m_amount += multiplier * level_diff;
+        SetAmount(m_modifier.m_amount + (multiplier * level_diff));
 
     for (int8 x = 0; x < MAX_SPELL_SCHOOL; ++x)
         if (m_modifier.m_miscvalue & int32(1 << x))
@@ -5945,7 +5987,7 @@ void Aura::HandleAuraModIncreaseFlightSpeed(bool apply, bool Real)
                         int32 mountSpeed = spellInfo->CalculateSimpleValue(SpellEffectIndex(i));
                         if (mountSpeed > m_modifier.m_amount)
                         {
-                            m_modifier.m_amount = mountSpeed;
+                            SetAmount(mountSpeed);
                             changedSpeed = true;
                             break;
                         }
@@ -6426,7 +6468,7 @@ void Aura::HandlePeriodicEnergize(bool apply, bool Real)
             case 54833:                                     // Glyph of Innervate (value%/2 of casters base mana)
             {
                 if (Unit* caster = GetCaster())
-                    m_modifier.m_amount = int32(caster->GetCreateMana() * GetBasePoints() / (200 * GetAuraMaxTicks()));
+                    SetAmount(int32(caster->GetCreateMana() * GetBasePoints() / (200 * GetAuraMaxTicks())));
                 break;
             }
             case 29166:                                     // Innervate (value% of casters base mana)
@@ -6437,16 +6479,16 @@ void Aura::HandlePeriodicEnergize(bool apply, bool Real)
                     if (caster->HasAura(54832))
                         caster->CastSpell(caster, 54833, TRIGGERED_OLD_TRIGGERED, nullptr, this);
 
-                    m_modifier.m_amount = int32(caster->GetCreateMana() * GetBasePoints() / (100 * GetAuraMaxTicks()));
+                    SetAmount(int32(caster->GetCreateMana() * GetBasePoints() / (100 * GetAuraMaxTicks())));
                 }
                 break;
             }
             case 48391:                                     // Owlkin Frenzy 2% base mana
-                m_modifier.m_amount = target->GetCreateMana() * 2 / 100;
+                SetAmount(target->GetCreateMana() * 2 / 100);
                 break;
             case 57669:                                     // Replenishment (0.2% from max)
             case 61782:                                     // Infinite Replenishment
-                m_modifier.m_amount = target->GetMaxPower(POWER_MANA) * 2 / 1000;
+                SetAmount(target->GetMaxPower(POWER_MANA) * 2 / 1000);
                 break;
             default:
                 break;
@@ -6466,7 +6508,7 @@ void Aura::HandlePrayerOfMending(bool apply, bool /*Real*/)
     if (apply) // only on initial cast apply SP
         if (const SpellEntry* entry = GetSpellProto())
             if (GetHolder()->GetAuraCharges() == entry->procCharges)
-                m_modifier.m_amount = GetCaster()->SpellHealingBonusDone(GetTarget(), GetSpellProto(), m_modifier.m_amount, HEAL);
+                SetAmount(GetCaster()->SpellHealingBonusDone(GetTarget(), GetSpellProto(), m_modifier.m_amount, HEAL));
 }
 
 void Aura::HandleAuraPeriodicDummy(bool apply, bool Real)
@@ -6596,7 +6638,7 @@ void Aura::HandleAuraPeriodicDummy(bool apply, bool Real)
             }
             // Explosive Shot
             if (apply && !loading && caster)
-                m_modifier.m_amount += int32(caster->GetTotalAttackPowerValue(RANGED_ATTACK) * 14 / 100);
+                SetAmount(m_modifier.m_amount + (int32(caster->GetTotalAttackPowerValue(RANGED_ATTACK) * 14 / 100)));
             break;
         }
     }
@@ -6631,19 +6673,19 @@ void Aura::HandlePeriodicHeal(bool apply, bool /*Real*/)
             if (holy < 0)
                 holy = 0;
             holy = int32(holy * 377 / 1000);
-            m_modifier.m_amount += ap > holy ? ap : holy;
+            SetAmount(m_modifier.m_amount + (ap > holy ? ap : holy));
         }
         // Lifeblood
         else if (GetSpellProto()->SpellIconID == 3088 && GetSpellProto()->SpellVisual[0] == 8145)
         {
             int32 healthBonus = int32(0.0032f * caster->GetMaxHealth());
-            m_modifier.m_amount += healthBonus;
+            SetAmount(m_modifier.m_amount + healthBonus);
         }
 
         switch (GetSpellProto()->Id)
         {
-            case 12939: m_modifier.m_amount = target->GetMaxHealth() / 3; break; // Polymorph Heal Effect
-            default: m_modifier.m_amount = caster->SpellHealingBonusDone(target, GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount()); break;
+            case 12939: SetAmount(target->GetMaxHealth() / 3); break; // Polymorph Heal Effect
+            default: SetAmount(caster->SpellHealingBonusDone(target, GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount())); break;
         }
 
         // Rejuvenation
@@ -6676,7 +6718,7 @@ void Aura::HandleDamagePercentTaken(bool apply, bool Real)
             // Glyph of Salvation
             if (target->GetObjectGuid() == GetCasterGuid())
                 if (Aura* aur = target->GetAura(63225, EFFECT_INDEX_0))
-                    m_modifier.m_amount -= aur->GetModifier()->m_amount;
+                    SetAmount(m_modifier.m_amount - aur->GetModifier()->m_amount);
         }
     }
     else
@@ -6720,11 +6762,11 @@ void Aura::HandlePeriodicDamage(bool apply, bool Real)
                     int32 mws = caster->GetAttackTime(BASE_ATTACK);
                     float mwb_min = caster->GetBaseWeaponDamage(BASE_ATTACK, MINDAMAGE);
                     float mwb_max = caster->GetBaseWeaponDamage(BASE_ATTACK, MAXDAMAGE);
-                    m_modifier.m_amount += int32(((mwb_min + mwb_max) / 2 + ap * mws / 14000) * 0.2f);
+                    SetAmount(m_modifier.m_amount + (int32(((mwb_min + mwb_max) / 2 + ap * mws / 14000) * 0.2f)));
                     // If used while target is above 75% health, Rend does 35% more damage
                     if (spellProto->CalculateSimpleValue(EFFECT_INDEX_1) != 0 &&
                             target->GetHealth() > target->GetMaxHealth() * spellProto->CalculateSimpleValue(EFFECT_INDEX_1) / 100)
-                        m_modifier.m_amount += m_modifier.m_amount * spellProto->CalculateSimpleValue(EFFECT_INDEX_2) / 100;
+                        SetAmount(m_modifier.m_amount + (m_modifier.m_amount * spellProto->CalculateSimpleValue(EFFECT_INDEX_2) / 100));
                 }
                 break;
             }
@@ -6745,11 +6787,11 @@ void Aura::HandlePeriodicDamage(bool apply, bool Real)
                     {
                         if (dummyAura->GetId() == 34241)
                         {
-                            m_modifier.m_amount += cp * dummyAura->GetModifier()->m_amount;
+                            SetAmount(m_modifier.m_amount + (cp * dummyAura->GetModifier()->m_amount));
                             break;
                         }
                     }
-                    m_modifier.m_amount += int32(caster->GetTotalAttackPowerValue(BASE_ATTACK) * cp / 100);
+                    SetAmount(m_modifier.m_amount + (int32(caster->GetTotalAttackPowerValue(BASE_ATTACK) * cp / 100)));
                 }
                 break;
             }
@@ -6768,7 +6810,7 @@ void Aura::HandlePeriodicDamage(bool apply, bool Real)
                     float AP_per_combo[6] = {0.0f, 0.015f, 0.024f, 0.03f, 0.03428571f, 0.0375f};
                     uint8 cp = caster->GetComboPoints();
                     if (cp > 5) cp = 5;
-                    m_modifier.m_amount += int32(caster->GetTotalAttackPowerValue(BASE_ATTACK) * AP_per_combo[cp]);
+                    SetAmount(m_modifier.m_amount + (int32(caster->GetTotalAttackPowerValue(BASE_ATTACK) * AP_per_combo[cp])));
                 }
                 break;
             }
@@ -6782,7 +6824,7 @@ void Aura::HandlePeriodicDamage(bool apply, bool Real)
                     int32 holy = caster->SpellBaseDamageBonusDone(GetSpellSchoolMask(spellProto));
                     if (holy < 0)
                         holy = 0;
-                    m_modifier.m_amount += int32(GetStackAmount()) * (int32(ap * 0.025f) + int32(holy * 13 / 1000));
+                    SetAmount(m_modifier.m_amount + (int32(GetStackAmount()) * (int32(ap * 0.025f) + int32(holy * 13 / 1000))));
                 }
                 break;
             }
@@ -6794,12 +6836,12 @@ void Aura::HandlePeriodicDamage(bool apply, bool Real)
         {
             // SpellDamageBonusDone for magic spells
             if (spellProto->DmgClass == SPELL_DAMAGE_CLASS_NONE || spellProto->DmgClass == SPELL_DAMAGE_CLASS_MAGIC)
-                m_modifier.m_amount = caster->SpellDamageBonusDone(target, GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount());
+                SetAmount(caster->SpellDamageBonusDone(target, GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount()));
             // MeleeDamagebonusDone for weapon based spells
             else
             {
                 WeaponAttackType attackType = GetWeaponAttackType(GetSpellProto());
-                m_modifier.m_amount = caster->MeleeDamageBonusDone(target, m_modifier.m_amount, attackType, SpellSchoolMask(spellProto->SchoolMask), spellProto, DOT, GetStackAmount());
+                SetAmount(caster->MeleeDamageBonusDone(target, m_modifier.m_amount, attackType, SpellSchoolMask(spellProto->SchoolMask), spellProto, DOT, GetStackAmount()));
             }
         }
     }
@@ -6863,7 +6905,7 @@ void Aura::HandlePeriodicLeech(bool apply, bool /*Real*/)
         if (!caster)
             return;
 
-        m_modifier.m_amount = caster->SpellDamageBonusDone(GetTarget(), GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount());
+        SetAmount(caster->SpellDamageBonusDone(GetTarget(), GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount()));
     }
 }
 
@@ -6901,7 +6943,7 @@ void Aura::HandlePeriodicHealthFunnel(bool apply, bool /*Real*/)
         if (!caster)
             return;
 
-        m_modifier.m_amount = caster->SpellDamageBonusDone(GetTarget(), GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount());
+        SetAmount(caster->SpellDamageBonusDone(GetTarget(), GetSpellProto(), m_modifier.m_amount, DOT, GetStackAmount()));
     }
 }
 
@@ -7043,7 +7085,7 @@ void Aura::HandleAuraModStat(bool apply, bool /*Real*/)
     // Holy Strength amount decrease by 4% each level after 60 From Crusader Enchant
     if (apply && GetId() == 20007)
         if (GetCaster()->GetTypeId() == TYPEID_PLAYER && GetCaster()->getLevel() > 60)
-            m_modifier.m_amount = int32(m_modifier.m_amount * (1 - (((float(GetCaster()->getLevel()) - 60) * 4) / 100)));
+            SetAmount(int32(m_modifier.m_amount * (1 - (((float(GetCaster()->getLevel()) - 60) * 4) / 100))));
 
     if (GetSpellProto()->IsFitToFamilyMask(0x0000000000008000)) // improved scorpid sting
     {
@@ -7336,7 +7378,7 @@ void Aura::HandleAuraModIncreaseHealth(bool apply, bool Real)
         case 55233:                                         // Vampiric Blood
         case 61254:                                         // Will of Sartharion (Obsidian Sanctum)
             if (Real && apply)
-                m_modifier.m_amount = target->GetMaxHealth() * m_modifier.m_amount / 100;
+                SetAmount(target->GetMaxHealth() * m_modifier.m_amount / 100);
         // no break here
 
         // Cases where m_amount already has the correct value (spells cast with CastCustomSpell or absolute values)
@@ -8506,7 +8548,7 @@ void Aura::HandleSchoolAbsorb(bool apply, bool Real)
 
             DoneActualBenefit *= caster->CalculateLevelPenalty(GetSpellProto());
 
-            m_modifier.m_amount += (int32)DoneActualBenefit;
+            SetAmount(m_modifier.m_amount + (int32)DoneActualBenefit);
         }
     }
     else
@@ -8652,16 +8694,16 @@ void Aura::PeriodicTick()
                 case 40932: // Agonizing Flames - Illidan
                 {
                     if (GetAuraTicks() % 3 == 0) // increased damage after every 3rd tick
-                        m_modifier.m_amount += m_modifier.m_baseAmount;
+                        SetAmount(m_modifier.m_amount + m_modifier.m_baseAmount);
                     break;
                 }
                 case 41337: // Aura of Anger
                 {
-                    m_modifier.m_amount += m_modifier.m_baseAmount;
+                    SetAmount(m_modifier.m_amount + m_modifier.m_baseAmount);
                     if (Aura* aura = GetHolder()->m_auras[EFFECT_INDEX_1])
                     {
                         aura->ApplyModifier(false, true);
-                        aura->m_modifier.m_amount += aura->m_modifier.m_baseAmount;
+                        aura->SetAmount(aura->GetModifier()->m_amount + aura->m_modifier.m_baseAmount);
                         aura->ApplyModifier(true, true);
                     }
                     // TODO: Reverify that during pally bubble DOT should not tick
@@ -9785,7 +9827,7 @@ void Aura::PeriodicDummyTick()
                 // Search SPELL_AURA_MOD_POWER_REGEN aura for this spell and add bonus
                 if (Aura* aura = GetHolder()->GetAuraByEffectIndex(SpellEffectIndex(GetEffIndex() - 1)))
                 {
-                    aura->GetModifier()->m_amount = m_modifier.m_amount;
+                    aura->SetAmount(m_modifier.m_amount);
                     ((Player*)target)->UpdateManaRegen();
                     // Disable continue
                     m_isPeriodic = false;
@@ -9953,9 +9995,7 @@ void Aura::PeriodicDummyTick()
                 if (slow)
                 {
                     slow->ApplyModifier(false, true);
-                    Modifier* mod = slow->GetModifier();
-                    mod->m_amount += m_modifier.m_amount;
-                    if (mod->m_amount > 0) mod->m_amount = 0;
+                    slow->SetAmount(std::min(slow->GetModifier()->m_amount + m_modifier.m_amount, 0));
                     slow->ApplyModifier(true, true);
                 }
                 return;
@@ -10048,7 +10088,7 @@ void Aura::HandleManaShield(bool apply, bool Real)
 
             DoneActualBenefit *= caster->CalculateLevelPenalty(GetSpellProto());
 
-            m_modifier.m_amount += (int32)DoneActualBenefit;
+            SetAmount(m_modifier.m_amount + (int32)DoneActualBenefit);
         }
     }
 }
@@ -10566,25 +10606,10 @@ void SpellAuraHolder::_AddSpellAuraHolder()
     if (!m_target)
         return;
 
-    // Try find slot for aura
-    uint8 slot = NULL_AURA_SLOT;
-
-    // Lookup free slot
-    if (m_target->GetVisibleAurasCount() < MAX_AURAS)
-    {
-        Unit::VisibleAuraMap const& visibleAuras = m_target->GetVisibleAuras();
-        for (uint8 i = 0; i < MAX_AURAS; ++i)
-        {
-            Unit::VisibleAuraMap::const_iterator itr = visibleAuras.find(i);
-            if (itr == visibleAuras.end())
-            {
-                slot = i;
-                // update for out of range group members (on 1 slot use)
-                m_target->UpdateAuraForGroup(slot);
-                break;
-            }
-        }
-    }
+    // Try find free slot for aura
+    uint8 slot = m_target->GetFreeVisibleAuraSlot();
+    if (slot != NULL_AURA_SLOT)
+        m_target->UpdateAuraForGroup(slot);                 // update for out of range group members (on 1 slot use)
 
     Unit* caster = GetCaster();
 
@@ -10885,7 +10910,7 @@ void SpellAuraHolder::SetStackAmount(uint32 stackAmount, Unit* newCaster)
                 aur->SetRemoveMode(AURA_REMOVE_BY_GAINED_STACK);
                 if (IsAuraRemoveOnStacking(this->GetSpellProto(), aur->GetEffIndex()))
                     aur->ApplyModifier(false, true);
-                aur->GetModifier()->m_amount = amount;
+                aur->SetAmount(amount);
                 aur->GetModifier()->m_recentAmount = baseAmount * (stackAmount - oldStackAmount);
                 aur->ApplyModifier(true, true);
             }
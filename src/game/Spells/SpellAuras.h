@@ -94,6 +94,11 @@ class SpellAuraHolder
     public:
         SpellAuraHolder(SpellEntry const* spellproto, Unit* target, WorldObject* caster, Item* castItem, SpellEntry const* triggeredBy);
         ~SpellAuraHolder();
+
+        // holders are allocated from a dedicated slab pool, see SpellAuras.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         Aura* m_auras[MAX_EFFECT_INDEX];
 
         void AddAura(Aura* aura, SpellEffectIndex index);
@@ -439,6 +444,10 @@ class Aura
 
         virtual ~Aura();
 
+        // all aura classes share one slab pool sized for the largest of them, see SpellAuras.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         void SetModifier(AuraType type, int32 amount, uint32 periodicTime, int32 miscValue);
         Modifier*       GetModifier()       { return &m_modifier; }
         Modifier const* GetModifier() const { return &m_modifier; }
@@ -455,7 +464,7 @@ class Aura
         SpellEffectIndex GetEffIndex() const { return m_effIndex; }
         int32 GetBasePoints() const { return m_currentBasePoints; }
         int32 GetAmount() const { return m_modifier.m_amount; }
-        void SetAmount(int32 amount) { m_modifier.m_amount = amount; }
+        void SetAmount(int32 amount);
 
         int32 GetAuraMaxDuration() const { return GetHolder()->GetAuraMaxDuration(); }
         int32 GetAuraDuration() const { return GetHolder()->GetAuraDuration(); }
@@ -472,7 +481,7 @@ class Aura
 
         void SetLoadedState(int32 damage, uint32 periodicTime)
         {
-            m_modifier.m_amount = damage;
+            SetAmount(damage);
             m_modifier.periodictime = periodicTime;
 
             if (uint32 maxticks = GetAuraMaxTicks())
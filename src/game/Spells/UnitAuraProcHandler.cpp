@@ -1476,14 +1476,14 @@ SpellAuraProcResult Unit::HandleDummyAuraProc(ProcExecutionData& data)
                 Modifier* mod = counter->GetModifier();
                 if (procEx & PROC_EX_CRITICAL_HIT)
                 {
-                    mod->m_amount *= 2;
+                    counter->SetAmount(mod->m_amount * 2);
                     if (mod->m_amount < 100) // not enough
                         return SPELL_AURA_PROC_OK;
                     // Critical counted -> roll chance
                     if (roll_chance_i(triggerAmount))
                         CastSpell(this, 48108, TRIGGERED_OLD_TRIGGERED, castItem, triggeredByAura);
                 }
-                mod->m_amount = 25;
+                counter->SetAmount(25);
                 return SPELL_AURA_PROC_OK;
             }
             // Burnout
@@ -1659,7 +1659,7 @@ SpellAuraProcResult Unit::HandleDummyAuraProc(ProcExecutionData& data)
                 }
 
                 // Damage counting
-                mod->m_amount -= damage;
+                triggeredByAura->SetAmount(mod->m_amount - damage);
                 return SPELL_AURA_PROC_OK;
             }
             // Seed of Corruption (Mobs cast) - no die req
@@ -1680,7 +1680,7 @@ SpellAuraProcResult Unit::HandleDummyAuraProc(ProcExecutionData& data)
                     return SPELL_AURA_PROC_OK;              // no hidden cooldown
                 }
                 // Damage counting
-                mod->m_amount -= damage;
+                triggeredByAura->SetAmount(mod->m_amount - damage);
                 return SPELL_AURA_PROC_OK;
             }
             // Fel Synergy
@@ -28,6 +28,8 @@
 #include "Log.h"
 #include "Server/Opcodes.h"
 #include "Server/WorldSession.h"
+#include "Server/OpcodeStats.h"
+#include "Server/QueryResponseCache.h"
 #include "WorldPacket.h"
 #include "Entities/Player.h"
 #include "Skills/SkillExtraItems.h"
@@ -36,6 +38,7 @@
 #include "Achievements/AchievementMgr.h"
 #include "AuctionHouse/AuctionHouseMgr.h"
 #include "Globals/ObjectMgr.h"
+#include "Globals/ObjectAccessor.h"
 #include "AI/EventAI/CreatureEventAIMgr.h"
 #include "Guilds/GuildMgr.h"
 #include "Spells/SpellMgr.h"
@@ -74,6 +77,7 @@
 #endif
 
 #include "Metric/Metric.h"
+#include "Metric/TickProfiler.h"
 
 #include <algorithm>
 #include <mutex>
@@ -106,6 +110,8 @@ World::World() : mail_timer(0), mail_timer_expires(0), m_NextDailyQuestReset(0),
     m_ShutdownTimer = 0;
     m_gameTime = time(nullptr);
     m_startTime = m_gameTime;
+    m_lastUpdateTime = 0;
+    m_averageUpdateTime = 0;
     m_maxActiveSessionCount = 0;
     m_maxQueuedSessionCount = 0;
 
@@ -510,6 +516,9 @@ void World::LoadConfigSettings(bool reload)
     setConfigMin(CONFIG_UINT32_INTERVAL_MAPUPDATE, "MapUpdateInterval", 100, MIN_MAP_UPDATE_DELAY);
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
+    setConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE, "MapUpdate.IdleInterval", 1000);
+    setConfig(CONFIG_UINT32_MAPUPDATE_IDLE_DELAY, "MapUpdate.IdleDelay", 10000);
+    setConfig(CONFIG_UINT32_MAP_TASK_BUDGET, "MapUpdate.TaskBudget", 5);
 
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
@@ -630,6 +639,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    setConfigMin(CONFIG_UINT32_NUM_MAP_JOB_THREADS, "MapUpdate.JobThreads", 1, 1);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -670,6 +680,8 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_UINT32_CHATFLOOD_MUTE_TIME,     "ChatFlood.MuteTime", 10);
 
     setConfig(CONFIG_BOOL_EVENT_ANNOUNCE, "Event.Announce", false);
+    setConfig(CONFIG_UINT32_EVENT_SPAWN_BUDGET, "Event.SpawnBudget", 5);
+    setConfig(CONFIG_UINT32_PROFILER_RING_TICKS, "Metric.ProfilerRingTicks", 600);
 
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_ASSISTANCE_DELAY, "CreatureFamilyAssistanceDelay", 1500);
     setConfig(CONFIG_UINT32_CREATURE_FAMILY_FLEE_DELAY,       "CreatureFamilyFleeDelay",       10000);
@@ -759,6 +771,9 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_UINT32_SLOW_OPCODE_THRESHOLD, "Network.SlowOpcodeThreshold", 0);
+    setConfig(CONFIG_UINT32_OPCODE_RATE_LIMIT, "Network.OpcodeRateLimit", 0);
+    setConfig(CONFIG_UINT32_OPCODE_RATE_LIMIT_COST, "Network.OpcodeRateLimitCost", 1000);
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
@@ -1528,6 +1543,9 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    sTickProfiler.BeginTick();
+    PROFILE_SCOPE("World::Update");
+
     m_currentMSTime = WorldTimer::getMSTime();
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     m_currentDiff = diff;
@@ -1593,7 +1611,10 @@ void World::Update(uint32 diff)
 
     /// <li> Handle session updates
     auto preSessionTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
-    UpdateSessions(diff);
+    {
+        PROFILE_SCOPE("World::UpdateSessions");
+        UpdateSessions(diff);
+    }
 
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
@@ -1607,11 +1628,23 @@ void World::Update(uint32 diff)
     auto preMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
-    sMapMgr.Update(diff);
+    {
+        PROFILE_SCOPE("MapManager::Update");
+        sMapMgr.Update(diff);
+    }
     auto postMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
-    sBattleGroundMgr.Update(diff);
-    sOutdoorPvPMgr.Update(diff);
-    sWorldState.Update(diff);
+    {
+        PROFILE_SCOPE("BattleGroundMgr::Update");
+        sBattleGroundMgr.Update(diff);
+    }
+    {
+        PROFILE_SCOPE("OutdoorPvPMgr::Update");
+        sOutdoorPvPMgr.Update(diff);
+    }
+    {
+        PROFILE_SCOPE("WorldState::Update");
+        sWorldState.Update(diff);
+    }
     auto postSingletonTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     ///- Update groups with offline leaders
     if (m_timers[WUPDATE_GROUPS].Passed())
@@ -1632,7 +1665,10 @@ void World::Update(uint32 diff)
     }
 
     // execute callbacks from sql queries that were queued recently
-    UpdateResultQueue();
+    {
+        PROFILE_SCOPE("World::UpdateResultQueue");
+        UpdateResultQueue();
+    }
 
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
@@ -1646,6 +1682,7 @@ void World::Update(uint32 diff)
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
         m_timers[WUPDATE_EVENTS].Reset();                   // to give time for Update() to be processed
+        PROFILE_SCOPE("GameEventMgr::Update");
         uint32 nextGameEvent = sGameEventMgr.Update();
         m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);
         m_timers[WUPDATE_EVENTS].Reset();
@@ -1660,7 +1697,10 @@ void World::Update(uint32 diff)
 
     /// </ul>
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
-    sMapMgr.RemoveAllObjectsInRemoveList();
+    {
+        PROFILE_SCOPE("MapManager::RemoveAllObjectsInRemoveList");
+        sMapMgr.RemoveAllObjectsInRemoveList();
+    }
 
     // update the instance reset times
     sMapPersistentStateMgr.Update();
@@ -1679,13 +1719,22 @@ void World::Update(uint32 diff)
     long long singletons = (postSingletonTime - postMapTime).count();
     long long cleanup = (updateEndTime - postSingletonTime).count();
 
+    m_lastUpdateTime = uint32(total);
+    m_averageUpdateTime = (m_averageUpdateTime * 15 + m_lastUpdateTime) / 16;
+
     metric::measurement meas("world.update");
-    meas.add_field("total", std::to_string(total));
-    meas.add_field("presession", std::to_string(presession));
-    meas.add_field("premap", std::to_string(premap));
-    meas.add_field("map", std::to_string(map));
-    meas.add_field("singletons", std::to_string(singletons));
-    meas.add_field("cleanup", std::to_string(cleanup));
+    meas.add_field("total", total);
+    meas.add_field("presession", presession);
+    meas.add_field("premap", premap);
+    meas.add_field("map", map);
+    meas.add_field("singletons", singletons);
+    meas.add_field("cleanup", cleanup);
+
+    // packet payload bytes copied into socket buffers and referenced from shared broadcast buffers
+    uint64 bytesCopied, bytesShared;
+    MaNGOS::Socket::ResetWriteStats(bytesCopied, bytesShared);
+    meas.add_field("bytes_copied", bytesCopied);
+    meas.add_field("bytes_shared", bytesShared);
 }
 
 namespace MaNGOS
@@ -1801,13 +1850,14 @@ void World::SendWorldTextToAcceptingTickets(int32 string_id, ...)
 /// Sends a packet to all players with optional team and instance restrictions
 void World::SendGlobalMessage(WorldPacket const& packet) const
 {
+    PacketBroadcast broadcast(packet);
     for (const auto& m_session : m_sessions)
     {
         if (WorldSession* session = m_session.second)
         {
             Player* player = session->GetPlayer();
             if (player && player->IsInWorld())
-                session->SendPacket(packet);
+                broadcast.SendTo(session);
         }
     }
 }
@@ -2710,42 +2760,65 @@ void World::GeneratePacketMetrics()
             continue;
 
         metric::measurement meas("world.metrics.packets.received", { {"opcode", opcodeTable[i].name} });
-        meas.add_field("count", std::to_string(static_cast<uint32>(m_opcodeCounters[i])));
+        meas.add_field("count", static_cast<uint32>(m_opcodeCounters[i]));
 
         // Reset counter
         m_opcodeCounters[i] = 0;
     }
 
+    sOpcodeStats.Merge();
+    sQueryResponseCache.ReportMetrics();
+
     metric::measurement meas_players("world.metrics.players");
-    meas_players.add_field("online", std::to_string(GetActiveSessionCount()));
-    meas_players.add_field("unique", std::to_string(GetUniqueSessionCount()));
-    meas_players.add_field("queued", std::to_string(GetQueuedSessionCount()));
+    meas_players.add_field("online", GetActiveSessionCount());
+    meas_players.add_field("unique", GetUniqueSessionCount());
+    meas_players.add_field("queued", GetQueuedSessionCount());
     // team
-    meas_players.add_field("alliance", std::to_string(GetOnlineTeamPlayers(true)));
-    meas_players.add_field("horde", std::to_string(GetOnlineTeamPlayers(false)));
+    meas_players.add_field("alliance", GetOnlineTeamPlayers(true));
+    meas_players.add_field("horde", GetOnlineTeamPlayers(false));
     // race
-    meas_players.add_field("human", std::to_string(GetOnlineRacePlayers(RACE_HUMAN)));
-    meas_players.add_field("dwarf", std::to_string(GetOnlineRacePlayers(RACE_DWARF)));
-    meas_players.add_field("gnome", std::to_string(GetOnlineRacePlayers(RACE_GNOME)));
-    meas_players.add_field("nelf", std::to_string(GetOnlineRacePlayers(RACE_NIGHTELF)));
-    meas_players.add_field("draenei", std::to_string(GetOnlineRacePlayers(RACE_DRAENEI)));
-
-    meas_players.add_field("orc", std::to_string(GetOnlineRacePlayers(RACE_ORC)));
-    meas_players.add_field("undead", std::to_string(GetOnlineRacePlayers(RACE_UNDEAD)));
-    meas_players.add_field("tauren", std::to_string(GetOnlineRacePlayers(RACE_TAUREN)));
-    meas_players.add_field("troll", std::to_string(GetOnlineRacePlayers(RACE_TROLL)));
-    meas_players.add_field("belf", std::to_string(GetOnlineRacePlayers(RACE_BLOODELF)));
+    meas_players.add_field("human", GetOnlineRacePlayers(RACE_HUMAN));
+    meas_players.add_field("dwarf", GetOnlineRacePlayers(RACE_DWARF));
+    meas_players.add_field("gnome", GetOnlineRacePlayers(RACE_GNOME));
+    meas_players.add_field("nelf", GetOnlineRacePlayers(RACE_NIGHTELF));
+    meas_players.add_field("draenei", GetOnlineRacePlayers(RACE_DRAENEI));
+
+    meas_players.add_field("orc", GetOnlineRacePlayers(RACE_ORC));
+    meas_players.add_field("undead", GetOnlineRacePlayers(RACE_UNDEAD));
+    meas_players.add_field("tauren", GetOnlineRacePlayers(RACE_TAUREN));
+    meas_players.add_field("troll", GetOnlineRacePlayers(RACE_TROLL));
+    meas_players.add_field("belf", GetOnlineRacePlayers(RACE_BLOODELF));
     // class
-    meas_players.add_field("warrior", std::to_string(GetOnlineClassPlayers(CLASS_WARRIOR)));
-    meas_players.add_field("paladin", std::to_string(GetOnlineClassPlayers(CLASS_PALADIN)));
-    meas_players.add_field("hunter", std::to_string(GetOnlineClassPlayers(CLASS_HUNTER)));
-    meas_players.add_field("rogue", std::to_string(GetOnlineClassPlayers(CLASS_ROGUE)));
-    meas_players.add_field("priest", std::to_string(GetOnlineClassPlayers(CLASS_PRIEST)));
-    meas_players.add_field("shaman", std::to_string(GetOnlineClassPlayers(CLASS_SHAMAN)));
-    meas_players.add_field("mage", std::to_string(GetOnlineClassPlayers(CLASS_MAGE)));
-    meas_players.add_field("warlock", std::to_string(GetOnlineClassPlayers(CLASS_WARLOCK)));
-    meas_players.add_field("druid", std::to_string(GetOnlineClassPlayers(CLASS_DRUID)));
-    meas_players.add_field("deathknight", std::to_string(GetOnlineClassPlayers(CLASS_DEATH_KNIGHT)));
+    meas_players.add_field("warrior", GetOnlineClassPlayers(CLASS_WARRIOR));
+    meas_players.add_field("paladin", GetOnlineClassPlayers(CLASS_PALADIN));
+    meas_players.add_field("hunter", GetOnlineClassPlayers(CLASS_HUNTER));
+    meas_players.add_field("rogue", GetOnlineClassPlayers(CLASS_ROGUE));
+    meas_players.add_field("priest", GetOnlineClassPlayers(CLASS_PRIEST));
+    meas_players.add_field("shaman", GetOnlineClassPlayers(CLASS_SHAMAN));
+    meas_players.add_field("mage", GetOnlineClassPlayers(CLASS_MAGE));
+    meas_players.add_field("warlock", GetOnlineClassPlayers(CLASS_WARLOCK));
+    meas_players.add_field("druid", GetOnlineClassPlayers(CLASS_DRUID));
+    meas_players.add_field("deathknight", GetOnlineClassPlayers(CLASS_DEATH_KNIGHT));
+
+    // object accessor lookups that had to wait for a writer
+    uint64 contended, waitTime;
+    HashMapHolder<Player>::TakeContentionStats(contended, waitTime);
+    metric::measurement meas_players_lock("world.metrics.object_accessor", { {"holder", "player"} });
+    meas_players_lock.add_field("contended", contended);
+    meas_players_lock.add_field("wait_us", waitTime);
+
+    HashMapHolder<Corpse>::TakeContentionStats(contended, waitTime);
+    metric::measurement meas_corpses_lock("world.metrics.object_accessor", { {"holder", "corpse"} });
+    meas_corpses_lock.add_field("contended", contended);
+    meas_corpses_lock.add_field("wait_us", waitTime);
+
+    // achievement criteria checked per update, type_total is what scanning all criteria of the type would have cost
+    uint64 criteriaCalls, criteriaScanned, criteriaTypeTotal;
+    sAchievementMgr.TakeCriteriaUpdateStats(criteriaCalls, criteriaScanned, criteriaTypeTotal);
+    metric::measurement meas_criteria("world.metrics.achievement_criteria");
+    meas_criteria.add_field("calls", criteriaCalls);
+    meas_criteria.add_field("scanned", criteriaScanned);
+    meas_criteria.add_field("type_total", criteriaTypeTotal);
 }
 
 void World::UpdateSessionExpansion(uint8 expansion)
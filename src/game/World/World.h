@@ -146,6 +146,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
+    CONFIG_UINT32_NUM_MAP_JOB_THREADS,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
@@ -212,6 +213,14 @@ enum eConfigUInt32Values
     CONFIG_UINT32_FOGOFWAR_STATS,
     CONFIG_UINT32_CREATURE_PICKPOCKET_RESTOCK_DELAY,
     CONFIG_UINT32_CHANNEL_STATIC_AUTO_TRESHOLD,
+    CONFIG_UINT32_EVENT_SPAWN_BUDGET,
+    CONFIG_UINT32_PROFILER_RING_TICKS,
+    CONFIG_UINT32_SLOW_OPCODE_THRESHOLD,
+    CONFIG_UINT32_OPCODE_RATE_LIMIT,
+    CONFIG_UINT32_OPCODE_RATE_LIMIT_COST,
+    CONFIG_UINT32_INTERVAL_MAPUPDATE_IDLE,
+    CONFIG_UINT32_MAPUPDATE_IDLE_DELAY,
+    CONFIG_UINT32_MAP_TASK_BUDGET,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -534,6 +543,9 @@ class World
         time_t const& GetGameTime() const { return m_gameTime; }
         /// Uptime (in secs)
         uint32 GetUptime() const { return uint32(m_gameTime - m_startTime); }
+        /// Duration of the last world update and its running average (in ms)
+        uint32 GetLastUpdateTime() const { return m_lastUpdateTime; }
+        uint32 GetAverageUpdateTime() const { return m_averageUpdateTime; }
         /// Next daily quests and random bg reset time
         time_t GetNextDailyQuestsResetTime() const { return m_NextDailyQuestReset; }
         time_t GetNextWeeklyQuestsResetTime() const { return m_NextWeeklyQuestReset; }
@@ -699,6 +711,8 @@ class World
 
         time_t m_startTime;
         time_t m_gameTime;
+        uint32 m_lastUpdateTime;
+        uint32 m_averageUpdateTime;
         IntervalTimer m_timers[WUPDATE_COUNT];
         uint32 mail_timer;
         uint32 mail_timer_expires;
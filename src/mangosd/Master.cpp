@@ -134,6 +134,9 @@ int Master::Run()
     WorldDatabase.AllowAsyncTransactions();
     LoginDatabase.AllowAsyncTransactions();
 
+    // startup output is done, from now on log records are written by the log writer thread (if enabled)
+    sLog.StartAsync();
+
     ///- Catch termination signals
     _HookSignals();
 
@@ -264,6 +267,9 @@ int Master::Run()
     WorldDatabase.HaltDelayThread();
     LoginDatabase.HaltDelayThread();
 
+    ///- Write all still queued log records
+    sLog.StopAsync();
+
     sLog.outString("Halting process...");
 
     if (cliThread)
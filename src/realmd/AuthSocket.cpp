@@ -29,10 +29,13 @@
 #include "RealmList.h"
 #include "AuthSocket.h"
 #include "AuthCodes.h"
+#include "AuthWorkerPool.h"
 #include "SRP6/SRP6.h"
 
 #include <openssl/md5.h>
+#include <cerrno>
 #include <ctime>
+#include <unordered_map>
 #include <utility>
 
 //#include "Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -183,7 +186,8 @@ std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B,
 
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
-    : Socket(service, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER)
+    : Socket(service, std::move(closeHandler)), _service(service), _asyncPending(false), _status(STATUS_CHALLENGE), _build(0), _accountId(0),
+      _accountSecurityLevel(SEC_PLAYER)
 {
 }
 
@@ -209,6 +213,13 @@ bool AuthSocket::ProcessIncomingData()
     // which presumably the client will never do, but lets support it anyway! \o/
     while (ReadLengthRemaining() > 0)
     {
+        // previous command still handled by the worker pool, keep the data until its reply is sent
+        if (_asyncPending)
+        {
+            errno = EBADMSG;
+            return false;
+        }
+
         const eAuthCmd cmd = static_cast<eAuthCmd>(*InPeak());
         int i;
 
@@ -251,7 +262,44 @@ bool AuthSocket::ProcessIncomingData()
     return true;
 }
 
-void AuthSocket::SendProof(Sha1Hash sha)
+void AuthSocket::ExecuteAsync(std::function<bool (ByteBuffer&)> work)
+{
+    _asyncPending = true;
+
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    sAuthWorkerPool.Enqueue([self, work]()
+    {
+        std::shared_ptr<ByteBuffer> reply(new ByteBuffer());
+        bool keepOpen = work(*reply);
+
+        self->_service.post([self, reply, keepOpen]() { self->OnAsyncComplete(*reply, keepOpen); });
+    });
+}
+
+void AuthSocket::OnAsyncComplete(ByteBuffer const& reply, bool keepOpen)
+{
+    _asyncPending = false;
+
+    if (IsClosed())
+        return;
+
+    if (!keepOpen)
+    {
+        Close();
+        return;
+    }
+
+    if (!reply.empty())
+    {
+        Write((const char*)reply.contents(), reply.size());
+        // the client waits for this reply before sending anything, no point in buffering it
+        ForceFlushOut();
+    }
+
+    ProcessBufferedData();
+}
+
+void AuthSocket::BuildProof(ByteBuffer& pkt, Sha1Hash& sha)
 {
     switch (_build)
     {
@@ -265,7 +313,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.error = 0;
             proof.LoginFlags = 0x00;
 
-            Write((const char*)&proof, sizeof(proof));
+            pkt.append((const char*)&proof, sizeof(proof));
             break;
         }
         case 8606:                                          // 2.4.3
@@ -284,7 +332,7 @@ void AuthSocket::SendProof(Sha1Hash sha)
             proof.surveyId = 0x00000000;
             proof.unkFlags = 0x0000;
 
-            Write((const char*)&proof, sizeof(proof));
+            pkt.append((const char*)&proof, sizeof(proof));
             break;
         }
     }
@@ -334,8 +382,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -348,6 +394,10 @@ bool AuthSocket::_HandleLogonChallenge()
     // Restore string order as its byte order is reversed
     std::reverse(m_os.begin(), m_os.end());
 
+    _localizationName.resize(4);
+    for (int i = 0; i < 4; ++i)
+        _localizationName[i] = ch->country[4 - i - 1];
+
     ///- Normalize account name
     // utf8ToUpperOnlyLatin(_login); -- client already send account in expected form
 
@@ -356,144 +406,136 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelogin = _login;
     LoginDatabase.escape_string(_safelogin);
 
-    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
-    pkt << (uint8) 0x00;
+    ///- Account lookup and SRP6 host ephemeral are done by the auth workers
+    ExecuteAsync([this](ByteBuffer& pkt)
+    {
+        pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+        pkt << (uint8) 0x00;
 
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
+        ///- Verify that this IP is not in the ip_banned table
+        // No SQL injection possible (paste the IP address as passed by the socket)
+        std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
+                "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
+
+        if (ip_banned_result)
+        {
+            pkt << (uint8)WOW_FAIL_FAIL_NOACCESS;
+            BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
+            return true;
+        }
 
-    if (ip_banned_result)
-    {
-        pkt << (uint8)WOW_FAIL_FAIL_NOACCESS;
-        BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
-    }
-    else
-    {
         ///- Get the account details from the account table
         // No SQL injection (escaped user name)
-        QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,last_ip,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
-        if (result)
+        std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT id,locked,last_ip,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str()));
+        if (!result)                                        // no account
         {
-            Field* fields = result->Fetch();
+            pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+            return true;
+        }
+
+        Field* fields = result->Fetch();
 
-            ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            if (fields[1].GetUInt8() == 1)               // if ip is locked
+        ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
+        if (fields[1].GetUInt8() == 1)                      // if ip is locked
+        {
+            DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[2].GetString());
+            DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
+            if (strcmp(fields[2].GetString(), m_address.c_str()))
             {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), fields[2].GetString());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", m_address.c_str());
-                if (strcmp(fields[2].GetString(), m_address.c_str()))
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << (uint8) WOW_FAIL_SUSPENDED;
-                    locked = true;
-                }
-                else
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
+                DEBUG_LOG("[AuthChallenge] Account IP differs");
+                pkt << (uint8) WOW_FAIL_SUSPENDED;
+                return true;
             }
-            else
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+            DEBUG_LOG("[AuthChallenge] Account IP matches");
+        }
+        else
+            DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+
+        std::string databaseV = fields[4].GetCppString();
+        std::string databaseS = fields[5].GetCppString();
 
-            std::string databaseV = fields[4].GetCppString();
-            std::string databaseS = fields[5].GetCppString();
-            bool broken = false;
+        if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
+        {
+            pkt << (uint8)WOW_FAIL_FAIL_NOACCESS;
+            DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
+            return true;
+        }
 
-            if (!srp.SetVerifier(databaseV.c_str()) || !srp.SetSalt(databaseS.c_str()))
+        ///- If the account is banned, reject the logon attempt
+        std::unique_ptr<QueryResult> banresult(LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
+                                               "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[0].GetUInt32()));
+        if (banresult)
+        {
+            if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
             {
-                pkt << (uint8)WOW_FAIL_FAIL_NOACCESS;
-                DEBUG_LOG("[AuthChallenge] Broken v/s values in database for account %s!", _login.c_str());
-                broken = true;
+                pkt << (uint8) WOW_FAIL_BANNED;
+                BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
             }
-
-            if (!locked && !broken)
+            else
             {
-                ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[1].GetUInt32());
-                if (banresult)
-                {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << (uint8) WOW_FAIL_BANNED;
-                        BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
-                    }
-                    else
-                    {
-                        pkt << (uint8) WOW_FAIL_SUSPENDED;
-                        BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
-                    }
+                pkt << (uint8) WOW_FAIL_SUSPENDED;
+                BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
+            }
+            return true;
+        }
 
-                    delete banresult;
-                }
-                else
-                {
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
+        DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
 
-                    BigNumber s;
-                    s.SetHexStr(databaseS.c_str());
+        BigNumber s;
+        s.SetHexStr(databaseS.c_str());
 
-                    srp.CalculateHostPublicEphemeral();
+        srp.CalculateHostPublicEphemeral();
 
-                    ///- Fill the response packet with the result
-                    pkt << uint8(WOW_SUCCESS);
+        ///- Fill the response packet with the result
+        pkt << uint8(WOW_SUCCESS);
 
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32), 32);      // 32 bytes
-                    pkt << uint8(1);
-                    pkt.append(srp.GetGeneratorModulo().AsByteArray(), 1);
-                    pkt << uint8(32);
-                    pkt.append(srp.GetPrime().AsByteArray(32), 32);
-                    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
-                    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-                    uint8 securityFlags = 0;
+        // B may be calculated < 32B so we force minimal length to 32B
+        pkt.append(srp.GetHostPublicEphemeral().AsByteArray(32), 32);      // 32 bytes
+        pkt << uint8(1);
+        pkt.append(srp.GetGeneratorModulo().AsByteArray(), 1);
+        pkt << uint8(32);
+        pkt.append(srp.GetPrime().AsByteArray(32), 32);
+        pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
+        pkt.append(VersionChallenge.data(), VersionChallenge.size());
+        uint8 securityFlags = 0;
 
-                    _token = fields[6].GetCppString();
-                    if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
-                        securityFlags = SECURITY_FLAG_AUTHENTICATOR;
+        _token = fields[6].GetCppString();
+        if (!_token.empty() && _build >= 8606) // authenticator was added in 2.4.3
+            securityFlags = SECURITY_FLAG_AUTHENTICATOR;
 
-                    pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
+        pkt << uint8(securityFlags);                    // security flags (0x0...0x04)
 
-                    if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
-                    {
-                        pkt << uint32(0);
-                        pkt << uint64(0);
-                        pkt << uint64(0);
-                    }
+        if (securityFlags & SECURITY_FLAG_PIN)          // PIN input
+        {
+            pkt << uint32(0);
+            pkt << uint64(0);
+            pkt << uint64(0);
+        }
 
-                    if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
-                    {
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint64(0);
-                    }
+        if (securityFlags & SECURITY_FLAG_UNK)          // Matrix input
+        {
+            pkt << uint8(0);
+            pkt << uint8(0);
+            pkt << uint8(0);
+            pkt << uint8(0);
+            pkt << uint64(0);
+        }
 
-                    if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
-                        pkt << uint8(1);
+        if (securityFlags & SECURITY_FLAG_AUTHENTICATOR)    // Authenticator input
+            pkt << uint8(1);
 
-                    uint8 secLevel = fields[3].GetUInt8();
-                    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+        _accountId = fields[0].GetUInt32();
 
-                    _localizationName.resize(4);
-                    for (int i = 0; i < 4; ++i)
-                        _localizationName[i] = ch->country[4 - i - 1];
+        uint8 secLevel = fields[3].GetUInt8();
+        _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
 
-                    BASIC_LOG("[AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", _login.c_str(), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName));
+        BASIC_LOG("[AuthChallenge] account %s is using '%s' locale (%u)", _login.c_str(), _localizationName.c_str(), GetLocaleByName(_localizationName));
 
-                    ///- All good, await client's proof
-                    _status = STATUS_LOGON_PROOF;
-                }
-            }
-            delete result;
-        }
-        else                                                // no account
-            pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
-    }
+        ///- All good, await client's proof
+        _status = STATUS_LOGON_PROOF;
+        return true;
+    });
 
-    Write((const char*)pkt.contents(), pkt.size());
     return true;
 }
 
@@ -523,76 +565,84 @@ bool AuthSocket::_HandleLogonProof()
     }
     /// </ul>
 
-    ///- Continue the SRP6 calculation based on data received from the client
-    if(!srp.CalculateSessionKey(lp.A, 32))
-        return false;
-
-    srp.HashSessionKey();
-    srp.CalculateProof(_login);
+    ///- Authenticator data follows the proof, read it while still on the network thread
+    sAuthLogonAuthenticatorData_C authData{};
+    bool hasAuthData = false;
+    if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
+        hasAuthData = Read((char*) &authData, sizeof(sAuthLogonAuthenticatorData_C));
 
-    ///- Check if SRP6 results match (password is correct), else send an error
-    if (!srp.Proof(lp.M1, 20))
+    ///- SRP6 session key calculation and account updates are done by the auth workers
+    ExecuteAsync([this, lp, authData, hasAuthData](ByteBuffer& pkt) mutable
     {
-        if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
+        ///- Continue the SRP6 calculation based on data received from the client
+        if (!srp.CalculateSessionKey(lp.A, 32))
+            return false;
+
+        srp.HashSessionKey();
+        srp.CalculateProof(_login);
+
+        ///- Check if SRP6 results match (password is correct), else send an error
+        if (!srp.Proof(lp.M1, 20))
         {
-            sAuthLogonAuthenticatorData_C authData{};
-            if (!Read((char*) &authData, sizeof(sAuthLogonAuthenticatorData_C)))
+            if (lp.securityFlags & SECURITY_FLAG_AUTHENTICATOR || !_token.empty())
             {
-                const char data[4] = {CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 3, 0};
-                Write(data, sizeof(data));
-                return true;
+                if (!hasAuthData)
+                {
+                    const char data[4] = {CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 3, 0};
+                    pkt.append(data, sizeof(data));
+                    return true;
+                }
+
+                auto ServerToken = generateToken(_token.c_str());
+                auto clientToken = atoi((const char*) authData.keys);
+                if (ServerToken != clientToken)
+                {
+                    BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u", _login.c_str(), clientToken, ServerToken);
+
+                    const char data[4] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 0, 0};
+                    pkt.append(data, sizeof(data));
+                    return true;
+                }
             }
 
-            auto ServerToken = generateToken(_token.c_str());
-            auto clientToken = atoi((const char*) authData.keys);
-            if (ServerToken != clientToken)
+            if (!VerifyVersion(lp.A, sizeof(lp.A), lp.crc_hash, false))
             {
-                BASIC_LOG("[AuthChallenge] Account %s tried to login with wrong pincode! Given %u Expected %u", _login.c_str(), clientToken, ServerToken);
+                BASIC_LOG("[AuthChallenge] Account %s tried to login with modified client!", _login.c_str());
 
-                const char data[4] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 0, 0};
-                Write(data, sizeof(data));
+                const char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_VERSION_INVALID };
+                pkt.append(data, sizeof(data));
                 return true;
             }
-        }
 
-        if (!VerifyVersion(lp.A, sizeof(lp.A), lp.crc_hash, false))
-        {
-            BASIC_LOG("[AuthChallenge] Account %s tried to login with modified client!", _login.c_str());
+            BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
 
-            const char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_VERSION_INVALID };
-            Write(data, sizeof(data));
-            return true;
-        }
+            ///- Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
+            // No SQL injection (escaped user name) and IP address as received by socket
+            const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
+            LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', last_ip = '%s', last_login = NOW(), locale = '%u', failed_logins = 0 WHERE username = '%s'", K_hex, m_address.c_str(), GetLocaleByName(_localizationName), _safelogin.c_str());
+            OPENSSL_free((void*)K_hex);
 
-        BASIC_LOG("User '%s' successfully authenticated", _login.c_str());
+            ///- Finish SRP6 and send the final result to the client
+            Sha1Hash sha;
+            srp.Finalize(sha);
 
-        ///- Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
-        // No SQL injection (escaped user name) and IP address as received by socket
-        const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
-        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', last_ip = '%s', last_login = NOW(), locale = '%u', failed_logins = 0 WHERE username = '%s'", K_hex, m_address.c_str(), GetLocaleByName(_localizationName), _safelogin.c_str());
-        OPENSSL_free((void*)K_hex);
+            BuildProof(pkt, sha);
 
-        ///- Finish SRP6 and send the final result to the client
-        Sha1Hash sha;
-        srp.Finalize(sha);
-
-        SendProof(sha);
+            ///- Set _status to authed!
+            _status = STATUS_AUTHED;
+            return true;
+        }
 
-        ///- Set _status to authed!
-        _status = STATUS_AUTHED;
-    }
-    else
-    {
         if (_build > 6005)                                  // > 1.12.2
         {
             const char data[4] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 0, 0};
-            Write(data, sizeof(data));
+            pkt.append(data, sizeof(data));
         }
         else
         {
             // 1.x not react incorrectly at 4-byte message use 3 as real error
             const char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT};
-            Write(data, sizeof(data));
+            pkt.append(data, sizeof(data));
         }
         BASIC_LOG("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str());
 
@@ -634,7 +684,9 @@ bool AuthSocket::_HandleLogonProof()
                 delete loginfail;
             }
         }
-    }
+        return true;
+    });
+
     return true;
 }
 
@@ -681,31 +733,34 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
-
-    // Stop if the account is not found
-    if (!result)
+    ///- Session key lookup is done by the auth workers
+    ExecuteAsync([this](ByteBuffer& pkt)
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
-        Close();
-        return false;
-    }
+        std::unique_ptr<QueryResult> result(LoginDatabase.PQuery("SELECT id, sessionkey FROM account WHERE username = '%s'", _safelogin.c_str()));
+
+        // Stop if the account is not found
+        if (!result)
+        {
+            sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
+            return false;
+        }
+
+        Field* fields = result->Fetch();
+        _accountId = fields[0].GetUInt32();
+        srp.SetStrongSessionKey(fields[1].GetString());
+
+        ///- All good, await client's proof
+        _status = STATUS_RECON_PROOF;
+
+        ///- Sending response
+        pkt << (uint8)  CMD_AUTH_RECONNECT_CHALLENGE;
+        pkt << (uint8)  0x00;
+        _reconnectProof.SetRand(16 * 8);
+        pkt.append(_reconnectProof.AsByteArray(16), 16);        // 16 bytes random
+        pkt.append(VersionChallenge.data(), VersionChallenge.size());
+        return true;
+    });
 
-    Field* fields = result->Fetch();
-    srp.SetStrongSessionKey(fields[0].GetString());
-    delete result;
-
-    ///- All good, await client's proof
-    _status = STATUS_RECON_PROOF;
-
-    ///- Sending response
-    ByteBuffer pkt;
-    pkt << (uint8)  CMD_AUTH_RECONNECT_CHALLENGE;
-    pkt << (uint8)  0x00;
-    _reconnectProof.SetRand(16 * 8);
-    pkt.append(_reconnectProof.AsByteArray(16), 16);        // 16 bytes random
-    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-    Write((const char*)pkt.contents(), pkt.size());
     return true;
 }
 
@@ -770,38 +825,50 @@ bool AuthSocket::_HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
-
-    QueryResult* result = LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!result)
+    // account id is known since the logon or reconnect challenge
+    if (!_accountId)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
         Close();
         return false;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    delete result;
-
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
+    ///- Realm list refresh and character counts lookup are done by the auth workers
+    ExecuteAsync([this](ByteBuffer& hdr)
+    {
+        ///- Update realm list if need
+        sRealmList.UpdateIfNeed();
 
-    ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
-    ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+        ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
+        ByteBuffer pkt;
+        LoadRealmlist(pkt, _accountId);
 
-    ByteBuffer hdr;
-    hdr << (uint8) CMD_REALM_LIST;
-    hdr << (uint16)pkt.size();
-    hdr.append(pkt);
+        hdr << (uint8) CMD_REALM_LIST;
+        hdr << (uint16)pkt.size();
+        hdr.append(pkt);
+        return true;
+    });
 
-    Write((const char*)hdr.contents(), hdr.size());
     return true;
 }
 
 void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
 {
+    ///- Character counts of all realms in one query
+    std::unordered_map<uint32, uint8> characterCounts;
+    if (QueryResult* result = LoginDatabase.PQuery("SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", acctid))
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            characterCounts[fields[0].GetUInt32()] = fields[1].GetUInt8();
+        }
+        while (result->NextRow());
+        delete result;
+    }
+
+    RealmList::RealmMapPtr realms = sRealmList.GetRealms();
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -809,22 +876,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         case 6141:                                          // 1.12.3
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint8(sRealmList.size());
+            pkt << uint8(realms->size());
 
-            for (const auto& i : sRealmList)
+            for (const auto& i : *realms)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto chars = characterCounts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = chars != characterCounts.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -870,22 +927,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         default:                                            // and later
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint16(sRealmList.size());
+            pkt << uint16(realms->size());
 
-            for (const auto& i : sRealmList)
+            for (const auto& i : *realms)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                auto chars = characterCounts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = chars != characterCounts.end() ? chars->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
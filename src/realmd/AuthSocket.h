@@ -44,7 +44,7 @@ class AuthSocket : public MaNGOS::Socket
 
         AuthSocket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler);
 
-        void SendProof(Sha1Hash sha);
+        void BuildProof(ByteBuffer& pkt, Sha1Hash& sha);
         void LoadRealmlist(ByteBuffer& pkt, uint32 acctid);
         int32 generateToken(char const* b32key);
 
@@ -71,6 +71,14 @@ class AuthSocket : public MaNGOS::Socket
             STATUS_CLOSED
         };
 
+        // runs the blocking part of a handler on the auth worker pool, the reply it builds is written back on the network thread
+        // the handler's result decides whether the connection stays open
+        void ExecuteAsync(std::function<bool (ByteBuffer&)> work);
+        void OnAsyncComplete(ByteBuffer const& reply, bool keepOpen);
+
+        boost::asio::io_service& _service;
+        bool _asyncPending;                                 // network thread only, input is held back while set
+
         SRP6 srp;
         BigNumber _reconnectProof;
 
@@ -85,6 +93,7 @@ class AuthSocket : public MaNGOS::Socket
         // between enUS and enGB, which is important for the patch system
         std::string _localizationName;
         uint16 _build;
+        uint32 _accountId;
         AccountTypes _accountSecurityLevel;
 
         virtual bool ProcessIncomingData() override;
@@ -0,0 +1,93 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "AuthWorkerPool.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+INSTANTIATE_SINGLETON_1(AuthWorkerPool);
+
+AuthWorkerPool::AuthWorkerPool() : m_pendingJobs(0)
+{
+}
+
+AuthWorkerPool::~AuthWorkerPool()
+{
+    Stop();
+}
+
+void AuthWorkerPool::Start(uint32 threadCount)
+{
+    if (!m_threads.empty())
+        return;
+
+    m_work.reset(new boost::asio::io_service::work(m_service));
+
+    m_threads.reserve(threadCount);
+    for (uint32 i = 0; i < threadCount; ++i)
+        m_threads.emplace_back(&AuthWorkerPool::WorkerThread, this);
+
+    if (threadCount)
+        sLog.outString("Authentication handled by %u worker thread(s)", threadCount);
+    else
+        sLog.outString("Authentication handled by the network threads");
+}
+
+void AuthWorkerPool::Stop()
+{
+    if (m_threads.empty())
+        return;
+
+    // let already queued jobs finish, their sockets are closed by the listener afterwards
+    m_work.reset();
+    for (std::thread& thread : m_threads)
+        thread.join();
+
+    m_threads.clear();
+    m_service.reset();
+}
+
+void AuthWorkerPool::Enqueue(Job job)
+{
+    if (m_threads.empty())
+    {
+        job();
+        return;
+    }
+
+    ++m_pendingJobs;
+    m_service.post([this, job]()
+    {
+        job();
+        --m_pendingJobs;
+    });
+}
+
+void AuthWorkerPool::WorkerThread()
+{
+    LoginDatabase.ThreadStart();
+
+    boost::system::error_code ec;
+    m_service.run(ec);
+
+    LoginDatabase.ThreadEnd();
+}
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Threads running the blocking part of the authentication handlers (LoginDatabase lookups, SRP6 math),
+ * so the network threads only parse packets and write replies.
+ * With zero threads jobs are executed directly by the caller, as before the pool existed.
+ */
+class AuthWorkerPool
+{
+    public:
+        typedef std::function<void()> Job;
+
+        AuthWorkerPool();
+        ~AuthWorkerPool();
+
+        void Start(uint32 threadCount);
+        void Stop();
+
+        void Enqueue(Job job);
+
+        // jobs queued or running, for load reporting
+        uint32 GetPendingJobs() const { return m_pendingJobs; }
+        uint32 GetThreadCount() const { return uint32(m_threads.size()); }
+
+    private:
+        void WorkerThread();
+
+        boost::asio::io_service m_service;
+        std::unique_ptr<boost::asio::io_service::work> m_work;
+        std::vector<std::thread> m_threads;
+        std::atomic<uint32> m_pendingJobs;
+};
+
+#define sAuthWorkerPool MaNGOS::Singleton<AuthWorkerPool>::Instance()
+
+#endif
+/// @}
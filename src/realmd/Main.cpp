@@ -27,6 +27,7 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_sql.h"
@@ -217,8 +218,14 @@ int main(int argc, char* argv[])
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE expires_at<=UNIX_TIMESTAMP() AND expires_at<>banned_at");
     LoginDatabase.CommitTransaction();
 
-    // FIXME - more intelligent selection of thread count is needed here.  config option?
-    MaNGOS::Listener<AuthSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), sConfig.GetIntDefault("RealmServerPort", DEFAULT_REALMSERVER_PORT), 1);
+    ///- Start the workers before accepting so the first connections already find them
+    sAuthWorkerPool.Start(sConfig.GetIntDefault("AuthWorkerThreads", 2));
+
+    int networkThreads = sConfig.GetIntDefault("NetworkThreads", 1);
+    if (networkThreads < 1)
+        networkThreads = 1;
+
+    MaNGOS::Listener<AuthSocket> listener(sConfig.GetStringDefault("BindIP", "0.0.0.0"), sConfig.GetIntDefault("RealmServerPort", DEFAULT_REALMSERVER_PORT), networkThreads);
 
     ///- Catch termination signals
     HookSignals();
@@ -269,6 +276,9 @@ int main(int argc, char* argv[])
     // server has started up successfully => enable async DB requests
     LoginDatabase.AllowAsyncTransactions();
 
+    // same for log output
+    sLog.StartAsync();
+
     // maximum counter for next ping
     auto const numLoops = sConfig.GetIntDefault("MaxPingTime", 30) * MINUTE * 10;
     uint32 loopCounter = 0;
@@ -292,12 +302,18 @@ int main(int argc, char* argv[])
 #endif
     }
 
+    ///- Finish queued authentication jobs before the database goes away
+    sAuthWorkerPool.Stop();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
     ///- Remove signal handling before leaving
     UnhookSignals();
 
+    ///- Write all still queued log records
+    sLog.StopAsync();
+
     sLog.outString("Halting process...");
     return 0;
 }
@@ -332,9 +348,11 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    // one connection per auth worker avoids them waiting on each other for a connection
+    int nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 2);
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
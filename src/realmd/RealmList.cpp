@@ -75,7 +75,7 @@ RealmBuildInfo const* FindBuildInfo(uint16 _build)
     return nullptr;
 }
 
-RealmList::RealmList() : m_UpdateInterval(0), m_NextUpdateTime(time(nullptr))
+RealmList::RealmList() : m_realms(new RealmMap()), m_UpdateInterval(0), m_NextUpdateTime(time(nullptr))
 {
 }
 
@@ -94,10 +94,10 @@ void RealmList::Initialize(uint32 updateInterval)
     UpdateRealms(true);
 }
 
-void RealmList::UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
+void RealmList::UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds)
 {
     ///- Create new if not exist or update existed
-    Realm& realm = m_realms[name];
+    Realm& realm = realms[name];
 
     realm.m_ID       = ID;
     realm.icon       = icon;
@@ -139,15 +139,23 @@ void RealmList::UpdateIfNeed()
     if (!m_UpdateInterval || m_NextUpdateTime > time(nullptr))
         return;
 
-    m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
+    // another thread is already reloading, keep serving the current list meanwhile
+    std::unique_lock<std::mutex> guard(m_updateLock, std::try_to_lock);
+    if (!guard.owns_lock() || m_NextUpdateTime > time(nullptr))
+        return;
 
-    // Clears Realm list
-    m_realms.clear();
+    m_NextUpdateTime = time(nullptr) + m_UpdateInterval;
 
     // Get the content of the realmlist table in the database
     UpdateRealms(false);
 }
 
+RealmList::RealmMapPtr RealmList::GetRealms() const
+{
+    std::lock_guard<std::mutex> guard(m_realmsLock);
+    return m_realms;
+}
+
 void RealmList::UpdateRealms(bool init)
 {
     DETAIL_LOG("Updating Realm List...");
@@ -155,6 +163,8 @@ void RealmList::UpdateRealms(bool init)
     ////                                               0   1     2        3     4     5           6         7                     8           9
     QueryResult* result = LoginDatabase.Query("SELECT id, name, address, port, icon, realmflags, timezone, allowedSecurityLevel, population, realmbuilds FROM realmlist WHERE (realmflags & 1) = 0 ORDER BY name");
 
+    std::shared_ptr<RealmMap> realms(new RealmMap());
+
     ///- Circle through results and add them to the realm map
     if (result)
     {
@@ -173,7 +183,7 @@ void RealmList::UpdateRealms(bool init)
                 realmflags &= (REALM_FLAG_OFFLINE | REALM_FLAG_NEW_PLAYERS | REALM_FLAG_RECOMMENDED | REALM_FLAG_SPECIFYBUILD);
             }
 
-            UpdateRealm(
+            UpdateRealm(*realms,
                 Id, name, fields[2].GetCppString(), fields[3].GetUInt32(),
                 fields[4].GetUInt8(), RealmFlags(realmflags), fields[6].GetUInt8(),
                 (allowedSecurityLevel <= SEC_ADMINISTRATOR ? AccountTypes(allowedSecurityLevel) : SEC_ADMINISTRATOR),
@@ -185,4 +195,7 @@ void RealmList::UpdateRealms(bool init)
         while (result->NextRow());
         delete result;
     }
+
+    std::lock_guard<std::mutex> guard(m_realmsLock);
+    m_realms = realms;
 }
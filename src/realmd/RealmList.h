@@ -25,6 +25,9 @@
 
 #include "Common.h"
 #include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 struct RealmBuildInfo
 {
@@ -60,6 +63,7 @@ class RealmList
 {
     public:
         typedef std::map<std::string, Realm> RealmMap;
+        typedef std::shared_ptr<RealmMap const> RealmMapPtr;
 
         static RealmList& Instance();
 
@@ -70,16 +74,20 @@ class RealmList
 
         void UpdateIfNeed();
 
-        RealmMap::const_iterator begin() const { return m_realms.begin(); }
-        RealmMap::const_iterator end() const { return m_realms.end(); }
-        uint32 size() const { return m_realms.size(); }
+        // snapshot of the realm list, stays valid for the caller while another thread reloads the list
+        RealmMapPtr GetRealms() const;
+        uint32 size() const { return GetRealms()->size(); }
+
     private:
         void UpdateRealms(bool init);
-        void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
+        static void UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
+
     private:
-        RealmMap m_realms;                                  ///< Internal map of realms
+        RealmMapPtr m_realms;                               ///< Internal map of realms, replaced as a whole at update
+        mutable std::mutex m_realmsLock;                    ///< Guards m_realms pointer swap
+        std::mutex m_updateLock;                            ///< Held by the thread reloading the list from DB
         uint32   m_UpdateInterval;
-        time_t   m_NextUpdateTime;
+        std::atomic<time_t> m_NextUpdateTime;
 };
 
 #define sRealmList RealmList::Instance()
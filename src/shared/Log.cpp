@@ -25,12 +25,18 @@
 #include "ProgressBar.h"
 
 #include <stdarg.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <thread>
 
 INSTANTIATE_SINGLETON_1(Log);
 
+// The async writer sleeps this long when it found nothing to write
+static const uint32 LOG_ASYNC_IDLE_SLEEP_MS = 10;
+// and reports records dropped because of full thread buffers at most this often (seconds)
+static const time_t LOG_ASYNC_DROP_REPORT_INTERVAL = 10;
+
 LogFilterData logFilterData[LOG_FILTER_COUNT] =
 {
     { "transport_moves",     "LogFilter_TransportMoves",     true  },
@@ -66,9 +72,27 @@ enum LogType
 
 const int LogType_count = int(LogError) + 1;
 
+// files a record was written to, so only those get flushed
+enum LogOutput
+{
+    LOG_OUTPUT_STDOUT           = 0x0001,
+    LOG_OUTPUT_STDERR           = 0x0002,
+    LOG_OUTPUT_MAIN             = 0x0004,
+    LOG_OUTPUT_GM               = 0x0008,
+    LOG_OUTPUT_CHAR             = 0x0010,
+    LOG_OUTPUT_DB_ERRORS        = 0x0020,
+    LOG_OUTPUT_EVENTAI_ERRORS   = 0x0040,
+    LOG_OUTPUT_SCRIPT_ERRORS    = 0x0080,
+    LOG_OUTPUT_RA               = 0x0100,
+    LOG_OUTPUT_WORLD            = 0x0200,
+    LOG_OUTPUT_CUSTOM           = 0x0400,
+};
+
 Log::Log() :
     raLogfile(nullptr), logfile(nullptr), gmLogfile(nullptr), charLogfile(nullptr), dberLogfile(nullptr),
-    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
+    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr),
+    m_asyncEnabled(false), m_asyncBlockWhenFull(true), m_asyncBufferSize(0), m_asyncRunning(false), m_asyncAccepting(false), m_asyncProducers(0), m_droppedRecords(0), m_reportedDroppedRecords(0),
+    m_logfileRotateSize(0), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
 {
     Initialize();
 }
@@ -230,6 +254,8 @@ void Log::Initialize()
 
     /// Open specific log files
     logfile = openLogFile("LogFile", "LogTimestamp", "w");
+    m_logfileName = logfile ? GetLogFileName("LogFile", "LogTimestamp") : "";
+    m_logfileRotateSize = std::max(sConfig.GetIntDefault("LogRotateSize", 0), 0) * 1024L * 1024L;
 
     m_gmlog_per_account = sConfig.GetBoolDefault("GmLogPerAccount", false);
     if (!m_gmlog_per_account)
@@ -283,13 +309,18 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    // Async output settings, the writer itself is only started by StartAsync
+    m_asyncEnabled = sConfig.GetBoolDefault("LogAsync", false);
+    m_asyncBufferSize = std::max(sConfig.GetIntDefault("LogAsyncBufferSize", 4096), 64);
+    m_asyncBlockWhenFull = sConfig.GetIntDefault("LogAsyncFullPolicy", 1) != 0;
 }
 
-FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
+std::string Log::GetLogFileName(char const* configFileName, char const* configTimeStampFlag) const
 {
     std::string logfn = sConfig.GetStringDefault(configFileName);
     if (logfn.empty())
-        return nullptr;
+        return logfn;
 
     if (configTimeStampFlag && sConfig.GetBoolDefault(configTimeStampFlag, false))
     {
@@ -300,7 +331,16 @@ FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFl
             logfn += m_logsTimestamp;
     }
 
-    return fopen((m_logsDir + logfn).c_str(), mode);
+    return m_logsDir + logfn;
+}
+
+FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
+{
+    std::string logfn = GetLogFileName(configFileName, configTimeStampFlag);
+    if (logfn.empty())
+        return nullptr;
+
+    return fopen(logfn.c_str(), mode);
 }
 
 FILE* Log::openGmlogPerAccount(uint32 account)
@@ -354,485 +394,614 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outString()
+namespace
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-    printf("\n");
-    if (logfile)
+    void WriteFileTimestamp(FILE* file, time_t t)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        tm* aTm = localtime(&t);
+        fprintf(file, "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
     }
 
-    fflush(stdout);
-}
-
-void Log::outString(const char* str, ...)
-{
-    if (!str)
-        return;
-
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(true, m_colors[LogNormal]);
+    void WriteFileLine(FILE* file, time_t t, char const* prefix, std::string const& text)
+    {
+        WriteFileTimestamp(file, t);
+        if (prefix)
+            fputs(prefix, file);
+        fwrite(text.data(), 1, text.size(), file);
+        fputc('\n', file);
+    }
 
-    if (m_includeTime)
-        outTime();
+    void FormatText(std::string& out, char const* format, va_list* args)
+    {
+        char buf[1024];
 
-    va_list ap;
+        va_list ap;
+        va_copy(ap, *args);
+        int len = vsnprintf(buf, sizeof(buf), format, ap);
+        va_end(ap);
 
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+        if (len < 0)
+        {
+            out.clear();
+            return;
+        }
 
-    if (m_colored)
-        ResetColor(true);
+        if (size_t(len) < sizeof(buf))
+        {
+            out.assign(buf, len);
+            return;
+        }
 
-    printf("\n");
+        out.resize(len);
+        va_copy(ap, *args);
+        vsnprintf(&out[0], len + 1, format, ap);
+        va_end(ap);
+    }
 
-    if (logfile)
+    // flags the buffer for removal once its owning thread exits, remaining records are still written
+    struct ThreadBufferHolder
     {
-        outTimestamp(logfile);
-
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
+        std::shared_ptr<LogRecordBuffer> buffer;
 
-        fflush(logfile);
-    }
+        ~ThreadBufferHolder()
+        {
+            if (buffer)
+                buffer->abandoned = true;
+        }
+    };
 
-    fflush(stdout);
+    thread_local ThreadBufferHolder t_threadBuffer;
+    thread_local LogRecord t_syncRecord;
 }
 
-void Log::outError(const char* err, ...)
+LogRecordBuffer::LogRecordBuffer(size_t capacity) : abandoned(false), m_head(0), m_tail(0)
 {
-    if (!err)
-        return;
-
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
-    va_list ap;
-
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
 
-    if (m_colored)
-        ResetColor(false);
+    m_slots.resize(size);
+    m_mask = size - 1;
+}
 
-    fprintf(stderr, "\n");
-    if (logfile)
+LogRecordBuffer* Log::GetThreadBuffer()
+{
+    if (!t_threadBuffer.buffer)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        t_threadBuffer.buffer = std::make_shared<LogRecordBuffer>(m_asyncBufferSize);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        std::lock_guard<std::mutex> guard(m_buffersLock);
+        m_buffers.push_back(t_threadBuffer.buffer);
     }
 
-    fflush(stderr);
+    return t_threadBuffer.buffer.get();
 }
 
-void Log::outErrorDb()
+LogRecord* Log::BeginRecord(LogRecordType type, bool console, bool toLogfile, uint32 account)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    LogRecord* record = nullptr;
 
-    if (m_includeTime)
-        outTime();
+    if (m_asyncAccepting)
+    {
+        // StopAsync waits for the producers counted here before the final collect
+        ++m_asyncProducers;
 
-    fprintf(stderr, "\n");
+        LogRecordBuffer* buffer = GetThreadBuffer();
+        while (m_asyncAccepting && !(record = buffer->Reserve()))
+        {
+            if (!m_asyncBlockWhenFull)
+            {
+                --m_asyncProducers;
+                ++m_droppedRecords;
+                return nullptr;
+            }
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
+            // writer is behind, wait for it unless it is being stopped
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        if (!record)
+            --m_asyncProducers;
     }
 
-    if (dberLogfile)
+    if (record)
+        record->queued = true;
+    else
     {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
+        record = &t_syncRecord;
+        record->queued = false;
     }
 
-    fflush(stderr);
+    record->type = type;
+    record->console = console;
+    record->logfile = toLogfile;
+    record->account = account;
+    record->time = time(nullptr);
+    return record;
 }
 
-void Log::outErrorDb(const char* err, ...)
+void Log::EndRecord(LogRecord* record)
 {
-    if (!err)
+    if (record->queued)
+    {
+        t_threadBuffer.buffer->Commit();
+        --m_asyncProducers;
         return;
+    }
 
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    uint32 outputs = WriteRecord(*record);
+    RotateLogFileIfNeed();
+    FlushFiles(outputs);
+}
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+void Log::FormatRecord(LogRecordType type, bool console, bool toLogfile, uint32 account, char const* format, va_list* args)
+{
+    if (LogRecord* record = BeginRecord(type, console, toLogfile, account))
+    {
+        if (format)
+            FormatText(record->text, format, args);
+        else
+            record->text.clear();
 
-    if (m_includeTime)
-        outTime();
+        EndRecord(record);
+    }
+}
 
-    va_list ap;
+uint32 Log::WriteConsole(LogRecord const& record)
+{
+    bool toStdout = true;
+    Color color = m_colors[LogNormal];
+    switch (record.type)
+    {
+        case LOG_RECORD_ERROR:
+        case LOG_RECORD_ERROR_DB:
+        case LOG_RECORD_ERROR_EVENTAI:
+        case LOG_RECORD_ERROR_SCRIPTLIB:
+            toStdout = false;
+            color = m_colors[LogError];
+            break;
+        case LOG_RECORD_BASIC:
+        case LOG_RECORD_DETAIL:
+        case LOG_RECORD_COMMAND:
+            color = m_colors[LogDetails];
+            break;
+        case LOG_RECORD_DEBUG:
+            color = m_colors[LogDebug];
+            break;
+        default:
+            break;
+    }
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+    FILE* stream = toStdout ? stdout : stderr;
 
     if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
+        SetColor(toStdout, color);
 
-    if (logfile)
+    if (m_includeTime)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        tm* aTm = localtime(&record.time);
+        fprintf(stream, "%02d:%02d:%02d ", aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
     }
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
+    utf8printf(stream, "%s", record.text.c_str());
 
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
+    if (m_colored)
+        ResetColor(toStdout);
 
-    fflush(stderr);
+    fputc('\n', stream);
+    return toStdout ? LOG_OUTPUT_STDOUT : LOG_OUTPUT_STDERR;
 }
 
-void Log::outErrorEventAI()
+uint32 Log::WriteRecord(LogRecord const& record)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    uint32 outputs = 0;
+    if (record.console)
+        outputs |= WriteConsole(record);
 
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
+    FILE* mainFile = record.logfile ? logfile : nullptr;
 
-    if (logfile)
+    switch (record.type)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+        case LOG_RECORD_STRING:
+        case LOG_RECORD_BASIC:
+        case LOG_RECORD_DETAIL:
+        case LOG_RECORD_DEBUG:
+            if (mainFile)
+            {
+                WriteFileLine(mainFile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_MAIN;
+            }
+            break;
+        case LOG_RECORD_ERROR:
+            if (mainFile)
+            {
+                WriteFileLine(mainFile, record.time, "ERROR:", record.text);
+                outputs |= LOG_OUTPUT_MAIN;
+            }
+            break;
+        case LOG_RECORD_ERROR_DB:
+            if (mainFile)
+            {
+                WriteFileLine(mainFile, record.time, "ERROR:", record.text);
+                outputs |= LOG_OUTPUT_MAIN;
+            }
+            if (dberLogfile)
+            {
+                WriteFileLine(dberLogfile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_DB_ERRORS;
+            }
+            break;
+        case LOG_RECORD_ERROR_EVENTAI:
+            if (mainFile)
+            {
+                WriteFileLine(mainFile, record.time, "ERROR CreatureEventAI: ", record.text);
+                outputs |= LOG_OUTPUT_MAIN;
+            }
+            if (eventAiErLogfile)
+            {
+                WriteFileLine(eventAiErLogfile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_EVENTAI_ERRORS;
+            }
+            break;
+        case LOG_RECORD_ERROR_SCRIPTLIB:
+            if (mainFile)
+            {
+                WriteFileTimestamp(mainFile, record.time);
+                if (m_scriptLibName)
+                    fprintf(mainFile, "<%s ERROR>: ", m_scriptLibName);
+                else
+                    fprintf(mainFile, "<Scripting Library ERROR>: ");
+                fprintf(mainFile, "%s\n", record.text.c_str());
+                outputs |= LOG_OUTPUT_MAIN;
+            }
+            if (scriptErrLogFile)
+            {
+                WriteFileLine(scriptErrLogFile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_SCRIPT_ERRORS;
+            }
+            break;
+        case LOG_RECORD_COMMAND:
+            if (mainFile)
+            {
+                WriteFileLine(mainFile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_MAIN;
+            }
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
+            if (m_gmlog_per_account)
+            {
+                if (FILE* per_file = openGmlogPerAccount(record.account))
+                {
+                    WriteFileLine(per_file, record.time, nullptr, record.text);
+                    fclose(per_file);
+                }
+            }
+            else if (gmLogfile)
+            {
+                WriteFileLine(gmLogfile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_GM;
+            }
+            break;
+        case LOG_RECORD_CHAR:
+            if (charLogfile)
+            {
+                WriteFileLine(charLogfile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_CHAR;
+            }
+            break;
+        case LOG_RECORD_RA:
+            if (raLogfile)
+            {
+                WriteFileLine(raLogfile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_RA;
+            }
+            break;
+        case LOG_RECORD_CUSTOM:
+            if (customLogFile)
+            {
+                WriteFileLine(customLogFile, record.time, nullptr, record.text);
+                outputs |= LOG_OUTPUT_CUSTOM;
+            }
+            break;
+        case LOG_RECORD_WORLD_PACKET:
+            if (worldLogfile)
+            {
+                WriteFileTimestamp(worldLogfile, record.time);
+                fwrite(record.text.data(), 1, record.text.size(), worldLogfile);
+                outputs |= LOG_OUTPUT_WORLD;
+            }
+            break;
+        case LOG_RECORD_CHAR_DUMP:
+            if (charLogfile)
+            {
+                fwrite(record.text.data(), 1, record.text.size(), charLogfile);
+                outputs |= LOG_OUTPUT_CHAR;
+            }
+            break;
     }
 
-    fflush(stderr);
+    return outputs;
 }
 
-void Log::outErrorEventAI(const char* err, ...)
+void Log::FlushFiles(uint32 outputs)
 {
-    if (!err)
-        return;
-
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
-    va_list ap;
+    // same order as the LogOutput bits
+    FILE* const files[] = { stdout, stderr, logfile, gmLogfile, charLogfile, dberLogfile, eventAiErLogfile, scriptErrLogFile, raLogfile, worldLogfile, customLogFile };
+    for (uint32 i = 0; i < sizeof(files) / sizeof(files[0]); ++i)
+        if ((outputs & (1 << i)) && files[i])
+            fflush(files[i]);
+}
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+void Log::RotateLogFileIfNeed()
+{
+    if (!m_logfileRotateSize || !logfile || ftell(logfile) < m_logfileRotateSize)
+        return;
 
-    if (m_colored)
-        ResetColor(false);
+    fclose(logfile);
 
-    fprintf(stderr, "\n");
+    size_t dot_pos = m_logfileName.find_last_of('.');
+    if (dot_pos == std::string::npos || m_logfileName.find_first_of("/\\", dot_pos) != std::string::npos)
+        dot_pos = m_logfileName.size();
 
-    if (logfile)
+    // several rotations can happen within the same second under heavy output
+    std::string const suffix = "_" + GetTimestampStr();
+    std::string rotatedName;
+    for (uint32 i = 0;; ++i)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        rotatedName = m_logfileName;
+        rotatedName.insert(dot_pos, i ? suffix + "_" + std::to_string(i) : suffix);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        FILE* existing = fopen(rotatedName.c_str(), "r");
+        if (!existing)
+            break;
+        fclose(existing);
     }
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
-        va_end(ap);
+    rename(m_logfileName.c_str(), rotatedName.c_str());
+    logfile = fopen(m_logfileName.c_str(), "w");
+}
 
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+void Log::StartAsync()
+{
+    if (!m_asyncEnabled || m_asyncThread.joinable())
+        return;
 
-    fflush(stderr);
+    m_asyncRunning = true;
+    m_asyncAccepting = true;
+    m_asyncThread = std::thread(&Log::AsyncWriterThread, this);
 }
 
-void Log::outBasic(const char* str, ...)
+void Log::StopAsync()
 {
-    if (!str)
+    if (!m_asyncThread.joinable())
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_BASIC)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
-
-        if (m_includeTime)
-            outTime();
+    // new records go out synchronously, the ones being written still land in the buffers
+    m_asyncAccepting = false;
+    while (m_asyncProducers)
+        std::this_thread::yield();
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    m_asyncRunning = false;
+    m_asyncThread.join();
 
-        if (m_colored)
-            ResetColor(true);
+    // records committed while the writer was finishing
+    CollectRecords();
+    ReportDroppedRecords();
+}
 
-        printf("\n");
-    }
+void Log::AsyncWriterThread()
+{
+    time_t nextDropReport = time(nullptr) + LOG_ASYNC_DROP_REPORT_INTERVAL;
 
-    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
+    while (m_asyncRunning)
     {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
+        if (!CollectRecords())
+            std::this_thread::sleep_for(std::chrono::milliseconds(LOG_ASYNC_IDLE_SLEEP_MS));
+
+        time_t now = time(nullptr);
+        if (now >= nextDropReport)
+        {
+            ReportDroppedRecords();
+            nextDropReport = now + LOG_ASYNC_DROP_REPORT_INTERVAL;
+        }
     }
 
-    fflush(stdout);
+    CollectRecords();
 }
 
-void Log::outDetail(const char* str, ...)
+size_t Log::CollectRecords()
 {
-    if (!str)
-        return;
+    size_t written = 0;
+    uint32 outputs = 0;
+    bool abandoned = false;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
+    // the buffer list is only copied under its lock, threads logging for the first time don't wait for the file output
     {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
+        std::lock_guard<std::mutex> buffersGuard(m_buffersLock);
+        m_collectBuffers.assign(m_buffers.begin(), m_buffers.end());
+    }
 
-        if (m_includeTime)
-            outTime();
+    {
+        // records of one thread keep their order, records of different threads are grouped per thread within a batch
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
+        for (auto const& buffer : m_collectBuffers)
+        {
+            written += buffer->Drain([this, &outputs](LogRecord const& record) { outputs |= WriteRecord(record); });
+            abandoned = abandoned || buffer->abandoned;
+        }
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+        if (written)
+        {
+            RotateLogFileIfNeed();
+            FlushFiles(outputs);
+        }
+    }
 
-        if (m_colored)
-            ResetColor(true);
+    m_collectBuffers.clear();
 
-        printf("\n");
+    if (abandoned)
+    {
+        // a buffer abandoned after the drain above still gets its last records written by the next collect
+        std::lock_guard<std::mutex> buffersGuard(m_buffersLock);
+        m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [](std::shared_ptr<LogRecordBuffer> const& buffer)
+        {
+            return buffer->abandoned && buffer->IsEmpty();
+        }), m_buffers.end());
     }
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        outTimestamp(logfile);
+    return written;
+}
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+void Log::ReportDroppedRecords()
+{
+    uint64 dropped = m_droppedRecords;
+    if (dropped == m_reportedDroppedRecords)
+        return;
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    LogRecord record;
+    record.type = LOG_RECORD_ERROR;
+    record.console = true;
+    record.logfile = true;
+    record.time = time(nullptr);
+    record.text = "Log: " + std::to_string(dropped - m_reportedDroppedRecords) + " records dropped, async log buffers are full (total " + std::to_string(dropped) + ")";
+    m_reportedDroppedRecords = dropped;
 
-    fflush(stdout);
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    FlushFiles(WriteRecord(record));
 }
 
-void Log::outDebug(const char* str, ...)
+void Log::outString()
+{
+    FormatRecord(LOG_RECORD_STRING, true, logfile != nullptr, 0, nullptr, nullptr);
+}
+
+void Log::outString(const char* str, ...)
 {
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DEBUG)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDebug]);
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_STRING, true, logfile != nullptr, 0, str, &ap);
+    va_end(ap);
+}
 
-        if (m_includeTime)
-            outTime();
+void Log::outError(const char* err, ...)
+{
+    if (!err)
+        return;
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    va_list ap;
+    va_start(ap, err);
+    FormatRecord(LOG_RECORD_ERROR, true, logfile != nullptr, 0, err, &ap);
+    va_end(ap);
+}
 
-        if (m_colored)
-            ResetColor(true);
+void Log::outErrorDb()
+{
+    FormatRecord(LOG_RECORD_ERROR_DB, true, logfile != nullptr, 0, nullptr, nullptr);
+}
 
-        printf("\n");
-    }
+void Log::outErrorDb(const char* err, ...)
+{
+    if (!err)
+        return;
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
-    {
-        outTimestamp(logfile);
+    va_list ap;
+    va_start(ap, err);
+    FormatRecord(LOG_RECORD_ERROR_DB, true, logfile != nullptr, 0, err, &ap);
+    va_end(ap);
+}
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+void Log::outErrorEventAI()
+{
+    FormatRecord(LOG_RECORD_ERROR_EVENTAI, true, logfile != nullptr, 0, nullptr, nullptr);
+}
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+void Log::outErrorEventAI(const char* err, ...)
+{
+    if (!err)
+        return;
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, err);
+    FormatRecord(LOG_RECORD_ERROR_EVENTAI, true, logfile != nullptr, 0, err, &ap);
+    va_end(ap);
 }
 
-void Log::outCommand(uint32 account, const char* str, ...)
+void Log::outBasic(const char* str, ...)
 {
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
+    bool console = m_logLevel >= LOG_LVL_BASIC;
+    bool toLogfile = logfile && m_logFileLevel >= LOG_LVL_BASIC;
+    if (!console && !toLogfile)
+        return;
 
-        if (m_includeTime)
-            outTime();
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_BASIC, console, toLogfile, 0, str, &ap);
+    va_end(ap);
+}
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+void Log::outDetail(const char* str, ...)
+{
+    if (!str)
+        return;
 
-        if (m_colored)
-            ResetColor(true);
+    bool console = m_logLevel >= LOG_LVL_DETAIL;
+    bool toLogfile = logfile && m_logFileLevel >= LOG_LVL_DETAIL;
+    if (!console && !toLogfile)
+        return;
 
-        printf("\n");
-    }
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_DETAIL, console, toLogfile, 0, str, &ap);
+    va_end(ap);
+}
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+void Log::outDebug(const char* str, ...)
+{
+    if (!str)
+        return;
 
-    if (m_gmlog_per_account)
-    {
-        if (FILE* per_file = openGmlogPerAccount(account))
-        {
-            va_list ap;
-            outTimestamp(per_file);
-            va_start(ap, str);
-            vfprintf(per_file, str, ap);
-            fprintf(per_file, "\n");
-            va_end(ap);
-            fclose(per_file);
-        }
-    }
-    else if (gmLogfile)
-    {
-        va_list ap;
-        outTimestamp(gmLogfile);
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
-        va_end(ap);
-        fflush(gmLogfile);
-    }
+    bool console = m_logLevel >= LOG_LVL_DEBUG;
+    bool toLogfile = logfile && m_logFileLevel >= LOG_LVL_DEBUG;
+    if (!console && !toLogfile)
+        return;
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_DEBUG, console, toLogfile, 0, str, &ap);
+    va_end(ap);
 }
 
-void Log::outChar(const char* str, ...)
+void Log::outCommand(uint32 account, const char* str, ...)
 {
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (charLogfile)
-    {
-        va_list ap;
-        outTimestamp(charLogfile);
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_COMMAND, m_logLevel >= LOG_LVL_DETAIL, logfile && m_logFileLevel >= LOG_LVL_DETAIL, account, str, &ap);
+    va_end(ap);
 }
 
-void Log::outErrorScriptLib()
+void Log::outChar(const char* str, ...)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
-    }
+    if (!str || !charLogfile)
+        return;
 
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_CHAR, false, false, 0, str, &ap);
+    va_end(ap);
+}
 
-    fflush(stderr);
+void Log::outErrorScriptLib()
+{
+    FormatRecord(LOG_RECORD_ERROR_SCRIPTLIB, true, logfile != nullptr, 0, nullptr, nullptr);
 }
 
 void Log::outErrorScriptLib(const char* err, ...)
@@ -840,54 +1009,10 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
-
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    FormatRecord(LOG_RECORD_ERROR_SCRIPTLIB, true, logfile != nullptr, 0, err, &ap);
     va_end(ap);
-
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
-        va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
 }
 
 void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opcodeName, ByteBuffer const& packet, bool incoming)
@@ -895,76 +1020,68 @@ void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opco
     if (!worldLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    outTimestamp(worldLogfile);
+    LogRecord* record = BeginRecord(LOG_RECORD_WORLD_PACKET, false, false);
+    if (!record)
+        return;
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    char buf[256];
+    snprintf(buf, sizeof(buf), "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
+             incoming ? "CLIENT" : "SERVER",
+             socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    record->text = buf;
 
     size_t p = 0;
     while (p < packet.size())
     {
         for (size_t j = 0; j < 16 && p < packet.size(); ++j)
-            fprintf(worldLogfile, "%.2X ", packet[p++]);
+        {
+            snprintf(buf, sizeof(buf), "%.2X ", packet[p++]);
+            record->text += buf;
+        }
 
-        fprintf(worldLogfile, "\n");
+        record->text += '\n';
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    record->text += "\n\n";
+    EndRecord(record);
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (!charLogfile)
+        return;
 
-    if (charLogfile)
+    if (LogRecord* record = BeginRecord(LOG_RECORD_CHAR_DUMP, false, false))
     {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
+        char buf[256];
+        snprintf(buf, sizeof(buf), "== START DUMP == (account: %u guid: %u name: %s )\n", account_id, guid, name);
+        record->text = buf;
+        record->text += str;
+        record->text += "\n== END DUMP ==\n";
+        EndRecord(record);
     }
 }
 
 void Log::outRALog(const char* str, ...)
 {
-    if (!str)
+    if (!str || !raLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (raLogfile)
-    {
-        va_list ap;
-        outTimestamp(raLogfile);
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
-        va_end(ap);
-        fflush(raLogfile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_RA, false, false, 0, str, &ap);
+    va_end(ap);
 }
 
 void Log::outCustomLog(const char* str, ...)
 {
-    if (!str)
+    if (!str || !customLogFile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (customLogFile)
-    {
-        va_list ap;
-        outTimestamp(customLogFile);
-        va_start(ap, str);
-        vfprintf(customLogFile, str, ap);
-        fprintf(customLogFile, "\n");
-        va_end(ap);
-        fflush(customLogFile);
-    }
-
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    FormatRecord(LOG_RECORD_CUSTOM, false, false, 0, str, &ap);
+    va_end(ap);
 }
 
 void Log::WaitBeforeContinueIfNeed()
@@ -992,6 +1109,8 @@ void Log::WaitBeforeContinueIfNeed()
 
 void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+
     m_scriptLibName = libName;
 
     if (scriptErrLogFile)
@@ -22,7 +22,12 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 
+#include <atomic>
+#include <cstdarg>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 class Config;
 class ByteBuffer;
@@ -93,6 +98,77 @@ enum Color
 
 const int Color_count = int(WHITE) + 1;
 
+enum LogRecordType : uint8
+{
+    LOG_RECORD_STRING,
+    LOG_RECORD_ERROR,
+    LOG_RECORD_ERROR_DB,
+    LOG_RECORD_ERROR_EVENTAI,
+    LOG_RECORD_ERROR_SCRIPTLIB,
+    LOG_RECORD_BASIC,
+    LOG_RECORD_DETAIL,
+    LOG_RECORD_DEBUG,
+    LOG_RECORD_COMMAND,
+    LOG_RECORD_CHAR,
+    LOG_RECORD_RA,
+    LOG_RECORD_CUSTOM,
+    LOG_RECORD_WORLD_PACKET,
+    LOG_RECORD_CHAR_DUMP
+};
+
+// Message already formatted by the caller, decorated (time, prefixes, colors) and written by the log writer
+struct LogRecord
+{
+    LogRecord() : type(LOG_RECORD_STRING), console(false), logfile(false), queued(false), account(0), time(0) {}
+
+    LogRecordType type;
+    bool console;                                           // level allows console output
+    bool logfile;                                           // level allows main log file output
+    bool queued;                                            // slot of a thread buffer, not the synchronous scratch record
+    uint32 account;                                         // gm command log owner
+    time_t time;
+    std::string text;                                       // capacity is kept when the slot is reused
+};
+
+// Single producer/single consumer ring of preallocated records, one per logging thread
+class LogRecordBuffer
+{
+    public:
+        explicit LogRecordBuffer(size_t capacity);
+
+        // producer thread only, nullptr when full
+        LogRecord* Reserve()
+        {
+            size_t const head = m_head.load(std::memory_order_relaxed);
+            if (head - m_tail.load(std::memory_order_acquire) >= m_slots.size())
+                return nullptr;
+            return &m_slots[head & m_mask];
+        }
+        void Commit() { m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+        // writer thread only
+        template <class F> size_t Drain(F&& consumer)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            size_t const head = m_head.load(std::memory_order_acquire);
+            size_t const count = head - tail;
+            for (; tail != head; ++tail)
+                consumer(m_slots[tail & m_mask]);
+            m_tail.store(tail, std::memory_order_release);
+            return count;
+        }
+
+        bool IsEmpty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+        std::atomic<bool> abandoned;                        // owning thread exited
+
+    private:
+        std::vector<LogRecord> m_slots;
+        size_t m_mask;
+        std::atomic<size_t> m_head;
+        std::atomic<size_t> m_tail;
+};
+
 class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::mutex> >
 {
         friend class MaNGOS::OperatorNew<Log>;
@@ -100,6 +176,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         ~Log()
         {
+            StopAsync();
+
             if (logfile != nullptr)
                 fclose(logfile);
             logfile = nullptr;
@@ -185,13 +263,37 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         bool HasLogLevelOrHigher(LogLevel loglvl) const { return m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile); }
         bool IsOutCharDump() const { return m_charLog_Dump; }
         bool IsIncludeTime() const { return m_includeTime; }
+        std::string const& GetLogsDir() const { return m_logsDir; }
 
         static void WaitBeforeContinueIfNeed();
 
         // Set filename for scriptlibrary error output
         void setScriptLibraryErrorFile(char const* fname, char const* libName);
 
+        // Hand output over to the background writer (if LogAsync is enabled) / flush and return to synchronous output.
+        // Startup and shutdown stay synchronous so their output is not interleaved with progress bars and direct printf calls.
+        void StartAsync();
+        void StopAsync();
+        bool IsAsync() const { return m_asyncRunning; }
+        uint64 GetDroppedRecords() const { return m_droppedRecords; }
+
     private:
+        LogRecord* BeginRecord(LogRecordType type, bool console, bool toLogfile, uint32 account = 0);
+        void EndRecord(LogRecord* record);
+        void FormatRecord(LogRecordType type, bool console, bool toLogfile, uint32 account, char const* format, va_list* args);
+
+        LogRecordBuffer* GetThreadBuffer();
+        void AsyncWriterThread();
+        size_t CollectRecords();
+        void ReportDroppedRecords();
+
+        // callers hold m_worldLogMtx
+        uint32 WriteRecord(LogRecord const& record);        // returns the LogOutput flags written to
+        uint32 WriteConsole(LogRecord const& record);
+        void FlushFiles(uint32 outputs);
+        void RotateLogFileIfNeed();
+
+        std::string GetLogFileName(char const* configFileName, char const* configTimeStampFlag) const;
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
@@ -204,7 +306,25 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         FILE* scriptErrLogFile;
         FILE* worldLogfile;
         FILE* customLogFile;
-        std::mutex m_worldLogMtx;
+        std::mutex m_worldLogMtx;                           // serializes console and file output
+
+        // async output control
+        bool m_asyncEnabled;
+        bool m_asyncBlockWhenFull;
+        size_t m_asyncBufferSize;
+        std::atomic<bool> m_asyncRunning;                   // writer thread runs
+        std::atomic<bool> m_asyncAccepting;                 // new records may be queued
+        std::atomic<uint32> m_asyncProducers;               // threads between queuing a record and committing it
+        std::thread m_asyncThread;
+        std::mutex m_buffersLock;                           // only taken when a thread logs for the first time and by the writer
+        std::vector<std::shared_ptr<LogRecordBuffer>> m_buffers;
+        std::vector<std::shared_ptr<LogRecordBuffer>> m_collectBuffers;     // writer thread only
+        std::atomic<uint64> m_droppedRecords;
+        uint64 m_reportedDroppedRecords;
+
+        // main log file rotation
+        std::string m_logfileName;
+        long m_logfileRotateSize;
 
         // log/console control
         LogLevel m_logLevel;
@@ -0,0 +1,246 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Memory/SlabPool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace MaNGOS
+{
+    namespace
+    {
+        // registry of pools, never destroyed so pools can still unregister at process exit
+        std::mutex& GetRegistryMutex()
+        {
+            static std::mutex* registryMutex = new std::mutex();
+            return *registryMutex;
+        }
+
+        std::vector<SlabPool*>& GetRegistry()
+        {
+            static std::vector<SlabPool*>* registry = new std::vector<SlabPool*>();
+            return *registry;
+        }
+
+        size_t& GetNextPoolId()
+        {
+            static size_t nextPoolId = 0;
+            return nextPoolId;
+        }
+
+        // thread caches hold up to twice this many blocks, smaller pools use half a slab
+        size_t const THREAD_CACHE_BATCH = 32;
+
+        // plain flag without destructor, still valid after the caches of the thread are gone
+        thread_local bool t_cachesDestroyed = false;
+
+        size_t AlignBlockSize(size_t size)
+        {
+            size_t const alignment = alignof(std::max_align_t);
+            size = std::max(size, sizeof(void*));
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    SlabPool::SlabPool(char const* name, size_t blockSize, size_t blocksPerSlab) :
+        m_name(name), m_id(0), m_blockSize(AlignBlockSize(blockSize)), m_blocksPerSlab(std::max(blocksPerSlab, size_t(1))),
+        m_cacheBatch(std::max(std::min(THREAD_CACHE_BATCH, m_blocksPerSlab / 2), size_t(1))),
+        m_freeList(nullptr), m_blocksInUse(0), m_peakBlocksInUse(0), m_totalAllocations(0), m_fallbackAllocations(0)
+    {
+        std::lock_guard<std::mutex> guard(GetRegistryMutex());
+        m_id = GetNextPoolId()++;
+        GetRegistry().push_back(this);
+    }
+
+    struct SlabPool::ThreadCaches
+    {
+        ~ThreadCaches()
+        {
+            t_cachesDestroyed = true;
+
+            // hand the cached blocks back to the pools still alive
+            std::lock_guard<std::mutex> guard(GetRegistryMutex());
+            for (SlabPool* pool : GetRegistry())
+                if (pool->m_id < caches.size() && caches[pool->m_id].count)
+                    pool->Flush(caches[pool->m_id], caches[pool->m_id].count);
+        }
+
+        std::vector<ThreadCache> caches;
+    };
+
+    SlabPool::ThreadCache* SlabPool::GetThreadCache(size_t poolId)
+    {
+        if (t_cachesDestroyed)
+            return nullptr;
+
+        thread_local ThreadCaches t_caches;
+        if (poolId >= t_caches.caches.size())
+            t_caches.caches.resize(poolId + 1);
+
+        return &t_caches.caches[poolId];
+    }
+
+    SlabPool::~SlabPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(GetRegistryMutex());
+            std::vector<SlabPool*>& registry = GetRegistry();
+            registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+        }
+
+        for (char* slab : m_slabs)
+            ::operator delete(slab);
+    }
+
+    void* SlabPool::Allocate(size_t size)
+    {
+        if (size > m_blockSize)
+        {
+            ++m_fallbackAllocations;
+            return ::operator new(size);
+        }
+
+        FreeBlock* block;
+        if (ThreadCache* cache = GetThreadCache(m_id))
+        {
+            if (!cache->count)
+                Refill(*cache);
+
+            block = cache->head;
+            cache->head = block->next;
+            --cache->count;
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            block = AllocateLocked();
+        }
+
+        ++m_totalAllocations;
+        size_t inUse = ++m_blocksInUse;
+        size_t peak = m_peakBlocksInUse.load(std::memory_order_relaxed);
+        while (inUse > peak && !m_peakBlocksInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {}
+
+        return block;
+    }
+
+    void SlabPool::Deallocate(void* block, size_t size)
+    {
+        if (!block)
+            return;
+
+        if (size > m_blockSize)
+        {
+            ::operator delete(block);
+            return;
+        }
+
+        // blocks freed by another thread than the allocating one simply move to the cache of this thread
+        FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+        if (ThreadCache* cache = GetThreadCache(m_id))
+        {
+            freeBlock->next = cache->head;
+            cache->head = freeBlock;
+            if (++cache->count >= 2 * m_cacheBatch)
+                Flush(*cache, m_cacheBatch);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            freeBlock->next = m_freeList;
+            m_freeList = freeBlock;
+        }
+        --m_blocksInUse;
+    }
+
+    SlabPool::FreeBlock* SlabPool::AllocateLocked()
+    {
+        if (!m_freeList)
+            AllocateSlab();
+
+        FreeBlock* block = m_freeList;
+        m_freeList = block->next;
+        return block;
+    }
+
+    void SlabPool::Refill(ThreadCache& cache)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (size_t i = 0; i < m_cacheBatch; ++i)
+        {
+            FreeBlock* block = AllocateLocked();
+            block->next = cache.head;
+            cache.head = block;
+        }
+        cache.count += m_cacheBatch;
+    }
+
+    void SlabPool::Flush(ThreadCache& cache, size_t count)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (size_t i = 0; i < count; ++i)
+        {
+            FreeBlock* block = cache.head;
+            cache.head = block->next;
+            block->next = m_freeList;
+            m_freeList = block;
+        }
+        cache.count -= count;
+    }
+
+    void SlabPool::AllocateSlab()
+    {
+        char* slab = static_cast<char*>(::operator new(m_blockSize * m_blocksPerSlab));
+        m_slabs.push_back(slab);
+
+        // thread blocks in reverse so the first allocations come from the start of the slab
+        for (size_t i = m_blocksPerSlab; i > 0; --i)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * m_blockSize);
+            block->next = m_freeList;
+            m_freeList = block;
+        }
+    }
+
+    SlabPoolStats SlabPool::GetStats() const
+    {
+        SlabPoolStats stats;
+        stats.name = m_name;
+        stats.blockSize = m_blockSize;
+        stats.blocksPerSlab = m_blocksPerSlab;
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            stats.slabCount = m_slabs.size();
+        }
+        stats.blocksInUse = m_blocksInUse;
+        stats.peakBlocksInUse = m_peakBlocksInUse;
+        stats.totalAllocations = m_totalAllocations;
+        stats.fallbackAllocations = m_fallbackAllocations;
+        return stats;
+    }
+
+    std::vector<SlabPoolStats> SlabPool::GetAllStats()
+    {
+        std::vector<SlabPoolStats> result;
+        std::lock_guard<std::mutex> guard(GetRegistryMutex());
+        for (SlabPool const* pool : GetRegistry())
+            result.push_back(pool->GetStats());
+        return result;
+    }
+}
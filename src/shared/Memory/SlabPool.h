@@ -0,0 +1,109 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SLABPOOL_H
+#define MANGOS_SLABPOOL_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace MaNGOS
+{
+    struct SlabPoolStats
+    {
+        std::string name;
+        size_t blockSize;
+        size_t blocksPerSlab;
+        size_t slabCount;
+        size_t blocksInUse;
+        size_t peakBlocksInUse;
+        uint64 totalAllocations;
+        uint64 fallbackAllocations;
+    };
+
+    /**
+     * Fixed block size allocator for hot, frequently churned objects.
+     * Blocks are carved out of larger slabs and recycled through an intrusive free list,
+     * slabs themselves are only returned to the system when the pool is destroyed.
+     * Requests larger than the block size are forwarded to the global allocator.
+     * Every thread keeps a small cache of free blocks per pool, so map threads allocating and freeing their
+     * objects only take the pool lock once per batch of blocks.
+     */
+    class SlabPool
+    {
+        public:
+            SlabPool(char const* name, size_t blockSize, size_t blocksPerSlab = 256);
+            ~SlabPool();
+
+            SlabPool(SlabPool const&) = delete;
+            SlabPool& operator=(SlabPool const&) = delete;
+
+            void* Allocate(size_t size);
+            void Deallocate(void* block, size_t size);
+
+            size_t GetBlockSize() const { return m_blockSize; }
+            SlabPoolStats GetStats() const;
+
+            // all pools alive in the process, used for statistics output
+            static std::vector<SlabPoolStats> GetAllStats();
+
+        private:
+            struct FreeBlock
+            {
+                FreeBlock* next;
+            };
+
+            struct ThreadCache
+            {
+                ThreadCache() : head(nullptr), count(0) {}
+
+                FreeBlock* head;
+                size_t count;
+            };
+
+            struct ThreadCaches;
+
+            // nullptr once the caches of the thread are destroyed, during static destruction at exit
+            static ThreadCache* GetThreadCache(size_t poolId);
+
+            FreeBlock* AllocateLocked();
+            void Refill(ThreadCache& cache);
+            void Flush(ThreadCache& cache, size_t count);
+            void AllocateSlab();
+
+            std::string m_name;
+            size_t m_id;                                    // index into the thread caches, never reused
+            size_t m_blockSize;
+            size_t m_blocksPerSlab;
+            size_t m_cacheBatch;                            // blocks moved between a thread cache and the pool at once
+
+            mutable std::mutex m_mutex;
+            FreeBlock* m_freeList;
+            std::vector<char*> m_slabs;
+
+            std::atomic<size_t> m_blocksInUse;
+            std::atomic<size_t> m_peakBlocksInUse;
+            std::atomic<uint64> m_totalAllocations;
+            std::atomic<uint64> m_fallbackAllocations;
+    };
+}
+
+#endif
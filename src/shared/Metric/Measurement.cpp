@@ -16,58 +16,105 @@
 * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 
 #include "Measurement.h"
-#include "Errors.h"
 
-Measurement::Measurement(std::string measurement, std::map<std::string, std::string> tags, std::map<std::string, boost::any> fields,uint64 timestamp)
-    : _measurement(measurement), _tags(tags), _fields(fields)
+void Measurement::reset(char const* measurementName)
 {
-    if (!timestamp)
-    {
-        auto now = std::chrono::system_clock::now();
-        _timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-    }
-    else
-        _timestamp = timestamp;
+    name = measurementName;
+    tagCount = 0;
+    fieldCount = 0;
+    extraFields.clear();
+
+    auto now = std::chrono::system_clock::now();
+    timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
 }
 
-std::stringstream& operator<<(std::stringstream& out, const Measurement& measurement)
+void Measurement::add_tag(char const* key, metric::value const& val)
 {
-    out << measurement._measurement;
+    // extra tags would change the series identity silently, so keep the first ones only
+    if (tagCount < MAX_TAGS)
+        tags[tagCount++] = { key, val };
+}
 
-    for (const auto& tag : measurement._tags)
-        out << "," << tag.first << "=" << tag.second;
+void Measurement::add_field(char const* key, metric::value const& val)
+{
+    if (fieldCount < MAX_INLINE_FIELDS)
+        fields[fieldCount++] = { key, val };
+    else
+        extraFields.push_back({ key, val });
+}
 
-    out << " ";
+void Measurement::assign(Measurement const& other)
+{
+    name = other.name;
+    tagCount = other.tagCount;
+    fieldCount = other.fieldCount;
+    std::copy(other.tags, other.tags + other.tagCount, tags);
+    std::copy(other.fields, other.fields + other.fieldCount, fields);
+    extraFields.assign(other.extraFields.begin(), other.extraFields.end());
+    timestamp = other.timestamp;
+}
 
-    MANGOS_ASSERT(measurement._fields.size() > 0);
-    
-    const auto& last = measurement._fields.rbegin()->first;
-    for (const auto& field : measurement._fields)
+static void WriteValue(std::string& out, metric::value const& val, bool isField)
+{
+    char buffer[32];
+    switch (val.type())
     {
+        case metric::value::TYPE_INT:
+            // integer fields keep the "i" suffix they always had (e.g. duration, count), InfluxDB rejects points
+            // that change the type of an existing field
+            snprintf(buffer, sizeof(buffer), isField ? "%lldi" : "%lld", static_cast<long long>(val.as_int()));
+            out += buffer;
+            break;
+        case metric::value::TYPE_FLOAT:
+            snprintf(buffer, sizeof(buffer), "%g", val.as_float());
+            out += buffer;
+            break;
+        case metric::value::TYPE_BOOL:
+            out += val.as_bool() ? "t" : "f";
+            break;
+        case metric::value::TYPE_TEXT:
+            if (isField)
+                out += '"';
+            out += val.as_text() ? val.as_text() : "";
+            if (isField)
+                out += '"';
+            break;
+        default:
+            out += isField ? "0i" : "undefined";
+            break;
+    }
+}
 
-        out << field.first << "=";
-
-        if (field.second.type() == typeid(int32))
-            out << boost::any_cast<int32>(field.second) << "i";
-        else if (field.second.type() == typeid(int64))
-            out << boost::any_cast<int64>(field.second) << "i";
-        else if (field.second.type() == typeid(float))
-            out << boost::any_cast<float>(field.second);
-        else if (field.second.type() == typeid(bool))
-            out << boost::any_cast<bool>(field.second) ? "t" : "f";
-        else if (field.second.type() == typeid(std::string))
-            out << boost::any_cast<std::string>(field.second);
-        else
-            out << "undefined";
+void Measurement::write(std::string& out) const
+{
+    out += name;
 
-        if (measurement._fields.size() > 1 && field.first != last)
-            out << ",";
+    for (uint8 i = 0; i < tagCount; ++i)
+    {
+        out += ',';
+        out += tags[i].key;
+        out += '=';
+        WriteValue(out, tags[i].val, false);
     }
 
-    out << " " << measurement._timestamp;
+    out += ' ';
 
-    return out;
-}
\ No newline at end of file
+    for (size_t i = 0; i < field_count(); ++i)
+    {
+        metric::tag const& entry = field(i);
+        if (i)
+            out += ',';
+        out += entry.key;
+        out += '=';
+        WriteValue(out, entry.val, true);
+    }
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), " %llu", static_cast<unsigned long long>(timestamp));
+    out += buffer;
+}
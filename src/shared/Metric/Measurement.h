@@ -19,22 +19,94 @@
 #ifndef MANGOSSERVER_MEASUREMENT_H
 #define MANGOSSERVER_MEASUREMENT_H
 
-#include <boost/any.hpp>
-#include <iostream>
-#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "Common.h"
 
+namespace metric
+{
+    // Typed tag/field value. Text values must point to static storage (literals, opcode names...),
+    // they are only read back when the writer thread serializes the measurement.
+    class value
+    {
+        public:
+            enum value_type : uint8
+            {
+                TYPE_NONE,
+                TYPE_INT,
+                TYPE_FLOAT,
+                TYPE_BOOL,
+                TYPE_TEXT
+            };
+
+            value() : m_type(TYPE_NONE), m_int(0) {}
+            value(bool val) : m_type(TYPE_BOOL), m_bool(val) {}
+            value(char const* val) : m_type(TYPE_TEXT), m_text(val) {}
+
+            template <class T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+            value(T val) : m_type(TYPE_INT), m_int(static_cast<int64>(val)) {}
+
+            template <class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+            value(T val) : m_type(TYPE_FLOAT), m_float(static_cast<double>(val)) {}
+
+            value_type type() const { return m_type; }
+            int64 as_int() const { return m_int; }
+            double as_float() const { return m_float; }
+            bool as_bool() const { return m_bool; }
+            char const* as_text() const { return m_text; }
+
+        private:
+            value_type m_type;
+            union
+            {
+                int64 m_int;
+                double m_float;
+                bool m_bool;
+                char const* m_text;
+            };
+    };
+
+    // Tag and field keys are interned by address: they must be literals or otherwise live for the whole process
+    struct tag
+    {
+        char const* key;
+        value val;
+    };
+}
+
+/**
+ * Preallocated measurement record, as stored in the per thread metric buffers.
+ * Holds everything inline except fields above MAX_INLINE_FIELDS, which spill into a vector
+ * whose capacity is kept when the buffer slot is reused.
+ */
 struct Measurement
 {
-    Measurement(std::string measurement, std::map<std::string, std::string> tags, std::map<std::string, boost::any> fields, uint64 timestamp = 0);
+    static size_t const MAX_TAGS = 8;
+    static size_t const MAX_INLINE_FIELDS = 8;
+
+    Measurement() : name(nullptr), tagCount(0), fieldCount(0), timestamp(0) {}
+
+    void reset(char const* measurementName);
+    void add_tag(char const* key, metric::value const& val);
+    void add_field(char const* key, metric::value const& val);
+    size_t field_count() const { return fieldCount + extraFields.size(); }
+    metric::tag const& field(size_t index) const { return index < fieldCount ? fields[index] : extraFields[index - fieldCount]; }
+
+    // copy into an already used record without releasing its storage
+    void assign(Measurement const& other);
 
-    friend std::stringstream& operator<<(std::stringstream &out, const Measurement &measurement);
+    // append InfluxDB line protocol representation
+    void write(std::string& out) const;
 
-    std::string _measurement;
-    std::map<std::string, std::string> _tags; // tags are used for selecting queries
-    std::map<std::string, boost::any> _fields; // fields are used for displaying data
-    uint64 _timestamp;
+    char const* name;
+    uint8 tagCount;
+    uint8 fieldCount;
+    metric::tag tags[MAX_TAGS];                             // tags are used for selecting queries
+    metric::tag fields[MAX_INLINE_FIELDS];                  // fields are used for displaying data
+    std::vector<metric::tag> extraFields;
+    uint64 timestamp;
 };
 
-#endif // MANGOSSERVER_MEASUREMENT_H
\ No newline at end of file
+#endif // MANGOSSERVER_MEASUREMENT_H
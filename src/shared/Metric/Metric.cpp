@@ -17,64 +17,100 @@
  */
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
 #include <functional>
 
 #include "Config/Config.h"
 #include "Log.h"
 #include "Metric.h"
 
-metric::measurement::measurement(std::string name, std::function<bool()> condition)
-    : m_name(name), m_condition(std::move(condition))
+// Measurements are moved from the thread buffers into the payload this often
+static const uint32 METRIC_COLLECT_INTERVAL_MS = 100;
+// and the payload is posted to InfluxDB every this many collects
+static const uint32 METRIC_COLLECTS_PER_SEND = 10;
+
+metric::measurement::measurement(char const* name)
+    : m_active(metric::instance().is_enabled())
 {
+    if (m_active)
+        m_data.reset(name);
 }
 
-metric::measurement::measurement(std::string name, std::string key, boost::any value, std::function<bool()> condition)
-    : m_name(name), m_condition(std::move(condition))
+metric::measurement::measurement(char const* name, std::initializer_list<tag> tags)
+    : m_active(metric::instance().is_enabled())
 {
-    add_field(key, value);
+    if (!m_active)
+        return;
+
+    m_data.reset(name);
+    for (tag const& entry : tags)
+        m_data.add_tag(entry.key, entry.val);
 }
 
-metric::measurement::measurement(std::string name, std::string key, boost::any value, std::map<std::string, std::string> tags, std::function<bool()> condition)
-    : m_name(name), m_tags(tags), m_condition(std::move(condition))
+metric::measurement::measurement(char const* name, char const* key, value val, std::initializer_list<tag> tags)
+    : measurement(name, tags)
 {
-    add_field(key, value);
+    add_field(key, val);
 }
 
-metric::measurement::measurement(std::string name, std::map<std::string, std::string> tags, std::function<bool()> condition)
-    : m_name(name), m_tags(tags), m_condition(std::move(condition))
+metric::measurement::~measurement()
 {
+    if (m_active && m_data.field_count() > 0)
+        metric::instance().report(m_data);
 }
 
-metric::measurement::~measurement()
+void metric::measurement::add_tag(char const* key, value val)
 {
-    if(m_condition())
-        metric::instance().report(m_name, m_fields, m_tags);
+    if (m_active)
+        m_data.add_tag(key, val);
 }
 
-void metric::measurement::add_tag(std::string key, std::string value)
+void metric::measurement::add_field(char const* key, value val)
 {
-    m_tags.insert({key, value});
+    if (m_active)
+        m_data.add_field(key, val);
 }
 
-void metric::measurement::add_field(std::string key, boost::any value)
+metric::measurement_buffer::measurement_buffer(size_t capacity)
+    : abandoned(false), m_head(0), m_tail(0)
 {
-    m_fields.insert({key, value});
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    m_slots.resize(size);
+    m_mask = size - 1;
 }
 
-const boost::any metric::measurement::get_field(std::string key)
+bool metric::measurement_buffer::push(Measurement const& data)
 {
-    if (m_fields.find(key) != m_fields.end())
-        return m_fields[key];
+    size_t const head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= m_slots.size())
+        return false;
 
-    return boost::any();
+    m_slots[head & m_mask].assign(data);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
 }
 
-void metric::measurement::set_condition(std::function<bool()> condition)
+namespace
 {
-    m_condition = std::move(condition);
+    // flags the buffer for removal once its owning thread exits, remaining entries are still sent
+    struct thread_buffer_holder
+    {
+        std::shared_ptr<metric::measurement_buffer> buffer;
+
+        ~thread_buffer_holder()
+        {
+            if (buffer)
+                buffer->abandoned = true;
+        }
+    };
+
+    thread_local thread_buffer_holder t_threadBuffer;
 }
 
-metric::metric::metric()
+metric::metric::metric() : m_enabled(false), m_threadBufferSize(0), m_dropped(0), m_payloadCount(0), m_collectCount(0)
 {
     initialize();
 }
@@ -85,13 +121,11 @@ metric::metric::~metric()
         return;
 
     m_writeService.post([&] {
-        m_sendTimer->cancel();
+        m_collectTimer->cancel();
     });
 
-    m_queueServiceWork.reset();
     m_writeServiceWork.reset();
 
-    m_queueServiceThread.join();
     m_writeServiceThread.join();
 }
 
@@ -108,15 +142,12 @@ void metric::metric::initialize()
         sConfig.GetStringDefault("Metric.Password", "")
     };
 
-    m_sendTimer.reset(new boost::asio::deadline_timer(m_writeService));
-    m_queueServiceWork.reset(new boost::asio::io_service::work(m_queueService));
-    m_writeServiceWork.reset(new boost::asio::io_service::work(m_writeService));
+    m_threadBufferSize = std::max(sConfig.GetIntDefault("Metric.ThreadBufferSize", 8192), 64);
 
-    // Start up service thread that will process all queued tasks
-    m_queueServiceThread = std::thread([&] {
-        m_queueService.run();
-    });
+    m_collectTimer.reset(new boost::asio::deadline_timer(m_writeService));
+    m_writeServiceWork.reset(new boost::asio::io_service::work(m_writeService));
 
+    // Start up service thread that will collect and send all reported measurements
     m_writeServiceThread = std::thread([&] {
         m_writeService.run();
     });
@@ -130,59 +161,126 @@ metric::metric& metric::metric::instance()
     return instance;
 }
 
-void metric::metric::report(std::string measurement, std::string key, boost::any value, std::map<std::string, std::string> tags)
+metric::measurement_buffer* metric::metric::get_thread_buffer()
 {
-    report(measurement, { { key, value } }, tags);
+    if (!t_threadBuffer.buffer)
+    {
+        t_threadBuffer.buffer = std::make_shared<measurement_buffer>(m_threadBufferSize);
+
+        std::lock_guard<std::mutex> guard(m_buffersLock);
+        m_buffers.push_back(t_threadBuffer.buffer);
+    }
+
+    return t_threadBuffer.buffer.get();
 }
 
-void metric::metric::report(std::string measurement, std::map<std::string, boost::any> fields, std::map<std::string, std::string> tags)
+void metric::metric::report(Measurement const& data)
 {
     if (!m_enabled)
         return;
 
-    m_queueService.post([&, measurement, fields, tags]
-    {
-        std::lock_guard<std::mutex> guard(m_queueWriteLock);
-        m_measurementQueue.push_back(std::unique_ptr<Measurement>(new Measurement(measurement, tags, fields)));
-    });
+    // never wait for the writer, a full buffer means it can not keep up
+    if (!get_thread_buffer()->push(data))
+        ++m_dropped;
+}
+
+void metric::metric::report(char const* measurement, char const* key, value val, std::initializer_list<tag> tags)
+{
+    if (!m_enabled)
+        return;
+
+    Measurement data;
+    data.reset(measurement);
+    for (tag const& entry : tags)
+        data.add_tag(entry.key, entry.val);
+    data.add_field(key, val);
+
+    report(data);
 }
 
 void metric::metric::schedule_timer()
 {
     using namespace std::placeholders;
 
-    if (!m_sendTimer)
+    if (!m_collectTimer)
         return;
 
-    m_sendTimer->expires_from_now(boost::posix_time::seconds(1));
-    m_sendTimer->async_wait(std::bind(&metric::metric::prepare_send, this, _1));
+    m_collectTimer->expires_from_now(boost::posix_time::milliseconds(METRIC_COLLECT_INTERVAL_MS));
+    m_collectTimer->async_wait(std::bind(&metric::metric::on_collect, this, _1));
 }
 
-void metric::metric::prepare_send(const boost::system::error_code& ec)
+void metric::metric::on_collect(const boost::system::error_code& ec)
 {
     if (ec)
     {
         if (ec != boost::asio::error::operation_aborted)
-            sLog.outError("metric::metric::handle_timeout aborted, %s", ec.message().c_str());
+            sLog.outError("metric::metric::on_collect aborted, %s", ec.message().c_str());
 
         return;
     }
 
-    send();
+    collect();
+
+    if (++m_collectCount >= METRIC_COLLECTS_PER_SEND)
+    {
+        m_collectCount = 0;
+        send();
+    }
+
     schedule_timer();
 }
 
-void metric::metric::send()
+void metric::metric::collect()
 {
-    std::vector<std::unique_ptr<Measurement>> measurements;
+    std::vector<std::shared_ptr<measurement_buffer>> buffers;
+    {
+        std::lock_guard<std::mutex> guard(m_buffersLock);
+        buffers = m_buffers;
+    }
+
+    for (auto const& buffer : buffers)
+    {
+        buffer->drain([&](Measurement const& data)
+        {
+            if (m_payloadCount)
+                m_payload += '\n';
+
+            data.write(m_payload);
+            ++m_payloadCount;
+        });
+    }
 
-    // Scope swapping
+    // forget buffers of exited threads once everything they reported is collected
+    std::lock_guard<std::mutex> guard(m_buffersLock);
+    m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [](std::shared_ptr<measurement_buffer> const& buffer)
     {
-        std::lock_guard<std::mutex> guard(m_queueWriteLock);
-        std::swap(measurements, m_measurementQueue);
+        return buffer->abandoned && buffer->empty();
+    }), m_buffers.end());
+}
+
+void metric::metric::send()
+{
+    if (uint64 dropped = m_dropped.exchange(0))
+    {
+        Measurement data;
+        data.reset("metric.dropped");
+        data.add_field("count", dropped);
+
+        if (m_payloadCount)
+            m_payload += '\n';
+        data.write(m_payload);
+        ++m_payloadCount;
     }
 
-    sLog.outDetail("Sending %zu measurements!", measurements.size());
+    if (!m_payloadCount)
+        return;
+
+    std::string payload;
+    std::swap(payload, m_payload);
+    m_payload.reserve(payload.capacity());
+
+    sLog.outDetail("Sending %u measurements!", m_payloadCount);
+    m_payloadCount = 0;
 
     using boost::asio::ip::tcp;
 
@@ -216,24 +314,15 @@ void metric::metric::send()
         return;
     }
 
-    std::stringstream payload;
-    for (auto const& measurement : measurements)
-    {
-        if (&measurement != &measurements.front())
-            payload << "\n";
-
-        payload << *measurement;
-    }
-
     boost::asio::streambuf request;
     std::ostream request_stream(&request);
 
     // Write request
     request_stream << "POST " << "/write?db=" << m_connectionInfo.database << "&u=" << m_connectionInfo.username << "&p=" << m_connectionInfo.password << " HTTP/1.1\r\n";
     request_stream << "Host: " << m_connectionInfo.hostname << "\r\n";
-    request_stream << "Content-Length:" << std::to_string(payload.tellp()) << "\r\n";
+    request_stream << "Content-Length:" << std::to_string(payload.size()) << "\r\n";
     request_stream << "Connection: close\r\n\r\n";
-    request_stream << payload.rdbuf();
+    request_stream << payload;
 
     // Send the request.
     boost::asio::write(socket, request, error);
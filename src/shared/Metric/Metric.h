@@ -19,11 +19,12 @@
 #ifndef MANGOSSERVER_METRIC_H
 #define MANGOSSERVER_METRIC_H
 
-#include <boost/any.hpp>
 #include <boost/asio.hpp>
+#include <atomic>
 #include <chrono>
-#include <iostream>
-#include <map>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -41,69 +42,93 @@ struct MetricConnectionInfo
 
 namespace metric
 {
+    class metric;
+
+    // Builds a measurement on the stack and hands it to the calling thread's buffer when destroyed.
+    // Nothing is recorded and no work beyond the constructor call is done while metrics are disabled.
     class measurement
     {
         public:
-            measurement(std::string name, std::function<bool()> condition = [] { return true; });
-            measurement(std::string name, std::string key, boost::any value, std::function<bool()> condition = [] { return true; });
-            measurement(std::string name, std::string key, boost::any value, std::map<std::string, std::string> tags, std::function<bool()> condition = [] { return true; });
-            measurement(std::string name, std::map<std::string, std::string> tags, std::function<bool()> condition = [] { return true; });
+            explicit measurement(char const* name);
+            measurement(char const* name, std::initializer_list<tag> tags);
+            measurement(char const* name, char const* key, value val, std::initializer_list<tag> tags = {});
             virtual ~measurement();
 
-            void add_tag(std::string key, std::string value);
-            void add_field(std::string key, boost::any value);
-            const boost::any get_field(std::string key);
+            void add_tag(char const* key, value val);
+            void add_field(char const* key, value val);
 
         protected:
-            void set_condition(std::function<bool()> condition);
+            bool is_active() const { return m_active; }
+            void discard() { m_active = false; }
 
         private:
-            std::string m_name;
-            std::map<std::string, std::string> m_tags;
-            std::map<std::string, boost::any> m_fields;
-            std::chrono::system_clock::time_point m_timestamp;
-            std::function<bool()> m_condition;
+            bool m_active;
+            Measurement m_data;
     };
 
     template <class precision>
     class duration : public measurement
     {
         public:
-            duration(std::string name)
-                : measurement(name), m_startTime(std::chrono::high_resolution_clock::now())
+            explicit duration(char const* name)
+                : measurement(name), m_threshold(0), m_startTime(std::chrono::high_resolution_clock::now())
             {}
 
-            duration(std::string name, std::map<std::string, std::string> tags)
-                : measurement(name, tags), m_startTime(std::chrono::high_resolution_clock::now())
+            duration(char const* name, std::initializer_list<tag> tags)
+                : measurement(name, tags), m_threshold(0), m_startTime(std::chrono::high_resolution_clock::now())
             {}
 
-            duration(std::string name, std::map<std::string, std::string> tags, int64 threshold)
-                : measurement(name, tags), m_startTime(std::chrono::high_resolution_clock::now())
-            {
-                auto condition = [&, threshold] {
-                    auto value = get_field("duration");
-                    if (value.empty())
-                        return false;
-
-                    auto duration = boost::any_cast<int64>(value);
-                    return duration >= threshold;
-                };
-
-                set_condition(std::move(condition));
-            }
+            // only report runs lasting at least threshold (in precision units)
+            duration(char const* name, std::initializer_list<tag> tags, int64 threshold)
+                : measurement(name, tags), m_threshold(threshold), m_startTime(std::chrono::high_resolution_clock::now())
+            {}
 
             ~duration()
             {
+                if (!is_active())
+                    return;
+
                 auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<precision>(endTime - m_startTime).count();
+                int64 duration = std::chrono::duration_cast<precision>(endTime - m_startTime).count();
 
-                add_field("duration", static_cast<int64>(duration));
+                if (duration < m_threshold)
+                    discard();
+                else
+                    add_field("duration", duration);
             }
 
         private:
+            int64 m_threshold;
             std::chrono::high_resolution_clock::time_point m_startTime;
     };
 
+    // Single producer/single consumer ring of preallocated measurements, one per reporting thread
+    class measurement_buffer
+    {
+        public:
+            explicit measurement_buffer(size_t capacity);
+
+            bool push(Measurement const& data);             // producer thread only
+            template <class F> void drain(F&& consumer)     // writer thread only
+            {
+                size_t tail = m_tail.load(std::memory_order_relaxed);
+                size_t const head = m_head.load(std::memory_order_acquire);
+                for (; tail != head; ++tail)
+                    consumer(m_slots[tail & m_mask]);
+                m_tail.store(tail, std::memory_order_release);
+            }
+
+            bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+            std::atomic<bool> abandoned;                    // owning thread exited
+
+        private:
+            std::vector<Measurement> m_slots;
+            size_t m_mask;
+            std::atomic<size_t> m_head;
+            std::atomic<size_t> m_tail;
+    };
+
     class metric
     {
         public:
@@ -113,29 +138,38 @@ namespace metric
             void initialize();
             static metric& instance();
 
-            void report(std::string measurement, std::string key, boost::any value, std::map<std::string, std::string> tags = {});
-            void report(std::string measurement, std::map<std::string, boost::any> fields, std::map<std::string, std::string> tags = {});
+            bool is_enabled() const { return m_enabled; }
+
+            void report(Measurement const& data);
+            void report(char const* measurement, char const* key, value val, std::initializer_list<tag> tags = {});
 
         private:
-            boost::asio::io_service m_queueService;
             boost::asio::io_service m_writeService;
 
-            std::unique_ptr<boost::asio::deadline_timer> m_sendTimer;
-            std::unique_ptr<boost::asio::io_service::work> m_queueServiceWork;
+            std::unique_ptr<boost::asio::deadline_timer> m_collectTimer;
             std::unique_ptr<boost::asio::io_service::work> m_writeServiceWork;
-            std::thread m_queueServiceThread;
             std::thread m_writeServiceThread;
 
             bool m_enabled;
             MetricConnectionInfo m_connectionInfo;
+            size_t m_threadBufferSize;
+
+            std::mutex m_buffersLock;                       // only taken when a thread reports for the first time and by the writer
+            std::vector<std::shared_ptr<measurement_buffer>> m_buffers;
+            std::atomic<uint64> m_dropped;
+
+            // writer thread only
+            std::string m_payload;
+            uint32 m_payloadCount;
+            uint32 m_collectCount;
 
-            std::mutex m_queueWriteLock;
-            std::vector<std::unique_ptr<Measurement>> m_measurementQueue;
+            measurement_buffer* get_thread_buffer();
 
             void schedule_timer();
-            void prepare_send(const boost::system::error_code& ec);
+            void on_collect(const boost::system::error_code& ec);
+            void collect();
             void send();
     };
 }
 
-#endif // MANGOSSERVER_METRIC_H
\ No newline at end of file
+#endif // MANGOSSERVER_METRIC_H
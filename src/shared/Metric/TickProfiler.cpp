@@ -0,0 +1,342 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Metric/TickProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    typedef std::chrono::steady_clock ProfileClock;
+
+    uint32 const NO_PARENT = uint32(-1);
+
+    struct ProfileNode
+    {
+        uint32 frameId;
+        uint32 parent;
+        uint64 selfTime;                                    // nanoseconds
+    };
+
+    struct OpenScope
+    {
+        uint32 node;
+        ProfileClock::time_point start;
+        uint64 childTime;                                   // nanoseconds
+    };
+
+    struct CategoryKey
+    {
+        char const* category;
+        uint32 id;
+
+        bool operator==(CategoryKey const& other) const { return category == other.category && id == other.id; }
+    };
+
+    struct CategoryKeyHash
+    {
+        size_t operator()(CategoryKey const& key) const { return std::hash<char const*>()(key.category) ^ (size_t(key.id) * 0x9E3779B1u); }
+    };
+
+    /// Call tree of the running outermost scope of a thread, plus frame id lookups without the global lock
+    struct ThreadProfile
+    {
+        std::vector<ProfileNode> nodes;
+        std::unordered_map<uint64, uint32> children;        // parent node << 32 | frame id -> node
+        std::vector<OpenScope> stack;
+
+        std::unordered_map<char const*, uint32> nameIds;
+        std::unordered_map<CategoryKey, uint32, CategoryKeyHash> categoryIds;
+    };
+
+    thread_local ThreadProfile t_profile;
+}
+
+namespace MaNGOS
+{
+    std::atomic<bool> TickProfiler::s_enabled(false);
+
+    TickProfiler::TickProfiler() : m_running(false), m_requestedRingTicks(0), m_tick(0)
+    {
+    }
+
+    TickProfiler& TickProfiler::Instance()
+    {
+        static TickProfiler instance;
+        return instance;
+    }
+
+    void TickProfiler::Start(uint32 ringTicks)
+    {
+        std::lock_guard<std::mutex> lock(m_ringLock);
+        m_requestedRingTicks = std::max(1u, ringTicks);
+        m_running = true;
+    }
+
+    void TickProfiler::Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_ringLock);
+        m_running = false;
+    }
+
+    void TickProfiler::BeginTick()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_ringLock);
+            if (m_running && m_requestedRingTicks)
+            {
+                m_ring.assign(m_requestedRingTicks, TickRecord());
+                m_requestedRingTicks = 0;
+            }
+
+            s_enabled.store(m_running, std::memory_order_relaxed);
+        }
+
+        ++m_tick;
+    }
+
+    uint32 TickProfiler::GetFrameId(char const* name)
+    {
+        ThreadProfile& profile = t_profile;
+        auto itr = profile.nameIds.find(name);
+        if (itr != profile.nameIds.end())
+            return itr->second;
+
+        uint32 frameId = InternFrame(name);
+        profile.nameIds.emplace(name, frameId);
+        return frameId;
+    }
+
+    uint32 TickProfiler::GetFrameId(char const* category, uint32 id, char const* detail)
+    {
+        ThreadProfile& profile = t_profile;
+        CategoryKey key = { category, id };
+        auto itr = profile.categoryIds.find(key);
+        if (itr != profile.categoryIds.end())
+            return itr->second;
+
+        std::string name = std::string(category) + " " + std::to_string(id);
+        if (detail && *detail)
+            name.append(" ").append(detail);
+
+        uint32 frameId = InternFrame(name);
+        profile.categoryIds.emplace(key, frameId);
+        return frameId;
+    }
+
+    uint32 TickProfiler::InternFrame(std::string const& name)
+    {
+        // ';' separates the frames of a folded stack
+        std::string frameName = name;
+        std::replace(frameName.begin(), frameName.end(), ';', ':');
+
+        std::lock_guard<std::mutex> lock(m_framesLock);
+        auto itr = m_frameIds.find(frameName);
+        if (itr != m_frameIds.end())
+            return itr->second;
+
+        uint32 frameId = uint32(m_frameNames.size());
+        m_frameNames.push_back(frameName);
+        m_frameIds.emplace(frameName, frameId);
+        return frameId;
+    }
+
+    void TickProfiler::Enter(uint32 frameId)
+    {
+        ThreadProfile& profile = t_profile;
+
+        uint32 node;
+        if (profile.stack.empty())
+        {
+            profile.nodes.clear();
+            profile.children.clear();
+            profile.nodes.push_back({ frameId, NO_PARENT, 0 });
+            node = 0;
+        }
+        else
+        {
+            uint32 parent = profile.stack.back().node;
+            uint64 key = (uint64(parent) << 32) | frameId;
+            auto itr = profile.children.find(key);
+            if (itr != profile.children.end())
+                node = itr->second;
+            else
+            {
+                node = uint32(profile.nodes.size());
+                profile.nodes.push_back({ frameId, parent, 0 });
+                profile.children.emplace(key, node);
+            }
+        }
+
+        profile.stack.push_back({ node, ProfileClock::now(), 0 });
+    }
+
+    void TickProfiler::Leave()
+    {
+        ThreadProfile& profile = t_profile;
+        if (profile.stack.empty())
+            return;
+
+        OpenScope scope = profile.stack.back();
+        profile.stack.pop_back();
+
+        uint64 elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(ProfileClock::now() - scope.start).count();
+        profile.nodes[scope.node].selfTime += elapsed > scope.childTime ? elapsed - scope.childTime : 0;
+
+        if (!profile.stack.empty())
+        {
+            profile.stack.back().childTime += elapsed;
+            return;
+        }
+
+        // outermost scope closed: fold the tree into stacks and hand them to the ring
+        FoldedStacks stacks;
+        FramePath path;
+        for (ProfileNode const& treeNode : profile.nodes)
+        {
+            if (!treeNode.selfTime)
+                continue;
+
+            path.clear();
+            for (ProfileNode const* itr = &treeNode; ; itr = &profile.nodes[itr->parent])
+            {
+                path.push_back(itr->frameId);
+                if (itr->parent == NO_PARENT)
+                    break;
+            }
+            std::reverse(path.begin(), path.end());
+            stacks[path] += treeNode.selfTime;
+        }
+
+        Submit(stacks);
+    }
+
+    void TickProfiler::Submit(FoldedStacks& stacks)
+    {
+        uint32 tick = m_tick;
+
+        std::lock_guard<std::mutex> lock(m_ringLock);
+        if (m_ring.empty())
+            return;
+
+        TickRecord& record = m_ring[tick % m_ring.size()];
+        if (record.tick != tick)
+        {
+            record.tick = tick;
+            record.stacks.swap(stacks);
+            return;
+        }
+
+        for (auto const& stack : stacks)
+            record.stacks[stack.first] += stack.second;
+    }
+
+    TickProfiler::FoldedStacks TickProfiler::MergeRing() const
+    {
+        FoldedStacks merged;
+
+        std::lock_guard<std::mutex> lock(m_ringLock);
+        for (TickRecord const& record : m_ring)
+            for (auto const& stack : record.stacks)
+                merged[stack.first] += stack.second;
+
+        return merged;
+    }
+
+    uint32 TickProfiler::GetRecordedTicks() const
+    {
+        std::lock_guard<std::mutex> lock(m_ringLock);
+        return uint32(std::count_if(m_ring.begin(), m_ring.end(), [](TickRecord const& record) { return !record.stacks.empty(); }));
+    }
+
+    int32 TickProfiler::WriteFoldedStacks(std::string const& fileName) const
+    {
+        FoldedStacks merged = MergeRing();
+
+        std::vector<std::string> names;
+        {
+            std::lock_guard<std::mutex> lock(m_framesLock);
+            names = m_frameNames;
+        }
+
+        FILE* file = fopen(fileName.c_str(), "w");
+        if (!file)
+            return -1;
+
+        int32 written = 0;
+        std::string line;
+        for (auto const& stack : merged)
+        {
+            uint64 micros = stack.second / 1000;
+            if (!micros)
+                continue;
+
+            line.clear();
+            for (uint32 frameId : stack.first)
+            {
+                if (!line.empty())
+                    line += ';';
+                line += names[frameId];
+            }
+
+            fprintf(file, "%s " UI64FMTD "\n", line.c_str(), micros);
+            ++written;
+        }
+
+        fclose(file);
+        return written;
+    }
+
+    std::vector<ProfileFrameStats> TickProfiler::GetTopFrames(uint32 limit) const
+    {
+        FoldedStacks merged = MergeRing();
+
+        std::map<uint32, std::pair<uint64, uint64>> frames;     // frame id -> self, total
+        std::vector<uint32> seen;
+        for (auto const& stack : merged)
+        {
+            frames[stack.first.back()].first += stack.second;
+
+            seen.clear();
+            for (uint32 frameId : stack.first)
+            {
+                if (std::find(seen.begin(), seen.end(), frameId) != seen.end())
+                    continue;
+
+                seen.push_back(frameId);
+                frames[frameId].second += stack.second;
+            }
+        }
+
+        std::vector<ProfileFrameStats> result;
+        {
+            std::lock_guard<std::mutex> lock(m_framesLock);
+            result.reserve(frames.size());
+            for (auto const& frame : frames)
+                result.push_back({ m_frameNames[frame.first], frame.second.first / 1000, frame.second.second / 1000 });
+        }
+
+        std::sort(result.begin(), result.end(), [](ProfileFrameStats const& a, ProfileFrameStats const& b) { return a.selfTime > b.selfTime; });
+        if (result.size() > limit)
+            result.resize(limit);
+
+        return result;
+    }
+}
@@ -0,0 +1,145 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TICKPROFILER_H
+#define MANGOS_TICKPROFILER_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MaNGOS
+{
+    struct ProfileFrameStats
+    {
+        std::string name;
+        uint64 selfTime;                                    // microseconds
+        uint64 totalTime;                                   // microseconds, nested calls of the same frame counted once
+    };
+
+    /**
+     * Instrumenting profiler of the world tick.
+     * Code is annotated with PROFILE_SCOPE, each thread builds a call tree of the scopes it runs through and
+     * hands it over when its outermost scope closes (World::Update, Map::Update of a map worker).
+     * The trees are merged per world tick into a ring buffer of the last ticks, which can be written
+     * as folded stacks ("frame;frame;frame microseconds") for flamegraph.pl, speedscope and similar tools.
+     * While stopped a scope costs one relaxed atomic load.
+     */
+    class TickProfiler
+    {
+        public:
+            TickProfiler();
+
+            static TickProfiler& Instance();
+
+            static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+            // start and stop requests are applied at the next tick boundary, so trees never span a state change
+            void Start(uint32 ringTicks);
+            void Stop();
+            bool IsRunning() const { return m_running; }
+
+            // world thread, before the world update, when no map is updated
+            void BeginTick();
+
+            // frame ids are process wide and never released; name must outlive the process (string literal)
+            uint32 GetFrameId(char const* name);
+            // frame "<category> <id> [detail]", e.g. creature entry or script id; detail is only read the first time
+            uint32 GetFrameId(char const* category, uint32 id, char const* detail = nullptr);
+
+            // merge of all ticks in the ring: folded stacks to file, returns written stacks or -1 if the file can't be opened
+            int32 WriteFoldedStacks(std::string const& fileName) const;
+            // frames ordered by self time, at most limit
+            std::vector<ProfileFrameStats> GetTopFrames(uint32 limit) const;
+            uint32 GetRecordedTicks() const;
+
+            // thread side, used by ProfileScope
+            void Enter(uint32 frameId);
+            void Leave();
+
+        private:
+            typedef std::vector<uint32> FramePath;
+            typedef std::map<FramePath, uint64> FoldedStacks;
+
+            struct TickRecord
+            {
+                TickRecord() : tick(0) {}
+
+                uint32 tick;
+                FoldedStacks stacks;
+            };
+
+            void Submit(FoldedStacks& stacks);
+            uint32 InternFrame(std::string const& name);
+            FoldedStacks MergeRing() const;
+
+            static std::atomic<bool> s_enabled;
+            bool m_running;                                 // requested state, applied by BeginTick
+            uint32 m_requestedRingTicks;
+            std::atomic<uint32> m_tick;
+
+            mutable std::mutex m_framesLock;
+            std::vector<std::string> m_frameNames;
+            std::unordered_map<std::string, uint32> m_frameIds;
+
+            mutable std::mutex m_ringLock;
+            std::vector<TickRecord> m_ring;
+    };
+
+    /// Times the enclosing scope for the tick profiler when it is running
+    class ProfileScope
+    {
+        public:
+            explicit ProfileScope(char const* name) : m_entered(TickProfiler::IsEnabled())
+            {
+                if (m_entered)
+                    TickProfiler::Instance().Enter(TickProfiler::Instance().GetFrameId(name));
+            }
+
+            ProfileScope(char const* category, uint32 id, char const* detail = nullptr) : m_entered(TickProfiler::IsEnabled())
+            {
+                if (m_entered)
+                    TickProfiler::Instance().Enter(TickProfiler::Instance().GetFrameId(category, id, detail));
+            }
+
+            ~ProfileScope()
+            {
+                if (m_entered)
+                    TickProfiler::Instance().Leave();
+            }
+
+            ProfileScope(ProfileScope const&) = delete;
+            ProfileScope& operator=(ProfileScope const&) = delete;
+
+        private:
+            bool m_entered;
+    };
+}
+
+#define sTickProfiler MaNGOS::TickProfiler::Instance()
+
+#define PROFILE_SCOPE_CONCAT_(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_(a, b)
+#define PROFILE_SCOPE(...) MaNGOS::ProfileScope PROFILE_SCOPE_CONCAT(profileScope, __LINE__)(__VA_ARGS__)
+
+#endif
@@ -1 +1,41 @@
-#include "Messager.h"
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+#include "Multithreading/Messager.h"
+#include "Memory/SlabPool.h"
+
+namespace
+{
+    // never destroyed, messagers of singletons still free their nodes at process exit
+    MaNGOS::SlabPool& GetMessagePool()
+    {
+        static MaNGOS::SlabPool* pool = new MaNGOS::SlabPool("Message", sizeof(MessageNode), 512);
+        return *pool;
+    }
+}
+
+MessageNode* MessageNode::Allocate()
+{
+    return static_cast<MessageNode*>(GetMessagePool().Allocate(sizeof(MessageNode)));
+}
+
+void MessageNode::Free(MessageNode* node)
+{
+    GetMessagePool().Deallocate(node, sizeof(MessageNode));
+}
@@ -16,33 +16,126 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+
 #ifndef MANGOS_MESSAGER_H
 #define MANGOS_MESSAGER_H
 
-#include <vector>
-#include <mutex>
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// Queued message of a Messager, the callable is kept in place when it fits the inline storage
+struct MessageNode
+{
+    static size_t const INLINE_SIZE = 48;
+
+    MessageNode* next;
+    void (*invoke)(MessageNode* node, void* object);
+    void (*destroy)(MessageNode* node);
+    typename std::aligned_storage<INLINE_SIZE, alignof(std::max_align_t)>::type storage;
 
+    // nodes come from a pool shared by all messagers
+    static MessageNode* Allocate();
+    static void Free(MessageNode* node);
+};
+
+/**
+ * Commands posted from any thread to be run by the owner of T in its next update.
+ * Posting pushes a node onto a lock free list, Execute takes the whole list with one exchange and runs it
+ * outside of any lock, so producers never wait for the owner. Messages run in the order they were posted,
+ * messages posted while executing wait for the next call.
+ */
 template <class T>
 class Messager
 {
     public:
-        void AddMessage(const std::function<void(T*)>& message)
+        Messager() : m_head(nullptr), m_queued(0) {}
+        Messager(Messager const&) = delete;
+        Messager& operator=(Messager const&) = delete;
+
+        ~Messager()
+        {
+            for (MessageNode* node = m_head.exchange(nullptr, std::memory_order_acquire); node;)
+            {
+                MessageNode* next = node->next;
+                node->destroy(node);
+                MessageNode::Free(node);
+                node = next;
+            }
+        }
+
+        template <typename F>
+        void AddMessage(F&& message)
         {
-            std::lock_guard<std::mutex> guard(m_messageMutex);
-            m_messageVector.push_back(message);
+            typedef typename std::decay<F>::type Callable;
+
+            MessageNode* node = MessageNode::Allocate();
+            Store<Callable>(node, std::forward<F>(message), std::integral_constant<bool,
+                sizeof(Callable) <= MessageNode::INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t)>());
+
+            m_queued.fetch_add(1, std::memory_order_relaxed);
+            node->next = m_head.load(std::memory_order_relaxed);
+            while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+                ;
         }
-        void Execute(T* object)
+
+        // returns the number of messages executed
+        size_t Execute(T* object)
         {
-            std::lock_guard<std::mutex> guard(m_messageMutex);
-            for (auto& message : m_messageVector)
-                message(object);
+            // the list is newest first
+            MessageNode* batch = nullptr;
+            size_t count = 0;
+            for (MessageNode* node = m_head.exchange(nullptr, std::memory_order_acquire); node; ++count)
+            {
+                MessageNode* next = node->next;
+                node->next = batch;
+                batch = node;
+                node = next;
+            }
+
+            if (!count)
+                return 0;
+
+            m_queued.fetch_sub(count, std::memory_order_relaxed);
+
+            while (batch)
+            {
+                MessageNode* next = batch->next;
+                batch->invoke(batch, object);
+                batch->destroy(batch);
+                MessageNode::Free(batch);
+                batch = next;
+            }
 
-            m_messageVector.clear();
+            return count;
         }
+
+        bool HasMessages() const { return m_head.load(std::memory_order_relaxed) != nullptr; }
+
+        // messages posted and not taken by Execute yet
+        size_t GetQueueDepth() const { return m_queued.load(std::memory_order_relaxed); }
+
     private:
-        std::vector<std::function<void(T*)>> m_messageVector;
-        std::mutex m_messageMutex;  
+        template <typename Callable, typename F>
+        static void Store(MessageNode* node, F&& message, std::true_type /*inline*/)
+        {
+            new (&node->storage) Callable(std::forward<F>(message));
+            node->invoke = [](MessageNode* n, void* object) { (*reinterpret_cast<Callable*>(&n->storage))(static_cast<T*>(object)); };
+            node->destroy = [](MessageNode* n) { reinterpret_cast<Callable*>(&n->storage)->~Callable(); };
+        }
+
+        template <typename Callable, typename F>
+        static void Store(MessageNode* node, F&& message, std::false_type /*inline*/)
+        {
+            new (&node->storage) Callable*(new Callable(std::forward<F>(message)));
+            node->invoke = [](MessageNode* n, void* object) { (**reinterpret_cast<Callable**>(&n->storage))(static_cast<T*>(object)); };
+            node->destroy = [](MessageNode* n) { delete *reinterpret_cast<Callable**>(&n->storage); };
+        }
+
+        std::atomic<MessageNode*> m_head;
+        std::atomic<size_t> m_queued;
 };
 
-#endif
\ No newline at end of file
+#endif
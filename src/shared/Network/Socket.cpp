@@ -18,6 +18,7 @@
 
 #include "Socket.hpp"
 #include "Log.h"
+#include "ByteBuffer.h"
 
 #include <boost/asio.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
@@ -32,6 +33,9 @@
 
 namespace MaNGOS
 {
+    std::atomic<uint64> Socket::s_bytesCopied(0);
+    std::atomic<uint64> Socket::s_bytesShared(0);
+
     Socket::Socket(boost::asio::io_service& service, std::function<void (Socket*)> closeHandler)
         : m_writeState(WriteState::Idle), m_readState(ReadState::Idle), m_socket(service),
           m_closeHandler(std::move(closeHandler)), m_outBufferFlushTimer(service), m_address("0.0.0.0") {}
@@ -145,6 +149,25 @@ namespace MaNGOS
         StartAsyncRead();
     }
 
+    void Socket::ProcessBufferedData()
+    {
+        if (IsClosed())
+            return;
+
+        // a read is still pending at the current write position, so only the read position may move here
+        while (m_inBuffer->m_readPosition < m_inBuffer->m_writePosition)
+        {
+            if (!ProcessIncomingData())
+            {
+                // incomplete data stays buffered until the pending read completes
+                if (errno != EBADMSG && !IsClosed())
+                    Close();
+
+                return;
+            }
+        }
+    }
+
     void Socket::OnError(const boost::system::error_code& error)
     {
         // skip logging this code because it happens whenever anyone disconnects.  reduces spam.
@@ -169,35 +192,128 @@ namespace MaNGOS
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
-
         // write the header
-        outBuffer->Write(header, headerSize);
+        AppendOut(header, headerSize);
 
         // write the content
-        outBuffer->Write(content, contentSize);
+        AppendOut(content, contentSize);
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
             StartWriteFlushTimer();
     }
 
-    void Socket::Write(const char* buffer, int length)
+    void Socket::Write(const char* header, int headerSize, std::shared_ptr<ByteBuffer const> const& content)
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        // write the header
+        AppendOut(header, headerSize);
+
+        // reference the content
+        if (!content->empty())
+        {
+            std::vector<OutSegment>& segments = m_writeState == WriteState::Sending ? m_secondaryOutSegments : m_outSegments;
+            segments.push_back({ content, 0, content->size() });
+            s_bytesShared.fetch_add(content->size(), std::memory_order_relaxed);
+        }
+
+        // flush data if need
+        if (m_writeState == WriteState::Idle)
+            StartWriteFlushTimer();
+    }
+
+    void Socket::Write(const char* buffer, int length)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
 
         // write the header
-        outBuffer->Write(buffer, length);
+        AppendOut(buffer, length);
 
         // flush data if need
         if (m_writeState == WriteState::Idle)
             StartWriteFlushTimer();
     }
 
+    void Socket::AppendOut(const char* buffer, int length)
+    {
+        // get the correct buffer depending on the current writing state
+        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        std::vector<OutSegment>& segments = m_writeState == WriteState::Sending ? m_secondaryOutSegments : m_outSegments;
+
+        // bytes following other out buffer bytes extend their segment
+        size_t begin = outBuffer->m_writePosition;
+        outBuffer->Write(buffer, length);
+
+        if (!segments.empty() && !segments.back().payload && segments.back().end == begin)
+            segments.back().end = outBuffer->m_writePosition;
+        else
+            segments.push_back({ nullptr, begin, outBuffer->m_writePosition });
+
+        s_bytesCopied.fetch_add(length, std::memory_order_relaxed);
+    }
+
+    void Socket::ConsumeOut(size_t length)
+    {
+        // drop the sent bytes and move the out buffer bytes left to the start of the buffer
+        std::vector<OutSegment> remaining;
+        remaining.reserve(m_outSegments.size() + m_secondaryOutSegments.size());
+
+        size_t writePosition = 0;
+        for (OutSegment& segment : m_outSegments)
+        {
+            size_t sent = std::min(length, segment.end - segment.begin);
+            length -= sent;
+            segment.begin += sent;
+            if (segment.begin == segment.end)
+                continue;
+
+            if (!segment.payload)
+            {
+                size_t size = segment.end - segment.begin;
+                if (segment.begin != writePosition)
+                    memmove(&m_outBuffer->m_buffer[writePosition], &m_outBuffer->m_buffer[segment.begin], size);
+                segment.begin = writePosition;
+                segment.end = writePosition + size;
+                writePosition += size;
+            }
+
+            remaining.push_back(std::move(segment));
+        }
+
+        m_outBuffer->m_writePosition = writePosition;
+
+        // append what was queued in the meantime
+        for (OutSegment& segment : m_secondaryOutSegments)
+        {
+            if (!segment.payload)
+            {
+                size_t size = segment.end - segment.begin;
+
+                // do we have enough space? if not, resize
+                if (m_outBuffer->m_buffer.size() < m_outBuffer->m_writePosition + size)
+                    m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + size);
+
+                memcpy(&m_outBuffer->m_buffer[m_outBuffer->m_writePosition], &m_secondaryOutBuffer->m_buffer[segment.begin], size);
+                segment.begin = m_outBuffer->m_writePosition;
+                segment.end = segment.begin + size;
+                m_outBuffer->m_writePosition += size;
+            }
+
+            remaining.push_back(std::move(segment));
+        }
+
+        m_secondaryOutBuffer->m_writePosition = 0;
+        m_secondaryOutSegments.clear();
+        m_outSegments.swap(remaining);
+    }
+
+    void Socket::ResetWriteStats(uint64& copied, uint64& shared)
+    {
+        copied = s_bytesCopied.exchange(0, std::memory_order_relaxed);
+        shared = s_bytesShared.exchange(0, std::memory_order_relaxed);
+    }
+
 // note that this function assumes that the socket mutex is locked
     void Socket::StartWriteFlushTimer()
     {
@@ -235,7 +351,7 @@ namespace MaNGOS
         m_writeState = WriteState::Sending;
 
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
+        m_socket.async_write_some(GetOutBuffers(),
                                   make_custom_alloc_handler(m_allocator,
         [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
     }
@@ -267,38 +383,31 @@ namespace MaNGOS
         std::lock_guard<std::mutex> guard(m_mutex);
 
         assert(m_writeState == WriteState::Sending);
-        assert(length <= m_outBuffer->m_writePosition);
-
-        // if there is data left to write, move it to the start of the buffer
-        if (length < m_outBuffer->m_writePosition)
-        {
-            memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-            m_outBuffer->m_writePosition -= length;
-        }
-        // if not, reset the write pointer
-        else
-            m_outBuffer->m_writePosition = 0;
 
-        // if there is data in the secondary buffer, append it to the primary buffer
-        if (m_secondaryOutBuffer->m_writePosition > 0)
-        {
-            // do we have enough space? if not, resize
-            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
-
-            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
-
-            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-            m_secondaryOutBuffer->m_writePosition = 0;
-        }
+        ConsumeOut(length);
 
         std::shared_ptr<Socket> ptr = shared<Socket>();
         // if there is any data to write, do so immediately
-        if (m_outBuffer->m_writePosition > 0)
-            m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
+        if (!m_outSegments.empty())
+            m_socket.async_write_some(GetOutBuffers(),
                                       make_custom_alloc_handler(m_allocator,
             [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length);}));
         else
             m_writeState = WriteState::Idle;
     }
+
+    std::vector<boost::asio::const_buffer> Socket::GetOutBuffers() const
+    {
+        std::vector<boost::asio::const_buffer> buffers;
+        buffers.reserve(m_outSegments.size());
+        for (OutSegment const& segment : m_outSegments)
+        {
+            if (segment.payload)
+                buffers.push_back(boost::asio::buffer(segment.payload->contents() + segment.begin, segment.end - segment.begin));
+            else
+                buffers.push_back(boost::asio::buffer(&m_outBuffer->m_buffer[segment.begin], segment.end - segment.begin));
+        }
+
+        return buffers;
+    }
 }
@@ -25,10 +25,14 @@
 
 #include <boost/asio.hpp>
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <mutex>
 #include <functional>
+#include <vector>
+
+class ByteBuffer;
 
 namespace MaNGOS
 {
@@ -59,9 +63,23 @@ namespace MaNGOS
 
             std::function<void(Socket *)> m_closeHandler;
 
+            // queued output in send order: a range of the out buffer, or of a payload shared with other sockets
+            struct OutSegment
+            {
+                std::shared_ptr<ByteBuffer const> payload;  // nullptr for out buffer bytes
+                size_t begin;
+                size_t end;
+            };
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
             std::unique_ptr<PacketBuffer> m_outBuffer;
             std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
+            std::vector<OutSegment> m_outSegments;
+            std::vector<OutSegment> m_secondaryOutSegments;
+
+            // all sockets, bytes copied into out buffers and bytes only referenced
+            static std::atomic<uint64> s_bytesCopied;
+            static std::atomic<uint64> s_bytesShared;
 
             std::mutex m_mutex;
             std::mutex m_closeMutex;
@@ -76,6 +94,11 @@ namespace MaNGOS
 
             void OnError(const boost::system::error_code &error);
 
+            // assume that the socket mutex is locked
+            void AppendOut(const char *buffer, int length);
+            void ConsumeOut(size_t length);
+            std::vector<boost::asio::const_buffer> GetOutBuffers() const;
+
         protected:
             const std::string m_address;
             const std::string m_remoteEndpoint;
@@ -88,6 +111,10 @@ namespace MaNGOS
 
             void ForceFlushOut();
 
+            // resume processing of input left buffered while the derived class was waiting for asynchronous work.
+            // must be called from the thread running this socket's io_service
+            void ProcessBufferedData();
+
         public:
             Socket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler);
             virtual ~Socket() = default;
@@ -103,6 +130,11 @@ namespace MaNGOS
 
             void Write(const char *buffer, int length);
             void Write(const char *header, int headerSize, const char* content, int contentSize);
+            // the content is referenced until sent instead of copied, it must not be modified anymore
+            void Write(const char *header, int headerSize, std::shared_ptr<ByteBuffer const> const& content);
+
+            // bytes copied into and referenced by out buffers of all sockets since the previous call
+            static void ResetWriteStats(uint64& copied, uint64& shared);
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 
@@ -23,6 +23,8 @@
 #include "ByteBuffer.h"
 #include "Server/Opcodes.h"
 
+#include <memory>
+
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
 class WorldPacket : public ByteBuffer
@@ -52,4 +54,7 @@ class WorldPacket : public ByteBuffer
     protected:
         Opcodes m_opcode;
 };
+
+// serialized once and sent by any number of sockets, must not be modified anymore
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
 #endif
@@ -2,5 +2,5 @@
 #define __REVISION_SQL_H__
  #define REVISION_DB_REALMD "required_14004_01_realmd_banning"
  #define REVISION_DB_CHARACTERS "required_14024_01_characters_battleground_random"
- #define REVISION_DB_MANGOS "required_14023_01_mangos_dbscripts"
+ #define REVISION_DB_MANGOS "required_14026_01_mangos_command"
 #endif // __REVISION_SQL_H__